@@ -0,0 +1,157 @@
+/** @file Bundle.h
+ *  @brief Contains the declarations for writing and reading the single-file bundles of an export.
+ *
+ * A bundle stores the URDF, the meshes and the side files of an export in one file, so that it can be copied
+ * in one go and its entries can be accessed randomly through a memory mapping. The layout, little endian, is:
+ * - a header of 32 bytes: magic "C2UBNDL", version, alignment of the data, number of entries and size of the table of contents;
+ * - the table of contents, sorted by name: offset, stored size, size, CRC-32, flags and name of each entry, padded to 8 bytes;
+ * - the data of the entries, each one starting at a multiple of the alignment, compressed with zlib if the flag is set.
+ *
+ * The functions declared in this file do not depend on Creo, so that the bundles can be read on the robots.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_BUNDLE_BUNDLE_H
+#define CREO2URDF_BUNDLE_BUNDLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Version of the bundle layout written by writeBundle.
+ */
+constexpr std::uint32_t bundle_version = 1;
+
+/**
+ * @brief Entry of the table of contents of a bundle.
+ */
+struct BundleEntry {
+    std::string name{""}; ///< Path of the entry relative to the root of the export, with / as separator.
+    std::uint64_t offset{0}; ///< Offset of the data from the beginning of the bundle.
+    std::uint64_t storedSize{0}; ///< Size of the data in the bundle.
+    std::uint64_t size{0}; ///< Size of the content once uncompressed.
+    std::uint32_t crc{0}; ///< CRC-32 of the uncompressed content.
+    bool compressed{false}; ///< True if the data is compressed with zlib.
+};
+
+/**
+ * @brief Options of writeBundle.
+ */
+struct BundleOptions {
+    bool compress{true}; ///< If true the entries are compressed with zlib, unless compression does not make them smaller.
+    int compressionLevel{6}; ///< zlib compression level, between 1 (fastest) and 9 (smallest).
+    std::uint32_t alignment{64}; ///< Alignment in bytes of the data of each entry, a power of 2.
+};
+
+/**
+ * @brief Writes a bundle with the content of some files.
+ *
+ * @param bundle_path Path of the bundle to write.
+ * @param files Name of each entry and path of the file with its content. The names must be unique.
+ * @param options The options of the bundle.
+ * @param[out] error Reason of the failure, empty on success.
+ * @return True if successful, false otherwise.
+ */
+bool writeBundle(const std::string& bundle_path, const std::vector<std::pair<std::string, std::string>>& files,
+                 const BundleOptions& options, std::string& error);
+
+/**
+ * @brief Read-only access to a bundle through a memory mapping.
+ */
+class BundleReader {
+public:
+    BundleReader() = default;
+    ~BundleReader();
+    BundleReader(const BundleReader&) = delete;
+    BundleReader& operator=(const BundleReader&) = delete;
+
+    /**
+     * @brief Maps a bundle in memory and parses its table of contents.
+     *
+     * @param bundle_path Path of the bundle.
+     * @param[out] error Reason of the failure, empty on success.
+     * @return True if successful, false otherwise.
+     */
+    bool open(const std::string& bundle_path, std::string& error);
+
+    /**
+     * @brief Unmaps the bundle, invalidating the entries and the pointers returned by storedData.
+     */
+    void close();
+
+    /**
+     * @brief The entries of the bundle, sorted by name.
+     */
+    const std::vector<BundleEntry>& entries() const { return m_entries; }
+
+    /**
+     * @brief Finds an entry by name with a binary search.
+     *
+     * @param name The name of the entry.
+     * @return const BundleEntry* The entry, nullptr if there is no entry with this name.
+     */
+    const BundleEntry* find(const std::string& name) const;
+
+    /**
+     * @brief Gives the mapped data of an entry without copying it, that is its content if the entry is not compressed.
+     *
+     * @param entry An entry of this bundle.
+     * @return const char* Pointer to the first of the entry.storedSize bytes of the data.
+     */
+    const char* storedData(const BundleEntry& entry) const { return m_data + entry.offset; }
+
+    /**
+     * @brief Passes the content of an entry to a sink in chunks, decompressing it if needed, and checks its CRC-32.
+     *
+     * @param entry An entry of this bundle.
+     * @param sink Function receiving each chunk, returning false to stop the streaming.
+     * @param[out] error Reason of the failure, empty on success.
+     * @return True if the whole content was streamed and is intact, false otherwise.
+     */
+    bool stream(const BundleEntry& entry, const std::function<bool(const char*, std::size_t)>& sink, std::string& error) const;
+
+    /**
+     * @brief Reads the content of an entry in memory.
+     *
+     * @param entry An entry of this bundle.
+     * @param[out] content The content of the entry.
+     * @param[out] error Reason of the failure, empty on success.
+     * @return True if successful, false otherwise.
+     */
+    bool read(const BundleEntry& entry, std::vector<char>& content, std::string& error) const;
+
+    /**
+     * @brief Writes the content of an entry to a file.
+     *
+     * @param entry An entry of this bundle.
+     * @param path Path of the file to write. Its folder must exist.
+     * @param[out] error Reason of the failure, empty on success.
+     * @return True if successful, false otherwise.
+     */
+    bool extract(const BundleEntry& entry, const std::string& path, std::string& error) const;
+
+private:
+    bool parse(std::string& error);
+
+    const char* m_data{ nullptr };
+    std::size_t m_size{ 0 };
+    std::vector<BundleEntry> m_entries;
+#ifdef _WIN32
+    void* m_file{ nullptr };
+    void* m_mapping{ nullptr };
+#else
+    int m_file{ -1 };
+#endif
+};
+
+#endif // !CREO2URDF_BUNDLE_BUNDLE_H
@@ -0,0 +1,382 @@
+/**
+ * @file Bundle.cpp
+ * @brief Contains the definitions for writing and reading the single-file bundles of an export.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/bundle/Bundle.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char bundle_magic[8] = { 'C', '2', 'U', 'B', 'N', 'D', 'L', '\0' };
+constexpr std::size_t header_size = 32;
+constexpr std::size_t entry_fixed_size = 36;
+constexpr std::uint32_t flag_compressed = 1;
+
+/**
+ * @brief Size of the chunks passed to the sink while streaming an entry.
+ */
+constexpr std::size_t stream_chunk_size = 1 << 16;
+
+std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+void put(std::vector<char>& buffer, T value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T get(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+std::vector<char> buildTableOfContents(const std::vector<BundleEntry>& entries) {
+    std::vector<char> toc;
+    for (const auto& entry : entries) {
+        put<std::uint64_t>(toc, entry.offset);
+        put<std::uint64_t>(toc, entry.storedSize);
+        put<std::uint64_t>(toc, entry.size);
+        put<std::uint32_t>(toc, entry.crc);
+        put<std::uint32_t>(toc, entry.compressed ? flag_compressed : 0);
+        put<std::uint32_t>(toc, static_cast<std::uint32_t>(entry.name.size()));
+        toc.insert(toc.end(), entry.name.begin(), entry.name.end());
+        toc.resize(alignUp(toc.size(), 8), '\0');
+    }
+    return toc;
+}
+
+} // namespace
+
+bool writeBundle(const std::string& bundle_path, const std::vector<std::pair<std::string, std::string>>& files,
+                 const BundleOptions& options, std::string& error)
+{
+    error.clear();
+    if (options.alignment == 0 || (options.alignment & (options.alignment - 1)) != 0) {
+        error = "the alignment must be a power of 2";
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::string>> sorted_files = files;
+    std::sort(sorted_files.begin(), sorted_files.end());
+    std::vector<BundleEntry> entries(sorted_files.size());
+    for (std::size_t i = 0; i < sorted_files.size(); i++) {
+        if (i > 0 && sorted_files[i].first == sorted_files[i - 1].first) {
+            error = "the entry " + sorted_files[i].first + " is duplicated";
+            return false;
+        }
+        entries[i].name = sorted_files[i].first;
+    }
+
+    // The size of the table of contents depends only on the names, so it is written once the offsets are known
+    std::uint64_t toc_size = buildTableOfContents(entries).size();
+    std::ofstream output(bundle_path, std::ios::out | std::ios::binary);
+    if (!output.is_open()) {
+        error = "unable to open " + bundle_path;
+        return false;
+    }
+    std::uint64_t position = header_size + toc_size;
+    output.write(std::vector<char>(position, '\0').data(), position);
+
+    for (std::size_t i = 0; i < sorted_files.size(); i++) {
+        auto& entry = entries[i];
+        std::ifstream input(sorted_files[i].second, std::ios::in | std::ios::binary);
+        if (!input.is_open()) {
+            error = "unable to read " + sorted_files[i].second;
+            return false;
+        }
+        std::vector<char> content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        entry.size = content.size();
+        entry.crc = static_cast<std::uint32_t>(crc32(0L, reinterpret_cast<const Bytef*>(content.data()), static_cast<uInt>(content.size())));
+
+        std::vector<char> compressed;
+        if (options.compress && !content.empty()) {
+            uLongf compressed_size = compressBound(static_cast<uLong>(content.size()));
+            compressed.resize(compressed_size);
+            if (compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressed_size, reinterpret_cast<const Bytef*>(content.data()),
+                          static_cast<uLong>(content.size()), options.compressionLevel) == Z_OK && compressed_size < content.size()) {
+                compressed.resize(compressed_size);
+                entry.compressed = true;
+            }
+        }
+        const auto& data = entry.compressed ? compressed : content;
+        entry.storedSize = data.size();
+
+        std::uint64_t padding = alignUp(position, options.alignment) - position;
+        output.write(std::vector<char>(padding, '\0').data(), padding);
+        entry.offset = position + padding;
+        output.write(data.data(), data.size());
+        position = entry.offset + entry.storedSize;
+    }
+
+    std::vector<char> header(bundle_magic, bundle_magic + sizeof(bundle_magic));
+    put<std::uint32_t>(header, bundle_version);
+    put<std::uint32_t>(header, options.alignment);
+    put<std::uint64_t>(header, entries.size());
+    put<std::uint64_t>(header, toc_size);
+    auto toc = buildTableOfContents(entries);
+    output.seekp(0);
+    output.write(header.data(), header.size());
+    output.write(toc.data(), toc.size());
+    if (!output) {
+        error = "unable to write " + bundle_path;
+        return false;
+    }
+    return true;
+}
+
+BundleReader::~BundleReader()
+{
+    close();
+}
+
+bool BundleReader::open(const std::string& bundle_path, std::string& error)
+{
+    close();
+    error.clear();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(bundle_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "unable to open " + bundle_path;
+        return false;
+    }
+    m_file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        error = "unable to get the size of " + bundle_path;
+        close();
+        return false;
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr) {
+        error = "unable to map " + bundle_path;
+        close();
+        return false;
+    }
+    m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    m_file = ::open(bundle_path.c_str(), O_RDONLY);
+    if (m_file < 0) {
+        error = "unable to open " + bundle_path;
+        return false;
+    }
+    struct stat status;
+    if (fstat(m_file, &status) != 0 || status.st_size == 0) {
+        error = "unable to get the size of " + bundle_path;
+        close();
+        return false;
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+    m_data = data == MAP_FAILED ? nullptr : static_cast<const char*>(data);
+#endif
+    if (m_data == nullptr) {
+        error = "unable to map " + bundle_path;
+        close();
+        return false;
+    }
+    if (!parse(error)) {
+        error = bundle_path + " is not a valid bundle: " + error;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void BundleReader::close()
+{
+#ifdef _WIN32
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != nullptr) {
+        CloseHandle(m_file);
+    }
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data != nullptr) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+    if (m_file >= 0) {
+        ::close(m_file);
+    }
+    m_file = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_entries.clear();
+}
+
+bool BundleReader::parse(std::string& error)
+{
+    if (m_size < header_size || std::memcmp(m_data, bundle_magic, sizeof(bundle_magic)) != 0) {
+        error = "wrong magic";
+        return false;
+    }
+    if (get<std::uint32_t>(m_data + 8) != bundle_version) {
+        error = "unsupported version " + std::to_string(get<std::uint32_t>(m_data + 8));
+        return false;
+    }
+    auto n_entries = get<std::uint64_t>(m_data + 16);
+    auto toc_size = get<std::uint64_t>(m_data + 24);
+    if (toc_size > m_size - header_size || n_entries > toc_size / entry_fixed_size) {
+        error = "truncated table of contents";
+        return false;
+    }
+
+    const char* toc_end = m_data + header_size + toc_size;
+    const char* record = m_data + header_size;
+    m_entries.resize(static_cast<std::size_t>(n_entries));
+    for (auto& entry : m_entries) {
+        if (static_cast<std::size_t>(toc_end - record) < entry_fixed_size) {
+            error = "truncated table of contents";
+            return false;
+        }
+        entry.offset = get<std::uint64_t>(record);
+        entry.storedSize = get<std::uint64_t>(record + 8);
+        entry.size = get<std::uint64_t>(record + 16);
+        entry.crc = get<std::uint32_t>(record + 24);
+        entry.compressed = (get<std::uint32_t>(record + 28) & flag_compressed) != 0;
+        auto name_size = get<std::uint32_t>(record + 32);
+        if (name_size > static_cast<std::size_t>(toc_end - record) - entry_fixed_size) {
+            error = "truncated table of contents";
+            return false;
+        }
+        entry.name.assign(record + entry_fixed_size, name_size);
+        record += alignUp(entry_fixed_size + name_size, 8);
+
+        if (entry.offset > m_size || entry.storedSize > m_size - entry.offset || (!entry.compressed && entry.storedSize != entry.size)) {
+            error = "the data of " + entry.name + " is out of the bundle";
+            return false;
+        }
+    }
+    if (!std::is_sorted(m_entries.begin(), m_entries.end(), [](const BundleEntry& a, const BundleEntry& b) { return a.name < b.name; })) {
+        error = "the entries are not sorted";
+        return false;
+    }
+    return true;
+}
+
+const BundleEntry* BundleReader::find(const std::string& name) const
+{
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), name, [](const BundleEntry& entry, const std::string& n) { return entry.name < n; });
+    return it != m_entries.end() && it->name == name ? &*it : nullptr;
+}
+
+bool BundleReader::stream(const BundleEntry& entry, const std::function<bool(const char*, std::size_t)>& sink, std::string& error) const
+{
+    error.clear();
+    const char* data = storedData(entry);
+    uLong crc = crc32(0L, Z_NULL, 0);
+    std::uint64_t streamed = 0;
+
+    if (!entry.compressed) {
+        for (std::uint64_t first = 0; first < entry.size; first += stream_chunk_size) {
+            auto n = static_cast<std::size_t>(std::min<std::uint64_t>(stream_chunk_size, entry.size - first));
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(data + first), static_cast<uInt>(n));
+            if (!sink(data + first, n)) {
+                error = "streaming of " + entry.name + " interrupted";
+                return false;
+            }
+        }
+        streamed = entry.size;
+    }
+    else {
+        z_stream inflater;
+        std::memset(&inflater, 0, sizeof(inflater));
+        if (inflateInit(&inflater) != Z_OK) {
+            error = "unable to initialize zlib";
+            return false;
+        }
+        std::vector<char> chunk(stream_chunk_size);
+        std::uint64_t consumed = 0;
+        int ret = Z_OK;
+        while (ret != Z_STREAM_END) {
+            if (inflater.avail_in == 0 && consumed < entry.storedSize) {
+                // avail_in is 32 bit, so huge entries are fed in pieces
+                auto n = static_cast<uInt>(std::min<std::uint64_t>(1u << 30, entry.storedSize - consumed));
+                inflater.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + consumed));
+                inflater.avail_in = n;
+                consumed += n;
+            }
+            inflater.next_out = reinterpret_cast<Bytef*>(chunk.data());
+            inflater.avail_out = static_cast<uInt>(chunk.size());
+            ret = inflate(&inflater, Z_NO_FLUSH);
+            if (ret != Z_OK && ret != Z_STREAM_END) {
+                inflateEnd(&inflater);
+                error = "the data of " + entry.name + " is corrupted";
+                return false;
+            }
+            std::size_t n = chunk.size() - inflater.avail_out;
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(chunk.data()), static_cast<uInt>(n));
+            streamed += n;
+            if (n > 0 && !sink(chunk.data(), n)) {
+                inflateEnd(&inflater);
+                error = "streaming of " + entry.name + " interrupted";
+                return false;
+            }
+        }
+        inflateEnd(&inflater);
+    }
+
+    if (streamed != entry.size || static_cast<std::uint32_t>(crc) != entry.crc) {
+        error = "the content of " + entry.name + " does not match its CRC-32";
+        return false;
+    }
+    return true;
+}
+
+bool BundleReader::read(const BundleEntry& entry, std::vector<char>& content, std::string& error) const
+{
+    content.clear();
+    content.reserve(static_cast<std::size_t>(entry.size));
+    return stream(entry, [&content](const char* chunk, std::size_t n) {
+        content.insert(content.end(), chunk, chunk + n);
+        return true;
+    }, error);
+}
+
+bool BundleReader::extract(const BundleEntry& entry, const std::string& path, std::string& error) const
+{
+    std::ofstream output(path, std::ios::out | std::ios::binary);
+    if (!output.is_open()) {
+        error = "unable to open " + path;
+        return false;
+    }
+    return stream(entry, [&output](const char* chunk, std::size_t n) {
+        output.write(chunk, n);
+        return static_cast<bool>(output);
+    }, error);
+}
@@ -0,0 +1,298 @@
+/**
+ * @file BundleTests.cpp
+ * @brief Contains the round trip checks of the bundle writer and reader.
+ *
+ * Usage: creo2urdf-bundle-tests <test>
+ *
+ * Each test is registered in CTest with its name, writes its files in the working directory,
+ * and the executable returns a nonzero code if any check fails.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/bundle/Bundle.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+
+namespace {
+
+/**
+ * @brief Number of checks that failed in the current test.
+ */
+int failures = 0;
+
+/**
+ * @brief Name of the current test, prepended to the names of its files so that the tests can run in parallel.
+ */
+std::string test_name;
+
+std::string testPath(const std::string& name)
+{
+    return test_name + "_" + name;
+}
+
+#define CHECK(condition)                                                                      \
+    do {                                                                                      \
+        if (!(condition)) {                                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            failures++;                                                                       \
+        }                                                                                     \
+    } while (false)
+
+/**
+ * @brief A file to put in the bundle.
+ */
+struct TestFile {
+    std::string name; ///< Name of the entry.
+    std::string path; ///< Path of the file.
+    std::vector<char> content; ///< Content of the file.
+};
+
+bool writeFile(const std::string& path, const std::vector<char>& content)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    file.write(content.data(), content.size());
+    return static_cast<bool>(file);
+}
+
+std::vector<char> readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Writes the files of an export: a compressible text, an incompressible binary, an empty file and a mesh in a subfolder.
+ */
+std::vector<TestFile> writeTestFiles()
+{
+    std::vector<TestFile> files;
+    std::string urdf = "<?xml version=\"1.0\"?>\n<robot name=\"test\">\n";
+    for (int i = 0; i < 200; i++) {
+        urdf += "  <link name=\"link_" + std::to_string(i) + "\"><inertial><mass value=\"1.0\"/></inertial></link>\n";
+    }
+    urdf += "</robot>\n";
+    files.push_back({ "model.urdf", testPath("bundle_model.urdf"), std::vector<char>(urdf.begin(), urdf.end()) });
+
+    std::mt19937 rng(5);
+    std::vector<char> noise(100000);
+    for (auto& byte : noise) {
+        byte = static_cast<char>(rng() & 0xff);
+    }
+    files.push_back({ "meshes/visual/link_0.stl", testPath("bundle_link_0.stl"), noise });
+    files.push_back({ "empty.yaml", testPath("bundle_empty.yaml"), {} });
+    for (const auto& file : files) {
+        CHECK(writeFile(file.path, file.content));
+    }
+    return files;
+}
+
+std::vector<std::pair<std::string, std::string>> bundleFiles(const std::vector<TestFile>& files)
+{
+    std::vector<std::pair<std::string, std::string>> bundle_files;
+    for (const auto& file : files) {
+        bundle_files.emplace_back(file.name, file.path);
+    }
+    return bundle_files;
+}
+
+/**
+ * @brief Writes a bundle and checks that every way of reading it gives back the content of the files.
+ */
+void checkRoundTrip(const BundleOptions& options)
+{
+    const auto files = writeTestFiles();
+    const std::string bundle_path = testPath("bundle_round_trip.c2u");
+    std::string error;
+    CHECK(writeBundle(bundle_path, bundleFiles(files), options, error));
+    CHECK(error.empty());
+
+    BundleReader reader;
+    CHECK(reader.open(bundle_path, error));
+    CHECK(reader.entries().size() == files.size());
+    for (std::size_t i = 1; i < reader.entries().size(); i++) {
+        CHECK(reader.entries()[i - 1].name < reader.entries()[i].name);
+    }
+    CHECK(reader.find("missing.urdf") == nullptr);
+
+    for (const auto& file : files) {
+        const BundleEntry* entry = reader.find(file.name);
+        CHECK(entry != nullptr);
+        if (entry == nullptr) {
+            continue;
+        }
+        CHECK(entry->name == file.name);
+        CHECK(entry->size == file.content.size());
+        CHECK(entry->offset % options.alignment == 0);
+        if (!entry->compressed) {
+            CHECK(entry->storedSize == entry->size);
+            CHECK(std::vector<char>(reader.storedData(*entry), reader.storedData(*entry) + entry->storedSize) == file.content);
+        }
+
+        std::vector<char> content;
+        CHECK(reader.read(*entry, content, error));
+        CHECK(content == file.content);
+
+        std::vector<char> streamed;
+        CHECK(reader.stream(*entry, [&streamed](const char* data, std::size_t size) {
+            streamed.insert(streamed.end(), data, data + size);
+            return true;
+        }, error));
+        CHECK(streamed == file.content);
+
+        const std::string extracted_path = testPath("bundle_extracted");
+        CHECK(reader.extract(*entry, extracted_path, error));
+        CHECK(readFile(extracted_path) == file.content);
+        std::remove(extracted_path.c_str());
+    }
+
+    // The text is compressed only if asked, the noise never since it would not get smaller
+    const BundleEntry* text = reader.find("model.urdf");
+    const BundleEntry* noise = reader.find("meshes/visual/link_0.stl");
+    const BundleEntry* empty = reader.find("empty.yaml");
+    if (text != nullptr && noise != nullptr && empty != nullptr) {
+        CHECK(text->compressed == options.compress);
+        CHECK(!options.compress || text->storedSize < text->size / 4);
+        CHECK(!noise->compressed);
+        CHECK(!empty->compressed);
+    }
+    reader.close();
+    CHECK(reader.entries().empty());
+    std::remove(bundle_path.c_str());
+}
+
+void testUncompressed()
+{
+    BundleOptions options;
+    options.compress = false;
+    options.alignment = 4096;
+    checkRoundTrip(options);
+}
+
+void testCompressed()
+{
+    BundleOptions options;
+    options.compress = true;
+    options.compressionLevel = 9;
+    checkRoundTrip(options);
+}
+
+void testCorruption()
+{
+    const auto files = writeTestFiles();
+    for (bool compress : { false, true }) {
+        BundleOptions options;
+        options.compress = compress;
+        const std::string bundle_path = testPath("bundle_corrupted.c2u");
+        std::string error;
+        CHECK(writeBundle(bundle_path, bundleFiles(files), options, error));
+
+        // Flips a byte in the middle of the data of each non empty entry
+        std::vector<std::uint64_t> positions;
+        {
+            BundleReader reader;
+            CHECK(reader.open(bundle_path, error));
+            for (const auto& entry : reader.entries()) {
+                if (entry.storedSize > 0) {
+                    positions.push_back(entry.offset + entry.storedSize / 2);
+                }
+            }
+        }
+        CHECK(positions.size() == 2);
+        std::vector<char> bundle = readFile(bundle_path);
+        for (auto position : positions) {
+            bundle[position] = static_cast<char>(bundle[position] ^ 0x5a);
+        }
+        CHECK(writeFile(bundle_path, bundle));
+
+        BundleReader reader;
+        CHECK(reader.open(bundle_path, error));
+        for (const auto& entry : reader.entries()) {
+            std::vector<char> content;
+            bool intact = reader.read(entry, content, error);
+            CHECK(intact == (entry.storedSize == 0));
+            CHECK(intact == error.empty());
+            CHECK(!reader.extract(entry, testPath("bundle_extracted"), error) || entry.storedSize == 0);
+        }
+        reader.close();
+        std::remove(testPath("bundle_extracted").c_str());
+
+        // A truncated bundle is rejected when opened
+        bundle.resize(bundle.size() / 2);
+        CHECK(writeFile(bundle_path, bundle));
+        CHECK(!reader.open(bundle_path, error));
+        CHECK(!error.empty());
+        std::remove(bundle_path.c_str());
+    }
+}
+
+void testErrors()
+{
+    auto files = bundleFiles(writeTestFiles());
+    const std::string bundle_path = testPath("bundle_errors.c2u");
+    std::string error;
+
+    auto duplicated = files;
+    duplicated.push_back(files.front());
+    CHECK(!writeBundle(bundle_path, duplicated, BundleOptions(), error));
+    CHECK(!error.empty());
+
+    auto missing = files;
+    missing.emplace_back("missing.stl", testPath("bundle_missing.stl"));
+    CHECK(!writeBundle(bundle_path, missing, BundleOptions(), error));
+    CHECK(!error.empty());
+
+    BundleOptions options;
+    options.alignment = 48;
+    CHECK(!writeBundle(bundle_path, files, options, error));
+    CHECK(!error.empty());
+
+    BundleReader reader;
+    CHECK(!reader.open(testPath("bundle_missing.c2u"), error));
+    CHECK(!error.empty());
+    CHECK(!reader.open(testPath("bundle_model.urdf"), error));
+    CHECK(!error.empty());
+
+    CHECK(writeBundle(bundle_path, {}, BundleOptions(), error));
+    CHECK(reader.open(bundle_path, error));
+    CHECK(reader.entries().empty());
+    reader.close();
+    std::remove(bundle_path.c_str());
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::map<std::string, std::function<void()>> tests{
+        { "Uncompressed", testUncompressed },
+        { "Compressed", testCompressed },
+        { "Corruption", testCorruption },
+        { "Errors", testErrors },
+    };
+    if (argc != 2 || tests.count(argv[1]) == 0) {
+        std::cerr << "Usage: creo2urdf-bundle-tests <test>, with test one of:";
+        for (const auto& test : tests) {
+            std::cerr << " " << test.first;
+        }
+        std::cerr << std::endl;
+        return EXIT_FAILURE;
+    }
+    test_name = argv[1];
+    tests.at(test_name)();
+    if (failures > 0) {
+        std::cerr << failures << " checks failed in " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
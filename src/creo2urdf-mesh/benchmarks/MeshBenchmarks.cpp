@@ -0,0 +1,183 @@
+/**
+ * @file MeshBenchmarks.cpp
+ * @brief Contains the benchmarks of the mesh processing kernels on a generated corpus of meshes.
+ *
+ * Usage: creo2urdf-mesh-benchmarks [--corpus <folder>] [--output <file.json>] [--max-triangles <n>] [--threads <n,n,...>] [--min-time <seconds>]
+ *
+ * The corpus is generated in the corpus folder, binary and ASCII STL files of each shape and size, and the throughput of each
+ * kernel is measured with each number of threads, every thread processing its own copy of the input as the plugin does with the links.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "MeshCorpus.h"
+
+#include <creo2urdf/mesh/MassProperties.h>
+#include <creo2urdf/mesh/Parallel.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+/**
+ * @brief A file of the corpus.
+ */
+struct CorpusEntry {
+    std::string name; ///< Name of the mesh, shape and target number of triangles.
+    TriangleMesh mesh; ///< The mesh.
+    std::vector<Eigen::Vector3d> corners; ///< The corners of the triangles, as given by a tessellation.
+    std::string binary_path; ///< Path of the binary STL file.
+    std::string ascii_path; ///< Path of the ASCII STL file.
+    std::size_t binary_bytes{ 0 }; ///< Size of the binary STL file.
+    std::size_t ascii_bytes{ 0 }; ///< Size of the ASCII STL file.
+};
+
+/**
+ * @brief A kernel, run on an entry of the corpus and returning the number of bytes it processed.
+ */
+struct Kernel {
+    std::string name;
+    std::function<std::size_t(const CorpusEntry&)> run;
+};
+
+/**
+ * @brief Keeps a value alive, so that the compiler cannot remove the computation of a kernel.
+ */
+volatile std::uint64_t sink = 0;
+
+std::size_t fileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    return file.is_open() ? static_cast<std::size_t>(file.tellg()) : 0;
+}
+
+std::vector<unsigned> parseList(const std::string& list) {
+    std::vector<unsigned> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(static_cast<unsigned>(std::stoul(item)));
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string corpus_folder = ".";
+    std::string output_file = "meshBenchmarks.json";
+    std::size_t max_triangles = 5000000;
+    double min_time = 0.5;
+    std::vector<unsigned> thread_counts{ 1, 2, 4, 8 };
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "--corpus") {
+            corpus_folder = value;
+        }
+        else if (option == "--output") {
+            output_file = value;
+        }
+        else if (option == "--max-triangles") {
+            max_triangles = std::stoul(value);
+        }
+        else if (option == "--threads") {
+            thread_counts = parseList(value);
+        }
+        else if (option == "--min-time") {
+            min_time = std::stod(value);
+        }
+        else {
+            std::cerr << "Unknown option " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<CorpusEntry> corpus;
+    for (auto shape : { CorpusShape::Sphere, CorpusShape::Torus, CorpusShape::Shell }) {
+        for (std::size_t n_triangles : { 1000, 10000, 100000, 1000000, 5000000 }) {
+            if (n_triangles > max_triangles) {
+                continue;
+            }
+            CorpusEntry entry;
+            entry.name = corpusShapeName(shape) + "_" + std::to_string(n_triangles);
+            entry.mesh = generateCorpusMesh(shape, n_triangles);
+            for (const auto& t : entry.mesh.triangles) {
+                entry.corners.insert(entry.corners.end(), { entry.mesh.vertices[t[0]], entry.mesh.vertices[t[1]], entry.mesh.vertices[t[2]] });
+            }
+            entry.binary_path = corpus_folder + "/" + entry.name + "_binary.stl";
+            entry.ascii_path = corpus_folder + "/" + entry.name + "_ascii.stl";
+            if (!writeBinarySTL(entry.binary_path, entry.mesh) || !writeASCIISTL(entry.ascii_path, entry.mesh)) {
+                std::cerr << "Unable to write the corpus in " << corpus_folder << std::endl;
+                return EXIT_FAILURE;
+            }
+            entry.binary_bytes = fileSize(entry.binary_path);
+            entry.ascii_bytes = fileSize(entry.ascii_path);
+            std::cout << "Generated " << entry.name << " with " << entry.mesh.triangles.size() << " triangles" << std::endl;
+            corpus.push_back(std::move(entry));
+        }
+    }
+
+    const std::size_t vertex_bytes = 3 * sizeof(double);
+    std::vector<Kernel> kernels{
+        { "parse_binary", [](const CorpusEntry& e) { TriangleMesh m; readSTL(e.binary_path, m); sink = sink + m.triangles.size(); return e.binary_bytes; } },
+        { "parse_ascii", [](const CorpusEntry& e) { TriangleMesh m; readSTL(e.ascii_path, m); sink = sink + m.triangles.size(); return e.ascii_bytes; } },
+        { "weld", [&](const CorpusEntry& e) { auto m = weldTriangles(e.corners); sink = sink + m.vertices.size(); return e.corners.size() * vertex_bytes; } },
+        { "normals", [&](const CorpusEntry& e) { auto n = computeTriangleNormals(e.mesh); sink = sink + n.size(); return e.mesh.triangles.size() * 3 * vertex_bytes; } },
+        { "inertia", [&](const CorpusEntry& e) { MassProperties p; computeMassProperties(e.mesh, 1.0, p); sink = sink + static_cast<std::uint64_t>(p.volume > 0.0); return e.mesh.triangles.size() * 3 * vertex_bytes; } },
+        { "hash", [&](const CorpusEntry& e) { sink = sink + hashMesh(e.mesh); return e.mesh.vertices.size() * vertex_bytes + e.mesh.triangles.size() * 3 * sizeof(std::uint32_t); } },
+    };
+
+    std::ofstream json(output_file);
+    json << "{\n  \"corpus\": [\n";
+    for (std::size_t i = 0; i < corpus.size(); i++) {
+        const auto& e = corpus[i];
+        json << "    {\"name\": \"" << e.name << "\", \"triangles\": " << e.mesh.triangles.size() << ", \"vertices\": " << e.mesh.vertices.size()
+             << ", \"binary_bytes\": " << e.binary_bytes << ", \"ascii_bytes\": " << e.ascii_bytes << "}" << (i + 1 < corpus.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n  \"results\": [\n";
+
+    bool first_result = true;
+    for (const auto& kernel : kernels) {
+        for (const auto& entry : corpus) {
+            for (auto n_threads : thread_counts) {
+                // Each thread processes its own copy of the input, the kernel is repeated until min_time is reached
+                std::size_t repetitions = 0;
+                std::size_t bytes = 0;
+                auto start = std::chrono::steady_clock::now();
+                double seconds = 0.0;
+                do {
+                    std::vector<std::size_t> processed(n_threads, 0);
+                    parallelFor(n_threads, [&](std::size_t t) { processed[t] = kernel.run(entry); }, n_threads);
+                    for (auto p : processed) {
+                        bytes += p;
+                    }
+                    repetitions++;
+                    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                } while (seconds < min_time);
+
+                double triangles_per_second = static_cast<double>(repetitions * n_threads * entry.mesh.triangles.size()) / seconds;
+                double bytes_per_second = static_cast<double>(bytes) / seconds;
+                std::cout << kernel.name << " " << entry.name << " threads " << n_threads << ": " << triangles_per_second / 1e6 << " Mtriangles/s" << std::endl;
+                json << (first_result ? "" : ",\n") << "    {\"kernel\": \"" << kernel.name << "\", \"mesh\": \"" << entry.name << "\", \"threads\": " << n_threads
+                     << ", \"repetitions\": " << repetitions << ", \"seconds\": " << seconds << ", \"triangles_per_second\": " << triangles_per_second
+                     << ", \"bytes_per_second\": " << bytes_per_second << "}";
+                first_result = false;
+            }
+        }
+    }
+    json << "\n  ]\n}\n";
+    if (!json) {
+        std::cerr << "Unable to write " << output_file << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file MeshCorpus.cpp
+ * @brief Contains the definitions for generating the synthetic meshes used by the benchmarks.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "MeshCorpus.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+/**
+ * @brief Adds the two counter-clockwise triangles of the quad abcd.
+ */
+void addQuad(TriangleMesh& mesh, std::uint32_t a, std::uint32_t b, std::uint32_t c, std::uint32_t d) {
+    mesh.triangles.push_back({ a, b, c });
+    mesh.triangles.push_back({ a, c, d });
+}
+
+TriangleMesh generateSphere(std::size_t n_triangles) {
+    // stacks * slices quads with slices = 2 * stacks, the poles being fans
+    auto stacks = static_cast<std::uint32_t>(std::max(2.0, std::round(std::sqrt(n_triangles / 4.0))));
+    std::uint32_t slices = 2 * stacks;
+    TriangleMesh mesh;
+    mesh.vertices.emplace_back(0.0, 0.0, 1.0);
+    for (std::uint32_t i = 1; i < stacks; i++) {
+        double theta = pi * i / stacks;
+        for (std::uint32_t j = 0; j < slices; j++) {
+            double phi = 2.0 * pi * j / slices;
+            mesh.vertices.emplace_back(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+        }
+    }
+    mesh.vertices.emplace_back(0.0, 0.0, -1.0);
+    auto south = static_cast<std::uint32_t>(mesh.vertices.size() - 1);
+    auto ring = [slices](std::uint32_t i, std::uint32_t j) { return 1 + (i - 1) * slices + j % slices; };
+
+    for (std::uint32_t j = 0; j < slices; j++) {
+        mesh.triangles.push_back({ 0, ring(1, j), ring(1, j + 1) });
+        mesh.triangles.push_back({ south, ring(stacks - 1, j + 1), ring(stacks - 1, j) });
+    }
+    for (std::uint32_t i = 1; i + 1 < stacks; i++) {
+        for (std::uint32_t j = 0; j < slices; j++) {
+            addQuad(mesh, ring(i, j), ring(i + 1, j), ring(i + 1, j + 1), ring(i, j + 1));
+        }
+    }
+    return mesh;
+}
+
+TriangleMesh generateTorus(std::size_t n_triangles) {
+    auto minor = static_cast<std::uint32_t>(std::max(3.0, std::round(std::sqrt(n_triangles / 4.0))));
+    std::uint32_t major = 2 * minor;
+    const double major_radius = 1.0;
+    const double minor_radius = 0.3;
+    TriangleMesh mesh;
+    for (std::uint32_t i = 0; i < major; i++) {
+        double u = 2.0 * pi * i / major;
+        for (std::uint32_t j = 0; j < minor; j++) {
+            double v = 2.0 * pi * j / minor;
+            double r = major_radius + minor_radius * std::cos(v);
+            mesh.vertices.emplace_back(r * std::cos(u), r * std::sin(u), minor_radius * std::sin(v));
+        }
+    }
+    auto index = [major, minor](std::uint32_t i, std::uint32_t j) { return (i % major) * minor + j % minor; };
+    for (std::uint32_t i = 0; i < major; i++) {
+        for (std::uint32_t j = 0; j < minor; j++) {
+            addQuad(mesh, index(i, j), index(i + 1, j), index(i + 1, j + 1), index(i, j + 1));
+        }
+    }
+    return mesh;
+}
+
+/**
+ * @brief Adds the 6 faces of an axis aligned box, each one split in a grid, as corners of independent triangles.
+ */
+void addBoxCorners(std::vector<Eigen::Vector3d>& corners, std::uint32_t grid, double half_size, bool inward) {
+    for (int axis = 0; axis < 3; axis++) {
+        for (double side : { -1.0, 1.0 }) {
+            // The tangent axes are ordered so that a x b points outside
+            int a = (axis + (side > 0.0 ? 1 : 2)) % 3;
+            int b = (axis + (side > 0.0 ? 2 : 1)) % 3;
+            auto point = [&](std::uint32_t i, std::uint32_t j) {
+                Eigen::Vector3d p;
+                p[axis] = side * half_size;
+                // The same expression on every face, so that the vertices of the shared edges are identical
+                p[a] = half_size * (-1.0 + 2.0 * i / grid);
+                p[b] = half_size * (-1.0 + 2.0 * j / grid);
+                return p;
+            };
+            for (std::uint32_t i = 0; i < grid; i++) {
+                for (std::uint32_t j = 0; j < grid; j++) {
+                    std::array<Eigen::Vector3d, 4> q{ point(i, j), point(i + 1, j), point(i + 1, j + 1), point(i, j + 1) };
+                    if (inward) {
+                        std::swap(q[1], q[3]);
+                    }
+                    corners.insert(corners.end(), { q[0], q[1], q[2], q[0], q[2], q[3] });
+                }
+            }
+        }
+    }
+}
+
+TriangleMesh generateShell(std::size_t n_triangles, unsigned seed) {
+    // Two boxes of 6 faces of grid * grid quads
+    auto grid = static_cast<std::uint32_t>(std::max(1.0, std::round(std::sqrt(n_triangles / 24.0))));
+    std::vector<Eigen::Vector3d> corners;
+    addBoxCorners(corners, grid, 1.0, false);
+    addBoxCorners(corners, grid, 0.95, true);
+    TriangleMesh mesh = weldTriangles(corners);
+
+    // Tessellation noise smaller than the wall, moving the shared vertices so that the shell stays closed
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> noise(-0.1 / grid, 0.1 / grid);
+    double max_noise = 0.01;
+    for (auto& v : mesh.vertices) {
+        v += Eigen::Vector3d(noise(generator), noise(generator), noise(generator)).cwiseMax(-max_noise).cwiseMin(max_noise);
+    }
+    return mesh;
+}
+
+} // namespace
+
+TriangleMesh generateCorpusMesh(CorpusShape shape, std::size_t n_triangles, unsigned seed)
+{
+    switch (shape) {
+    case CorpusShape::Sphere:
+        return generateSphere(n_triangles);
+    case CorpusShape::Torus:
+        return generateTorus(n_triangles);
+    case CorpusShape::Shell:
+        return generateShell(n_triangles, seed);
+    }
+    return TriangleMesh();
+}
+
+std::string corpusShapeName(CorpusShape shape)
+{
+    switch (shape) {
+    case CorpusShape::Sphere:
+        return "sphere";
+    case CorpusShape::Torus:
+        return "torus";
+    case CorpusShape::Shell:
+        return "shell";
+    }
+    return "";
+}
+
+bool writeASCIISTL(const std::string& filename, const TriangleMesh& mesh)
+{
+    std::ofstream output(filename);
+    if (!output.is_open()) {
+        return false;
+    }
+    auto normals = computeTriangleNormals(mesh);
+    char line[128];
+    output << "solid corpus\n";
+    for (std::size_t i = 0; i < mesh.triangles.size(); i++) {
+        std::snprintf(line, sizeof(line), "facet normal %e %e %e\n", normals[i].x(), normals[i].y(), normals[i].z());
+        output << line << "outer loop\n";
+        for (auto v : mesh.triangles[i]) {
+            const auto& p = mesh.vertices[v];
+            std::snprintf(line, sizeof(line), "vertex %.9g %.9g %.9g\n", static_cast<float>(p.x()), static_cast<float>(p.y()), static_cast<float>(p.z()));
+            output << line;
+        }
+        output << "endloop\nendfacet\n";
+    }
+    output << "endsolid corpus\n";
+    return static_cast<bool>(output);
+}
@@ -0,0 +1,50 @@
+/** @file MeshCorpus.h
+ *  @brief Contains the declarations for generating the synthetic meshes used by the benchmarks.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_BENCHMARKS_MESHCORPUS_H
+#define CREO2URDF_MESH_BENCHMARKS_MESHCORPUS_H
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+/**
+ * @brief Shapes of the corpus.
+ */
+enum class CorpusShape {
+    Sphere, ///< UV sphere, smooth and closed.
+    Torus, ///< Torus, smooth, closed and not convex.
+    Shell ///< Hollow box with a thin wall and noisy vertices, similar to a CAD part.
+};
+
+/**
+ * @brief Generates a closed mesh of a shape with approximately a given number of triangles.
+ *
+ * @param shape The shape to generate.
+ * @param n_triangles The target number of triangles.
+ * @param seed Seed of the noise of the noisy shapes.
+ * @return TriangleMesh The mesh, with the vertices merged and the triangles counter-clockwise seen from outside.
+ */
+TriangleMesh generateCorpusMesh(CorpusShape shape, std::size_t n_triangles, unsigned seed = 0);
+
+/**
+ * @brief Name of a shape, used in the names of the corpus files.
+ */
+std::string corpusShapeName(CorpusShape shape);
+
+/**
+ * @brief Writes a mesh as ASCII STL.
+ *
+ * @param filename Path of the STL file.
+ * @param mesh The mesh to write.
+ * @return True if successful, false otherwise.
+ */
+bool writeASCIISTL(const std::string& filename, const TriangleMesh& mesh);
+
+#endif // !CREO2URDF_MESH_BENCHMARKS_MESHCORPUS_H
@@ -0,0 +1,76 @@
+/** @file CollisionDetection.h
+ *  @brief Contains the declarations of the bounding volume hierarchies and of the mesh-mesh collision queries.
+ *
+ *  @bug Coplanar triangles are not reported as intersecting, so two meshes that only touch along a face are not in collision.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_COLLISIONDETECTION_H
+#define CREO2URDF_MESH_COLLISIONDETECTION_H
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+#include <Eigen/StdVector>
+
+#include <utility>
+
+/**
+ * @brief Poses of a set of meshes, one per mesh.
+ */
+using MeshPoses = std::vector<Eigen::Isometry3d, Eigen::aligned_allocator<Eigen::Isometry3d>>;
+
+/**
+ * @brief Node of a bounding volume hierarchy.
+ */
+struct MeshBVHNode {
+    BoundingBox box; ///< Bounding box of the triangles of the node, in the frame of the mesh.
+    std::uint32_t first{ 0 }; ///< Index of the first child for inner nodes, of the first triangle for leaves. The second child follows the first one.
+    std::uint32_t count{ 0 }; ///< Number of triangles of a leaf, 0 for inner nodes.
+};
+
+/**
+ * @brief Axis aligned bounding box hierarchy over the triangles of a mesh. The root is the first node.
+ */
+struct MeshBVH {
+    std::vector<std::array<Eigen::Vector3d, 3>> triangles; ///< Vertices of the triangles, sorted so that each leaf references a contiguous range.
+    std::vector<MeshBVHNode> nodes; ///< Nodes of the hierarchy, empty if the mesh has no triangles.
+};
+
+/**
+ * @brief Builds the bounding volume hierarchy of a mesh, splitting the nodes at the median of their longest axis.
+ *
+ * @param mesh The mesh.
+ * @return MeshBVH The hierarchy, in the frame and units of the mesh.
+ */
+MeshBVH buildMeshBVH(const TriangleMesh& mesh);
+
+/**
+ * @brief Checks whether the triangles of two meshes intersect.
+ *
+ * @param a The hierarchy of the first mesh.
+ * @param world_H_a The pose of the first mesh.
+ * @param b The hierarchy of the second mesh.
+ * @param world_H_b The pose of the second mesh.
+ * @return True if at least one pair of triangles intersects, false otherwise.
+ */
+bool meshesIntersect(const MeshBVH& a, const Eigen::Isometry3d& world_H_a, const MeshBVH& b, const Eigen::Isometry3d& world_H_b);
+
+/**
+ * @brief Counts in how many samples each pair of meshes is in collision.
+ * The pairs whose world bounding boxes do not overlap are discarded before testing the triangles.
+ * The pairs are checked in parallel, and the result does not depend on the number of threads.
+ *
+ * @param meshes The hierarchies of the meshes.
+ * @param samples The poses of all the meshes in each sample.
+ * @param pairs The pairs of indices of the meshes to check.
+ * @param n_threads Number of threads, 0 means std::thread::hardware_concurrency().
+ * @return std::vector<std::size_t> The number of samples in collision of each pair.
+ */
+std::vector<std::size_t> countCollisions(const std::vector<MeshBVH>& meshes, const std::vector<MeshPoses>& samples,
+                                         const std::vector<std::pair<std::size_t, std::size_t>>& pairs, unsigned n_threads = 0);
+
+#endif // !CREO2URDF_MESH_COLLISIONDETECTION_H
@@ -0,0 +1,41 @@
+/** @file ConvexDecomposition.h
+ *  @brief Contains the declaration of the approximate convex decomposition of a mesh.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_CONVEXDECOMPOSITION_H
+#define CREO2URDF_MESH_CONVEXDECOMPOSITION_H
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+/**
+ * @brief Parameters of the approximate convex decomposition.
+ */
+struct ConvexDecompositionParameters {
+    std::size_t maxHulls{ 16 }; ///< Maximum number of convex hulls.
+    std::size_t maxVerticesPerHull{ 64 }; ///< Maximum number of vertices of each hull.
+    double maxConcavity{ 0.01 }; ///< Concavity below which a part is not split, relative to the diagonal of the mesh bounding box.
+};
+
+/**
+ * @brief Computes an approximate convex decomposition of a mesh.
+ *
+ * The surface of the mesh is sampled with its vertices and the centroids of its triangles.
+ * The part with the largest concavity, i.e. the largest depth of its samples inside its convex hull,
+ * is recursively split with the axis aligned plane that minimizes the concavity of the two halves,
+ * until all the parts are below maxConcavity or maxHulls is reached.
+ * The result is deterministic.
+ *
+ * @param mesh The mesh to decompose.
+ * @param parameters The parameters of the decomposition.
+ * @return std::vector<TriangleMesh> The convex hulls, in the same frame and units of the mesh.
+ */
+std::vector<TriangleMesh> computeConvexDecomposition(const TriangleMesh& mesh, const ConvexDecompositionParameters& parameters);
+
+#endif // !CREO2URDF_MESH_CONVEXDECOMPOSITION_H
@@ -0,0 +1,29 @@
+/** @file ConvexHull.h
+ *  @brief Contains the declaration of the 3D convex hull computation.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_CONVEXHULL_H
+#define CREO2URDF_MESH_CONVEXHULL_H
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+/**
+ * @brief Computes the convex hull of a set of points with the quickhull algorithm.
+ *
+ * The points farthest from the current hull are added first, so limiting the number of vertices
+ * gives the hull of the most significant points, contained in the exact hull.
+ *
+ * @param points The points of which to compute the hull.
+ * @param max_vertices Maximum number of vertices of the hull, 0 means no limit.
+ * @return TriangleMesh The closed hull with outward oriented triangles, empty if the points are degenerate (coplanar).
+ */
+TriangleMesh computeConvexHull(const std::vector<Eigen::Vector3d>& points, std::size_t max_vertices = 0);
+
+#endif // !CREO2URDF_MESH_CONVEXHULL_H
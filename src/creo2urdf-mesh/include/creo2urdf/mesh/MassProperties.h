@@ -0,0 +1,39 @@
+/** @file MassProperties.h
+ *  @brief Contains the declarations for computing the mass properties of a closed mesh.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_MASSPROPERTIES_H
+#define CREO2URDF_MESH_MASSPROPERTIES_H
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+/**
+ * @brief Mass properties of a solid of uniform density, expressed in the frame and units of its mesh.
+ */
+struct MassProperties {
+    double volume{ 0.0 }; ///< Volume enclosed by the mesh.
+    double mass{ 0.0 }; ///< Mass, i.e. the volume times the density.
+    Eigen::Vector3d centerOfMass{ Eigen::Vector3d::Zero() }; ///< Center of mass.
+    Eigen::Matrix3d inertia{ Eigen::Matrix3d::Zero() }; ///< Inertia tensor with respect to the center of mass, with the orientation of the mesh frame.
+};
+
+/**
+ * @brief Computes volume, center of mass and inertia tensor of a closed mesh with uniform density,
+ * integrating the polynomials over the triangles with the divergence theorem (Eberly, Polyhedral Mass Properties).
+ * The triangles are processed in blocks stored as arrays, so that the integrals are vectorized.
+ *
+ * @param mesh The closed mesh, with the triangles counter-clockwise when seen from outside.
+ * @param density The density of the solid.
+ * @param[out] properties The mass properties.
+ * @return True if successful, false if the mesh encloses no volume, e.g. because it is open or inside out.
+ */
+bool computeMassProperties(const TriangleMesh& mesh, double density, MassProperties& properties);
+
+#endif // !CREO2URDF_MESH_MASSPROPERTIES_H
@@ -0,0 +1,54 @@
+/** @file MeshSymmetry.h
+ *  @brief Contains the declarations for detecting meshes that are copies or reflections of each other.
+ *
+ *  @bug Meshes whose principal moments are degenerate, e.g. solids of revolution, have no unique principal frame,
+ *  so their congruences are not found.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_MESHSYMMETRY_H
+#define CREO2URDF_MESH_MESHSYMMETRY_H
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+/**
+ * @brief Principal frame of the vertices of a mesh, that moves together with the mesh.
+ */
+struct CanonicalFrame {
+    Eigen::Vector3d centroid{ Eigen::Vector3d::Zero() }; ///< Centroid of the vertices.
+    Eigen::Matrix3d axes{ Eigen::Matrix3d::Identity() }; ///< Principal axes as columns, sorted by increasing moment.
+    Eigen::Vector3d moments{ Eigen::Vector3d::Zero() }; ///< Variance of the vertices along each axis.
+    std::uint64_t shapeHash{ 0 }; ///< Hash of the counts and of the moments, equal for meshes congruent up to a rigid motion and a reflection.
+};
+
+/**
+ * @brief Computes the principal frame of the vertices of a mesh and its shape hash.
+ * The moments are rounded to 4 significant digits before hashing, so that the tessellation noise does not change the hash.
+ *
+ * @param mesh The mesh.
+ * @return CanonicalFrame The principal frame.
+ */
+CanonicalFrame computeCanonicalFrame(const TriangleMesh& mesh);
+
+/**
+ * @brief Finds the transform b = linear * a + translation that maps the vertices of a onto the ones of b,
+ * trying the sign combinations of the principal axes.
+ *
+ * @param a The first mesh.
+ * @param frame_a The principal frame of the first mesh.
+ * @param b The second mesh.
+ * @param frame_b The principal frame of the second mesh.
+ * @param mirrored If true only reflections are searched, otherwise only rigid motions.
+ * @param tolerance Maximum distance between a transformed vertex of a and the closest vertex of b.
+ * @param[out] linear Rotation, or rotation times reflection, of the transform.
+ * @param[out] translation Translation of the transform.
+ * @return True if every vertex of a is mapped onto a vertex of b, false otherwise.
+ */
+bool findCongruence(const TriangleMesh& a, const CanonicalFrame& frame_a, const TriangleMesh& b, const CanonicalFrame& frame_b,
+                    bool mirrored, double tolerance, Eigen::Matrix3d& linear, Eigen::Vector3d& translation);
+
+#endif // !CREO2URDF_MESH_MESHSYMMETRY_H
@@ -0,0 +1,81 @@
+/** @file Parallel.h
+ *  @brief Contains a minimal parallel loop used by the mesh processing stages.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_PARALLEL_H
+#define CREO2URDF_MESH_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs body(i) for each i in [0, n) on a pool of threads. Iterations are distributed dynamically,
+ * so the body must not depend on the execution order; results should be written in slots indexed by i
+ * to keep the output deterministic.
+ * The first exception thrown by the body is rethrown after all the threads have joined.
+ *
+ * @tparam Body Callable with signature void(std::size_t).
+ * @param n Number of iterations.
+ * @param body The body of the loop.
+ * @param n_threads Number of threads, 0 means std::thread::hardware_concurrency().
+ */
+template <class Body>
+void parallelFor(std::size_t n, Body body, unsigned n_threads = 0)
+{
+    if (n_threads == 0) {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    n_threads = static_cast<unsigned>(std::min<std::size_t>(n_threads, n));
+    if (n_threads <= 1) {
+        for (std::size_t i = 0; i < n; i++) {
+            body(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{ 0 };
+    std::exception_ptr first_exception;
+    std::mutex exception_mutex;
+
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < n; i = next++) {
+            try {
+                body(i);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (!first_exception) {
+                    first_exception = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads - 1);
+    for (unsigned t = 1; t < n_threads; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    if (first_exception) {
+        std::rethrow_exception(first_exception);
+    }
+}
+
+#endif // !CREO2URDF_MESH_PARALLEL_H
@@ -0,0 +1,72 @@
+/** @file PrimitiveFitting.h
+ *  @brief Contains the declarations for fitting geometric primitives to a mesh.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_PRIMITIVEFITTING_H
+#define CREO2URDF_MESH_PRIMITIVEFITTING_H
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+/**
+ * @brief Geometric primitives that can be fitted to a mesh.
+ */
+enum class PrimitiveShape {
+    Box,        ///< Oriented box.
+    Cylinder,   ///< Cylinder with the axis along z.
+    Sphere,     ///< Sphere.
+    Capsule     ///< Cylinder with two hemispherical caps, with the axis along z.
+};
+
+/**
+ * @brief Primitive enclosing a mesh, expressed in the frame and units of the mesh.
+ */
+struct FittedPrimitive {
+    PrimitiveShape shape{ PrimitiveShape::Box }; ///< Type of the primitive.
+    Eigen::Matrix3d rotation{ Eigen::Matrix3d::Identity() }; ///< Orientation of the primitive frame.
+    Eigen::Vector3d position{ Eigen::Vector3d::Zero() }; ///< Center of the primitive.
+    Eigen::Vector3d size{ Eigen::Vector3d::Zero() }; ///< Size of the box along the axes of its frame.
+    double radius{ 0.0 }; ///< Radius of the cylinder, sphere or capsule.
+    double length{ 0.0 }; ///< Length of the cylinder, or of the cylindrical part of the capsule.
+    double volume{ 0.0 }; ///< Volume of the primitive.
+    double volumeError{ 0.0 }; ///< Volume in excess with respect to the mesh, relative to the volume of the mesh.
+};
+
+/**
+ * @brief Fits the smallest enclosing primitive of each shape to a mesh.
+ *
+ * The box, cylinder and capsule are fitted in the principal frame of the convex hull
+ * and in the frame of the mesh, keeping the one with the lowest volume.
+ * The cylinder and the capsule use the minimum enclosing circle, the sphere the minimum enclosing sphere.
+ * If the mesh is not closed, the volume error is computed with respect to the volume of its convex hull.
+ *
+ * @param mesh The mesh to fit.
+ * @return std::vector<FittedPrimitive> One primitive per shape, in the order of PrimitiveShape. Empty if the mesh is degenerate.
+ */
+std::vector<FittedPrimitive> fitPrimitives(const TriangleMesh& mesh);
+
+/**
+ * @brief Fits to a mesh the enclosing primitive with the lowest volume error among the allowed shapes.
+ * @param mesh The mesh to fit.
+ * @param shapes The allowed shapes.
+ * @param best The fitted primitive.
+ * @return True if a primitive was fitted, false if the mesh is degenerate or no shape is allowed.
+ */
+bool fitBestPrimitive(const TriangleMesh& mesh, const std::vector<PrimitiveShape>& shapes, FittedPrimitive& best);
+
+/**
+ * @brief Computes the minimum sphere enclosing a set of points, with Welzl's algorithm.
+ * @param points The points to enclose.
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @return True if successful, false if there are no points.
+ */
+bool computeEnclosingSphere(const std::vector<Eigen::Vector3d>& points, Eigen::Vector3d& center, double& radius);
+
+#endif // !CREO2URDF_MESH_PRIMITIVEFITTING_H
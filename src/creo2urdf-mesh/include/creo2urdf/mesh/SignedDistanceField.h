@@ -0,0 +1,83 @@
+/** @file SignedDistanceField.h
+ *  @brief Contains the declarations for the narrow band signed distance field of a mesh.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_SIGNEDDISTANCEFIELD_H
+#define CREO2URDF_MESH_SIGNEDDISTANCEFIELD_H
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+/**
+ * @brief Parameters of the signed distance field, in the units of the mesh.
+ */
+struct SignedDistanceFieldParameters {
+    double resolution{ 0.005 }; ///< Distance between the samples of the grid.
+    double narrowBand{ 0.02 }; ///< Distance from the surface beyond which the values are clamped.
+    double padding{ 0.02 }; ///< Margin added around the bounding box of the mesh.
+    std::size_t maxSamples{ std::size_t(1) << 26 }; ///< Maximum number of samples of the grid, to bound the memory.
+};
+
+/**
+ * @brief Regular grid of signed distances, negative inside the mesh.
+ *
+ * The sample (i, j, k) is at origin + resolution * (i, j, k), and is stored at index i + size[0] * (j + size[1] * k).
+ */
+struct SignedDistanceField {
+    Eigen::Vector3d origin{ Eigen::Vector3d::Zero() }; ///< Position of the first sample.
+    double resolution{ 0.0 }; ///< Distance between the samples.
+    std::array<std::uint32_t, 3> size{ { 0, 0, 0 } }; ///< Number of samples along each axis.
+    float narrowBand{ 0.0f }; ///< Absolute value of the samples farther than the narrow band from the surface.
+    std::vector<float> values; ///< Signed distances, with x varying fastest.
+};
+
+/**
+ * @brief Computes the narrow band signed distance field of a closed mesh.
+ *
+ * The unsigned distance is computed exactly within the narrow band around each triangle,
+ * the sign by the parity of the crossings of a ray along x. The slices of the grid are processed in parallel,
+ * and the result does not depend on the number of threads.
+ *
+ * @param mesh The closed mesh.
+ * @param parameters The parameters of the field.
+ * @param field The computed field.
+ * @param n_threads Number of threads, 0 means one per hardware thread.
+ * @return True if successful, false if the mesh is empty or the grid has more than maxSamples samples.
+ */
+bool computeSignedDistanceField(const TriangleMesh& mesh, const SignedDistanceFieldParameters& parameters, SignedDistanceField& field, unsigned n_threads = 0);
+
+/**
+ * @brief Writes a signed distance field to a binary file that can be memory mapped.
+ *
+ * The file starts with a 64 bytes little endian header:
+ *  - char[8] magic "C2USDF" padded with zeros
+ *  - uint32 version, currently 1
+ *  - uint32[3] number of samples along x, y and z
+ *  - float64[3] position of the first sample
+ *  - float64 resolution
+ *  - float32 narrow band
+ *  - uint32 reserved
+ *
+ * followed by the float32 values, with x varying fastest.
+ *
+ * @param filename The path of the file.
+ * @param field The field to write.
+ * @return True if successful, false otherwise.
+ */
+bool writeSignedDistanceField(const std::string& filename, const SignedDistanceField& field);
+
+/**
+ * @brief Reads a signed distance field written by writeSignedDistanceField.
+ * @param filename The path of the file.
+ * @param field The field read.
+ * @return True if successful, false if the file is missing or malformed.
+ */
+bool readSignedDistanceField(const std::string& filename, SignedDistanceField& field);
+
+#endif // !CREO2URDF_MESH_SIGNEDDISTANCEFIELD_H
@@ -0,0 +1,65 @@
+/** @file SphereTree.h
+ *  @brief Contains the declarations for the hierarchical sphere approximation of a mesh.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_SPHERETREE_H
+#define CREO2URDF_MESH_SPHERETREE_H
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+/**
+ * @brief Parameters of the sphere tree.
+ */
+struct SphereTreeParameters {
+    std::size_t maxSpheres{ 32 }; ///< Maximum number of leaf spheres.
+    double maxOverApproximation{ 0.0 }; ///< Protrusion of the leaf spheres below which they are not split, in the units of the mesh.
+};
+
+/**
+ * @brief Node of a sphere tree. Each sphere encloses the triangles of its patch of the mesh, which is the union of the patches of its children.
+ */
+struct SphereTreeNode {
+    Eigen::Vector3d center{ Eigen::Vector3d::Zero() }; ///< Center of the sphere.
+    double radius{ 0.0 }; ///< Radius of the sphere.
+    double overApproximation{ 0.0 }; ///< Largest distance between the outer side of the sphere and its patch.
+    std::int32_t parent{ -1 }; ///< Index of the parent node, -1 for the root.
+    std::int32_t firstChild{ -1 }; ///< Index of the first child, -1 for the leaves. The children are stored contiguously.
+    std::uint32_t nChildren{ 0 }; ///< Number of children.
+};
+
+/**
+ * @brief Binary sphere tree, with the root at index 0.
+ */
+struct SphereTree {
+    std::vector<SphereTreeNode> nodes;
+};
+
+/**
+ * @brief Computes a binary sphere tree enclosing the surface of a mesh.
+ *
+ * Starting from the sphere enclosing the whole mesh, the leaf with the largest over-approximation is split
+ * at the median of its triangles along its longest axis, until the leaves are maxSpheres or
+ * all of them protrude less than maxOverApproximation. The over-approximation of a sphere is the largest
+ * distance between the points of the sphere on the outer side of its patch and the vertices of the patch. The result is deterministic.
+ *
+ * @param mesh The mesh to approximate.
+ * @param parameters The parameters of the tree.
+ * @return SphereTree The tree, empty if the mesh has no triangles.
+ */
+SphereTree computeSphereTree(const TriangleMesh& mesh, const SphereTreeParameters& parameters);
+
+/**
+ * @brief Gets the leaves of a sphere tree, which cover the whole surface of the mesh.
+ * @param tree The sphere tree.
+ * @return std::vector<SphereTreeNode> The leaves, in the order of the nodes.
+ */
+std::vector<SphereTreeNode> getSphereTreeLeaves(const SphereTree& tree);
+
+#endif // !CREO2URDF_MESH_SPHERETREE_H
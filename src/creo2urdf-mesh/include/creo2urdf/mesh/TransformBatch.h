@@ -0,0 +1,107 @@
+/** @file TransformBatch.h
+ *  @brief Contains the batches of rigid transforms and inertias, stored as struct of arrays, and the kernels processing them.
+ *
+ * Each component of the transforms and of the inertias is stored in its own array, so that the kernels
+ * process all the links of a model in vectorized passes instead of composing one transform at a time.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_TRANSFORMBATCH_H
+#define CREO2URDF_MESH_TRANSFORMBATCH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Core>
+
+/**
+ * @brief Rigid transforms a_H_b, stored as struct of arrays.
+ */
+struct TransformBatch {
+    std::array<std::vector<double>, 9> rotation; ///< Elements of the rotation matrices in row major order, rotation[3 * row + col][i].
+    std::array<std::vector<double>, 3> position; ///< Coordinates of the origins of b expressed in a.
+
+    /**
+     * @brief Gets the number of transforms.
+     */
+    std::size_t size() const { return position[0].size(); }
+
+    /**
+     * @brief Resizes the batch, the new transforms are the identity.
+     */
+    void resize(std::size_t n);
+
+    /**
+     * @brief Appends a transform.
+     * @return std::size_t The index of the transform.
+     */
+    std::size_t append(const Eigen::Matrix3d& R, const Eigen::Vector3d& p);
+
+    void set(std::size_t i, const Eigen::Matrix3d& R, const Eigen::Vector3d& p);
+    Eigen::Matrix3d getRotation(std::size_t i) const;
+    Eigen::Vector3d getPosition(std::size_t i) const;
+};
+
+/**
+ * @brief Mass, center of mass and inertia tensor with respect to the center of mass, stored as struct of arrays.
+ */
+struct InertiaBatch {
+    std::vector<double> mass; ///< Masses.
+    std::array<std::vector<double>, 3> centerOfMass; ///< Coordinates of the centers of mass.
+    std::array<std::vector<double>, 6> tensor; ///< Elements xx, yy, zz, xy, xz, yz of the symmetric inertia tensors.
+
+    /**
+     * @brief Gets the number of inertias.
+     */
+    std::size_t size() const { return mass.size(); }
+
+    /**
+     * @brief Appends an inertia, the tensor is assumed symmetric.
+     * @return std::size_t The index of the inertia.
+     */
+    std::size_t append(double m, const Eigen::Vector3d& com, const Eigen::Matrix3d& inertia);
+
+    Eigen::Vector3d getCenterOfMass(std::size_t i) const;
+    Eigen::Matrix3d getTensor(std::size_t i) const;
+};
+
+/**
+ * @brief Inverts all the transforms of a batch.
+ *
+ * @param a_H_b The transforms.
+ * @param[out] b_H_a The inverse transforms, resized as a_H_b.
+ */
+void invertTransforms(const TransformBatch& a_H_b, TransformBatch& b_H_a);
+
+/**
+ * @brief Composes pairs of transforms, a_H_c[k] = a_H_b[lhs_index[k]] * b_H_c[rhs_index[k]],
+ * e.g. the transforms between the parent and the child of all the joints from the inverse poses of the links and their poses.
+ *
+ * @param a_H_b The transforms on the left.
+ * @param lhs_index Index in a_H_b of the left transform of each pair.
+ * @param b_H_c The transforms on the right.
+ * @param rhs_index Index in b_H_c of the right transform of each pair, of the same size as lhs_index.
+ * @param[out] a_H_c The composed transforms, one for each pair.
+ */
+void composeTransforms(const TransformBatch& a_H_b, const std::vector<std::uint32_t>& lhs_index,
+                       const TransformBatch& b_H_c, const std::vector<std::uint32_t>& rhs_index,
+                       TransformBatch& a_H_c);
+
+/**
+ * @brief Expresses inertias in another frame: the centers of mass are transformed, com_b = b_H_a * com_a,
+ * and the tensors are rotated, I_b = b_R_a * I_a * b_R_a^T. The masses are unchanged.
+ *
+ * @param b_H_a The transforms from the frame of each inertia to the new frame, of the same size as inertias.
+ * @param[in,out] inertias The inertias expressed in a, then in b.
+ */
+void transformInertias(const TransformBatch& b_H_a, InertiaBatch& inertias);
+
+#endif // !CREO2URDF_MESH_TRANSFORMBATCH_H
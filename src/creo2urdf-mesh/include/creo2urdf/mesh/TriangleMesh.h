@@ -0,0 +1,122 @@
+/** @file TriangleMesh.h
+ *  @brief Contains the indexed triangle mesh used by the mesh processing stages, and its I/O functions.
+ *
+ * The functions declared in this file do not depend on Creo, so that they can be used
+ * and benchmarked outside of the plugin.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef CREO2URDF_MESH_TRIANGLEMESH_H
+#define CREO2URDF_MESH_TRIANGLEMESH_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+/**
+ * @brief Indexed triangle mesh. Triangles are counter-clockwise when seen from outside.
+ */
+struct TriangleMesh {
+    std::vector<Eigen::Vector3d> vertices; ///< Positions of the vertices.
+    std::vector<std::array<std::uint32_t, 3>> triangles; ///< Indices of the vertices of each triangle.
+};
+
+/**
+ * @brief Axis aligned bounding box.
+ */
+struct BoundingBox {
+    Eigen::Vector3d min{ Eigen::Vector3d::Zero() }; ///< Corner with the minimum coordinates.
+    Eigen::Vector3d max{ Eigen::Vector3d::Zero() }; ///< Corner with the maximum coordinates.
+};
+
+/**
+ * @brief Reads a STL file, either binary or ASCII, merging the vertices with the same coordinates.
+ * The binary format is detected from the size of the file, since the header of binary files
+ * exported by creo2urdf does not start with "solid", see sanitizeSTL.
+ *
+ * @param filename Path of the STL file.
+ * @param[out] mesh The mesh read from file.
+ * @return True if successful, false otherwise.
+ */
+bool readSTL(const std::string& filename, TriangleMesh& mesh);
+
+/**
+ * @brief Writes a mesh as binary STL file.
+ *
+ * @param filename Path of the STL file.
+ * @param mesh The mesh to write.
+ * @return True if successful, false otherwise.
+ */
+bool writeBinarySTL(const std::string& filename, const TriangleMesh& mesh);
+
+/**
+ * @brief Builds an indexed mesh from independent triangles, e.g. a tessellation fetched from a CAD,
+ * merging the vertices and dropping the degenerate triangles as readSTL does.
+ * The coordinates are rounded to single precision, so that the mesh is identical to the one read back from its binary STL file.
+ *
+ * @param corners The corners of the triangles, three consecutive vectors per triangle.
+ * @return TriangleMesh The indexed mesh.
+ */
+TriangleMesh weldTriangles(const std::vector<Eigen::Vector3d>& corners);
+
+/**
+ * @brief Computes the unit normal of each triangle from its vertices, zero for the degenerate triangles.
+ *
+ * @param mesh The mesh.
+ * @return std::vector<Eigen::Vector3d> The normals, in the order of the triangles.
+ */
+std::vector<Eigen::Vector3d> computeTriangleNormals(const TriangleMesh& mesh);
+
+/**
+ * @brief Computes the axis aligned bounding box of the vertices of a mesh.
+ *
+ * @param vertices The vertices of the mesh.
+ * @return BoundingBox The bounding box, empty if there are no vertices.
+ */
+BoundingBox computeBoundingBox(const std::vector<Eigen::Vector3d>& vertices);
+
+/**
+ * @brief Computes the volume enclosed by a closed mesh with the divergence theorem.
+ *
+ * @param mesh The closed mesh.
+ * @return double The signed volume, positive if the triangles are counter-clockwise.
+ */
+double computeVolume(const TriangleMesh& mesh);
+
+/**
+ * @brief Computes a 64 bit FNV-1a hash of a buffer, that can be chained through seed.
+ *
+ * @param data Pointer to the buffer.
+ * @param size Size of the buffer in bytes.
+ * @param seed Hash of the previous buffers, if any.
+ * @return std::uint64_t The hash of the buffer.
+ */
+std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t seed = 14695981039346656037ULL);
+
+/**
+ * @brief Computes the hash of the content of a mesh, i.e. its vertices and triangles.
+ *
+ * @param mesh The mesh to hash.
+ * @return std::uint64_t The hash of the mesh.
+ */
+std::uint64_t hashMesh(const TriangleMesh& mesh);
+
+/**
+ * @brief Converts a hash to a string of 16 hexadecimal digits, usable as file name.
+ *
+ * @param hash The hash to convert.
+ * @return std::string The hexadecimal representation.
+ */
+std::string hashToString(std::uint64_t hash);
+
+#endif // !CREO2URDF_MESH_TRIANGLEMESH_H
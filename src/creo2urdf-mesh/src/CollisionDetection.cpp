@@ -0,0 +1,208 @@
+/**
+ * @file CollisionDetection.cpp
+ * @brief Contains the definition of the bounding volume hierarchies and of the mesh-mesh collision queries.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/CollisionDetection.h>
+#include <creo2urdf/mesh/Parallel.h>
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Maximum number of triangles of a leaf.
+ */
+constexpr std::uint32_t max_leaf_triangles = 4;
+
+using Triangle = std::array<Eigen::Vector3d, 3>;
+
+BoundingBox computeTrianglesBox(const std::vector<Triangle>& triangles, std::uint32_t first, std::uint32_t count) {
+    BoundingBox box;
+    box.min = box.max = triangles[first][0];
+    for (std::uint32_t i = first; i < first + count; i++) {
+        for (const auto& v : triangles[i]) {
+            box.min = box.min.cwiseMin(v);
+            box.max = box.max.cwiseMax(v);
+        }
+    }
+    return box;
+}
+
+void buildNode(MeshBVH& bvh, std::uint32_t node, std::uint32_t first, std::uint32_t count) {
+    bvh.nodes[node].box = computeTrianglesBox(bvh.triangles, first, count);
+    if (count <= max_leaf_triangles) {
+        bvh.nodes[node].first = first;
+        bvh.nodes[node].count = count;
+        return;
+    }
+
+    int axis = 0;
+    (bvh.nodes[node].box.max - bvh.nodes[node].box.min).maxCoeff(&axis);
+    auto begin = bvh.triangles.begin() + first;
+    auto middle = begin + count / 2;
+    std::nth_element(begin, middle, begin + count, [axis](const Triangle& a, const Triangle& b) {
+        return a[0][axis] + a[1][axis] + a[2][axis] < b[0][axis] + b[1][axis] + b[2][axis];
+    });
+
+    auto children = static_cast<std::uint32_t>(bvh.nodes.size());
+    bvh.nodes[node].first = children;
+    bvh.nodes.resize(bvh.nodes.size() + 2);
+    buildNode(bvh, children, first, count / 2);
+    buildNode(bvh, children + 1, first + count / 2, count - count / 2);
+}
+
+/**
+ * @brief Checks whether the segment pq crosses the triangle abc (Moller-Trumbore).
+ */
+bool segmentIntersectsTriangle(const Eigen::Vector3d& p, const Eigen::Vector3d& q, const Triangle& t) {
+    Eigen::Vector3d dir = q - p;
+    Eigen::Vector3d e1 = t[1] - t[0];
+    Eigen::Vector3d e2 = t[2] - t[0];
+    Eigen::Vector3d h = dir.cross(e2);
+    double det = e1.dot(h);
+    // Segments parallel to the triangle are handled by the edges of the other triangle
+    if (std::abs(det) <= 1e-12 * e1.squaredNorm() * dir.norm()) {
+        return false;
+    }
+    double inv_det = 1.0 / det;
+    Eigen::Vector3d s = p - t[0];
+    double u = s.dot(h) * inv_det;
+    if (u < 0.0 || u > 1.0) {
+        return false;
+    }
+    Eigen::Vector3d r = s.cross(e1);
+    double v = dir.dot(r) * inv_det;
+    if (v < 0.0 || u + v > 1.0) {
+        return false;
+    }
+    double w = e2.dot(r) * inv_det;
+    return w >= 0.0 && w <= 1.0;
+}
+
+/**
+ * @brief Two non coplanar triangles intersect if and only if an edge of one of them crosses the other one.
+ */
+bool trianglesIntersect(const Triangle& a, const Triangle& b) {
+    for (int e = 0; e < 3; e++) {
+        if (segmentIntersectsTriangle(a[e], a[(e + 1) % 3], b) || segmentIntersectsTriangle(b[e], b[(e + 1) % 3], a)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool boxesOverlap(const BoundingBox& a, const BoundingBox& b) {
+    return (a.min.array() <= b.max.array()).all() && (b.min.array() <= a.max.array()).all();
+}
+
+/**
+ * @brief Computes the axis aligned box enclosing a box transformed by a rigid transform.
+ */
+BoundingBox transformBox(const BoundingBox& box, const Eigen::Isometry3d& transform) {
+    Eigen::Vector3d center = transform * (0.5 * (box.min + box.max));
+    Eigen::Vector3d extent = transform.linear().cwiseAbs() * (0.5 * (box.max - box.min));
+    BoundingBox transformed;
+    transformed.min = center - extent;
+    transformed.max = center + extent;
+    return transformed;
+}
+
+} // namespace
+
+MeshBVH buildMeshBVH(const TriangleMesh& mesh)
+{
+    MeshBVH bvh;
+    if (mesh.triangles.empty()) {
+        return bvh;
+    }
+    bvh.triangles.reserve(mesh.triangles.size());
+    for (const auto& t : mesh.triangles) {
+        bvh.triangles.push_back({ mesh.vertices[t[0]], mesh.vertices[t[1]], mesh.vertices[t[2]] });
+    }
+    bvh.nodes.reserve(2 * mesh.triangles.size() / max_leaf_triangles + 1);
+    bvh.nodes.resize(1);
+    buildNode(bvh, 0, 0, static_cast<std::uint32_t>(bvh.triangles.size()));
+    return bvh;
+}
+
+bool meshesIntersect(const MeshBVH& a, const Eigen::Isometry3d& world_H_a, const MeshBVH& b, const Eigen::Isometry3d& world_H_b)
+{
+    if (a.nodes.empty() || b.nodes.empty()) {
+        return false;
+    }
+
+    // The traversal is done in the frame of a
+    Eigen::Isometry3d a_H_b = world_H_a.inverse() * world_H_b;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> stack{ { 0, 0 } };
+    while (!stack.empty()) {
+        auto node_pair = stack.back();
+        stack.pop_back();
+        const auto& node_a = a.nodes[node_pair.first];
+        const auto& node_b = b.nodes[node_pair.second];
+        if (!boxesOverlap(node_a.box, transformBox(node_b.box, a_H_b))) {
+            continue;
+        }
+
+        if (node_a.count > 0 && node_b.count > 0) {
+            for (std::uint32_t j = node_b.first; j < node_b.first + node_b.count; j++) {
+                Triangle triangle_b{ a_H_b * b.triangles[j][0], a_H_b * b.triangles[j][1], a_H_b * b.triangles[j][2] };
+                for (std::uint32_t i = node_a.first; i < node_a.first + node_a.count; i++) {
+                    if (trianglesIntersect(a.triangles[i], triangle_b)) {
+                        return true;
+                    }
+                }
+            }
+            continue;
+        }
+
+        // Descend the inner node with the biggest box
+        bool descend_a = node_b.count > 0 ||
+            (node_a.count == 0 && (node_a.box.max - node_a.box.min).squaredNorm() >= (node_b.box.max - node_b.box.min).squaredNorm());
+        if (descend_a) {
+            stack.emplace_back(node_a.first, node_pair.second);
+            stack.emplace_back(node_a.first + 1, node_pair.second);
+        }
+        else {
+            stack.emplace_back(node_pair.first, node_b.first);
+            stack.emplace_back(node_pair.first, node_b.first + 1);
+        }
+    }
+    return false;
+}
+
+std::vector<std::size_t> countCollisions(const std::vector<MeshBVH>& meshes, const std::vector<MeshPoses>& samples,
+                                         const std::vector<std::pair<std::size_t, std::size_t>>& pairs, unsigned n_threads)
+{
+    // Broad phase: world bounding box of each mesh in each sample
+    std::vector<std::vector<BoundingBox>> world_boxes(samples.size());
+    parallelFor(samples.size(), [&](std::size_t s) {
+        world_boxes[s].resize(meshes.size());
+        for (std::size_t m = 0; m < meshes.size(); m++) {
+            if (!meshes[m].nodes.empty()) {
+                world_boxes[s][m] = transformBox(meshes[m].nodes[0].box, samples[s][m]);
+            }
+        }
+    }, n_threads);
+
+    std::vector<std::size_t> counts(pairs.size(), 0);
+    parallelFor(pairs.size(), [&](std::size_t p) {
+        auto a = pairs[p].first;
+        auto b = pairs[p].second;
+        if (meshes[a].nodes.empty() || meshes[b].nodes.empty()) {
+            return;
+        }
+        for (std::size_t s = 0; s < samples.size(); s++) {
+            if (boxesOverlap(world_boxes[s][a], world_boxes[s][b]) &&
+                meshesIntersect(meshes[a], samples[s][a], meshes[b], samples[s][b])) {
+                counts[p]++;
+            }
+        }
+    }, n_threads);
+    return counts;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file ConvexDecomposition.cpp
+ * @brief Contains the definition of the approximate convex decomposition.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/ConvexDecomposition.h>
+#include <creo2urdf/mesh/ConvexHull.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+/**
+ * @brief Number of samples of a part used to evaluate its concavity, to bound the cost of the splits.
+ */
+constexpr std::size_t max_evaluation_samples = 1000;
+
+/**
+ * @brief Number of candidate cutting planes evaluated along each axis.
+ */
+constexpr int cuts_per_axis = 7;
+
+struct Part {
+    std::vector<std::uint32_t> samples; ///< Indices of the surface samples belonging to the part.
+    double concavity{ 0.0 };
+    bool splittable{ true };
+};
+
+std::vector<Eigen::Vector3d> gather(const std::vector<Eigen::Vector3d>& samples, const std::vector<std::uint32_t>& indices, std::size_t max_points) {
+    std::size_t stride = max_points > 0 ? std::max<std::size_t>(1, indices.size() / max_points) : 1;
+    std::vector<Eigen::Vector3d> points;
+    points.reserve(indices.size() / stride + 1);
+    for (std::size_t i = 0; i < indices.size(); i += stride) {
+        points.push_back(samples[indices[i]]);
+    }
+    return points;
+}
+
+/**
+ * @brief Computes the concavity of a set of surface points as their maximum depth inside their convex hull.
+ */
+double computeConcavity(const std::vector<Eigen::Vector3d>& points) {
+    TriangleMesh hull = computeConvexHull(points);
+    if (hull.triangles.empty()) {
+        // Flat parts are already convex
+        return 0.0;
+    }
+
+    std::vector<Eigen::Vector3d> normals;
+    std::vector<double> offsets;
+    normals.reserve(hull.triangles.size());
+    offsets.reserve(hull.triangles.size());
+    for (const auto& t : hull.triangles) {
+        Eigen::Vector3d n = (hull.vertices[t[1]] - hull.vertices[t[0]]).cross(hull.vertices[t[2]] - hull.vertices[t[0]]);
+        double norm = n.norm();
+        if (norm <= 0.0) {
+            continue;
+        }
+        n /= norm;
+        normals.push_back(n);
+        offsets.push_back(n.dot(hull.vertices[t[0]]));
+    }
+
+    double concavity = 0.0;
+    for (const auto& p : points) {
+        double depth = std::numeric_limits<double>::max();
+        for (std::size_t f = 0; f < normals.size(); f++) {
+            depth = std::min(depth, offsets[f] - normals[f].dot(p));
+        }
+        concavity = std::max(concavity, depth);
+    }
+    return concavity;
+}
+
+double evaluate(const std::vector<Eigen::Vector3d>& samples, Part& part) {
+    part.concavity = computeConcavity(gather(samples, part.samples, max_evaluation_samples));
+    return part.concavity;
+}
+
+/**
+ * @brief Splits a part with the axis aligned plane that minimizes the sum of the concavities of the halves.
+ * @return True if a valid split was found.
+ */
+bool split(const std::vector<Eigen::Vector3d>& samples, const Part& part, Part& left, Part& right) {
+    auto points = gather(samples, part.samples, 0);
+    auto box = computeBoundingBox(points);
+
+    double best_cost = std::numeric_limits<double>::max();
+    bool found = false;
+    for (int axis = 0; axis < 3; axis++) {
+        double extent = box.max[axis] - box.min[axis];
+        if (extent <= 0.0) {
+            continue;
+        }
+        for (int c = 1; c <= cuts_per_axis; c++) {
+            double cut = box.min[axis] + extent * c / (cuts_per_axis + 1);
+            Part candidate_left, candidate_right;
+            for (auto i : part.samples) {
+                (samples[i][axis] < cut ? candidate_left : candidate_right).samples.push_back(i);
+            }
+            if (candidate_left.samples.size() < 4 || candidate_right.samples.size() < 4) {
+                continue;
+            }
+            double cost = evaluate(samples, candidate_left) + evaluate(samples, candidate_right);
+            if (cost < best_cost) {
+                best_cost = cost;
+                left = std::move(candidate_left);
+                right = std::move(candidate_right);
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+} // namespace
+
+std::vector<TriangleMesh> computeConvexDecomposition(const TriangleMesh& mesh, const ConvexDecompositionParameters& parameters)
+{
+    std::vector<TriangleMesh> hulls;
+    if (mesh.triangles.empty() || parameters.maxHulls == 0) {
+        return hulls;
+    }
+
+    // Surface samples: the vertices, plus the centroids so that big flat triangles are not empty
+    std::vector<Eigen::Vector3d> samples = mesh.vertices;
+    samples.reserve(mesh.vertices.size() + mesh.triangles.size());
+    for (const auto& t : mesh.triangles) {
+        samples.push_back((mesh.vertices[t[0]] + mesh.vertices[t[1]] + mesh.vertices[t[2]]) / 3.0);
+    }
+
+    auto box = computeBoundingBox(samples);
+    double concavity_threshold = parameters.maxConcavity * (box.max - box.min).norm();
+
+    std::vector<Part> parts(1);
+    parts[0].samples.resize(samples.size());
+    for (std::uint32_t i = 0; i < samples.size(); i++) {
+        parts[0].samples[i] = i;
+    }
+    evaluate(samples, parts[0]);
+
+    while (parts.size() < parameters.maxHulls) {
+        auto worst = std::max_element(parts.begin(), parts.end(), [](const Part& a, const Part& b) {
+            return (a.splittable ? a.concavity : -1.0) < (b.splittable ? b.concavity : -1.0);
+        });
+        if (!worst->splittable || worst->concavity <= concavity_threshold) {
+            break;
+        }
+
+        Part left, right;
+        if (!split(samples, *worst, left, right)) {
+            worst->splittable = false;
+            continue;
+        }
+        *worst = std::move(left);
+        parts.push_back(std::move(right));
+    }
+
+    for (const auto& part : parts) {
+        TriangleMesh hull = computeConvexHull(gather(samples, part.samples, 0), parameters.maxVerticesPerHull);
+        if (!hull.triangles.empty()) {
+            hulls.push_back(std::move(hull));
+        }
+    }
+    return hulls;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file ConvexHull.cpp
+ * @brief Contains the definition of the quickhull algorithm.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/ConvexHull.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+struct HullFace {
+    std::array<std::uint32_t, 3> v; ///< Indices of the points, counter-clockwise seen from outside.
+    Eigen::Vector3d normal{ Eigen::Vector3d::Zero() }; ///< Outward unit normal.
+    double offset{ 0.0 }; ///< Signed distance of the plane from the origin.
+    std::vector<std::uint32_t> outside; ///< Points above the face, not yet in the hull.
+    double farthest{ 0.0 }; ///< Distance of the farthest outside point.
+    bool alive{ true };
+
+    double distance(const Eigen::Vector3d& p) const { return normal.dot(p) - offset; }
+};
+
+std::uint64_t edgeKey(std::uint32_t a, std::uint32_t b) {
+    return (static_cast<std::uint64_t>(a) << 32) | b;
+}
+
+class QuickHull {
+public:
+    QuickHull(const std::vector<Eigen::Vector3d>& points, double tolerance) : m_points(points), m_tolerance(tolerance) {}
+
+    bool initialize() {
+        // Extreme points along the axis of maximum extent
+        std::array<std::uint32_t, 4> s{ 0, 0, 0, 0 };
+        auto box = computeBoundingBox(m_points);
+        int axis = 0;
+        (box.max - box.min).maxCoeff(&axis);
+        for (std::uint32_t i = 0; i < m_points.size(); i++) {
+            if (m_points[i][axis] < m_points[s[0]][axis]) s[0] = i;
+            if (m_points[i][axis] > m_points[s[1]][axis]) s[1] = i;
+        }
+
+        // Farthest point from the line of the first two
+        Eigen::Vector3d dir = (m_points[s[1]] - m_points[s[0]]).normalized();
+        double max_distance = 0.0;
+        for (std::uint32_t i = 0; i < m_points.size(); i++) {
+            double d = (m_points[i] - m_points[s[0]]).cross(dir).norm();
+            if (d > max_distance) { max_distance = d; s[2] = i; }
+        }
+        if (max_distance < m_tolerance) {
+            return false;
+        }
+
+        // Farthest point from the plane of the first three
+        Eigen::Vector3d n = (m_points[s[1]] - m_points[s[0]]).cross(m_points[s[2]] - m_points[s[0]]).normalized();
+        max_distance = 0.0;
+        for (std::uint32_t i = 0; i < m_points.size(); i++) {
+            double d = std::abs(n.dot(m_points[i] - m_points[s[0]]));
+            if (d > max_distance) { max_distance = d; s[3] = i; }
+        }
+        if (max_distance < m_tolerance) {
+            return false;
+        }
+
+        m_centroid = (m_points[s[0]] + m_points[s[1]] + m_points[s[2]] + m_points[s[3]]) / 4.0;
+        std::vector<std::uint32_t> new_faces;
+        new_faces.push_back(addFace(s[0], s[1], s[2]));
+        new_faces.push_back(addFace(s[0], s[1], s[3]));
+        new_faces.push_back(addFace(s[0], s[2], s[3]));
+        new_faces.push_back(addFace(s[1], s[2], s[3]));
+        m_n_vertices = 4;
+
+        std::vector<std::uint32_t> remaining;
+        remaining.reserve(m_points.size());
+        for (std::uint32_t i = 0; i < m_points.size(); i++) {
+            if (i != s[0] && i != s[1] && i != s[2] && i != s[3]) {
+                remaining.push_back(i);
+            }
+        }
+        assignToFaces(remaining, new_faces);
+        return true;
+    }
+
+    void run(std::size_t max_vertices) {
+        std::vector<std::uint32_t> pending;
+        for (std::uint32_t f = 0; f < m_faces.size(); f++) {
+            pending.push_back(f);
+        }
+
+        while (!pending.empty()) {
+            if (max_vertices > 0 && m_n_vertices >= max_vertices) {
+                return;
+            }
+            std::uint32_t f = pending.back();
+            if (!m_faces[f].alive || m_faces[f].outside.empty()) {
+                pending.pop_back();
+                continue;
+            }
+            if (max_vertices > 0) {
+                // With a vertex budget the farthest points overall are added first, so that the truncated hull is the best one
+                for (auto candidate : pending) {
+                    if (m_faces[candidate].alive && m_faces[candidate].farthest > m_faces[f].farthest) {
+                        f = candidate;
+                    }
+                }
+            }
+
+            // Farthest point from the face, always a vertex of the final hull
+            std::uint32_t apex = m_faces[f].outside.front();
+            double max_distance = m_faces[f].distance(m_points[apex]);
+            for (auto i : m_faces[f].outside) {
+                double d = m_faces[f].distance(m_points[i]);
+                if (d > max_distance) { max_distance = d; apex = i; }
+            }
+
+            // Visible faces are connected, so they are found by flood fill from f
+            std::vector<std::uint32_t> visible{ f };
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> horizon;
+            std::unordered_map<std::uint32_t, bool> is_visible{ { f, true } };
+            for (std::size_t k = 0; k < visible.size(); k++) {
+                const auto v = m_faces[visible[k]].v;
+                for (int e = 0; e < 3; e++) {
+                    std::uint32_t a = v[e];
+                    std::uint32_t b = v[(e + 1) % 3];
+                    std::uint32_t neighbor = m_edges.at(edgeKey(b, a));
+                    auto it = is_visible.find(neighbor);
+                    if (it == is_visible.end()) {
+                        bool neighbor_visible = m_faces[neighbor].distance(m_points[apex]) > m_tolerance;
+                        it = is_visible.emplace(neighbor, neighbor_visible).first;
+                        if (neighbor_visible) {
+                            visible.push_back(neighbor);
+                        }
+                    }
+                    if (!it->second) {
+                        horizon.emplace_back(a, b);
+                    }
+                }
+            }
+
+            std::vector<std::uint32_t> orphans;
+            for (auto v : visible) {
+                orphans.insert(orphans.end(), m_faces[v].outside.begin(), m_faces[v].outside.end());
+                removeFace(v);
+            }
+
+            std::vector<std::uint32_t> new_faces;
+            for (const auto& edge : horizon) {
+                new_faces.push_back(addFace(edge.first, edge.second, apex));
+            }
+            m_n_vertices++;
+
+            orphans.erase(std::remove(orphans.begin(), orphans.end(), apex), orphans.end());
+            assignToFaces(orphans, new_faces);
+            pending.insert(pending.end(), new_faces.begin(), new_faces.end());
+        }
+    }
+
+    TriangleMesh toMesh() const {
+        TriangleMesh hull;
+        std::unordered_map<std::uint32_t, std::uint32_t> remap;
+        for (const auto& face : m_faces) {
+            if (!face.alive) {
+                continue;
+            }
+            std::array<std::uint32_t, 3> t;
+            for (int k = 0; k < 3; k++) {
+                auto it = remap.find(face.v[k]);
+                if (it == remap.end()) {
+                    it = remap.emplace(face.v[k], static_cast<std::uint32_t>(hull.vertices.size())).first;
+                    hull.vertices.push_back(m_points[face.v[k]]);
+                }
+                t[k] = it->second;
+            }
+            hull.triangles.push_back(t);
+        }
+        return hull;
+    }
+
+private:
+    std::uint32_t addFace(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+        HullFace face;
+        face.v = { a, b, c };
+        face.normal = (m_points[b] - m_points[a]).cross(m_points[c] - m_points[a]);
+        double norm = face.normal.norm();
+        if (norm > 0.0) {
+            face.normal /= norm;
+        }
+        face.offset = face.normal.dot(m_points[a]);
+        // Only the faces of the initial simplex may need to be flipped, the others inherit the horizon orientation
+        if (face.distance(m_centroid) > 0.0 && m_faces.size() < 4) {
+            std::swap(face.v[1], face.v[2]);
+            face.normal = -face.normal;
+            face.offset = -face.offset;
+        }
+        auto index = static_cast<std::uint32_t>(m_faces.size());
+        for (int e = 0; e < 3; e++) {
+            m_edges[edgeKey(face.v[e], face.v[(e + 1) % 3])] = index;
+        }
+        m_faces.push_back(std::move(face));
+        return index;
+    }
+
+    void removeFace(std::uint32_t f) {
+        auto& face = m_faces[f];
+        face.alive = false;
+        face.outside.clear();
+        face.outside.shrink_to_fit();
+        for (int e = 0; e < 3; e++) {
+            auto it = m_edges.find(edgeKey(face.v[e], face.v[(e + 1) % 3]));
+            if (it != m_edges.end() && it->second == f) {
+                m_edges.erase(it);
+            }
+        }
+    }
+
+    void assignToFaces(const std::vector<std::uint32_t>& candidates, const std::vector<std::uint32_t>& faces) {
+        for (auto i : candidates) {
+            double max_distance = m_tolerance;
+            std::uint32_t best = 0;
+            bool found = false;
+            for (auto f : faces) {
+                double d = m_faces[f].distance(m_points[i]);
+                if (d > max_distance) { max_distance = d; best = f; found = true; }
+            }
+            if (found) {
+                m_faces[best].outside.push_back(i);
+                m_faces[best].farthest = std::max(m_faces[best].farthest, max_distance);
+            }
+        }
+    }
+
+    const std::vector<Eigen::Vector3d>& m_points;
+    double m_tolerance;
+    Eigen::Vector3d m_centroid{ Eigen::Vector3d::Zero() };
+    std::vector<HullFace> m_faces;
+    std::unordered_map<std::uint64_t, std::uint32_t> m_edges; ///< Directed edge -> face containing it.
+    std::size_t m_n_vertices{ 0 };
+};
+
+} // namespace
+
+TriangleMesh computeConvexHull(const std::vector<Eigen::Vector3d>& points, std::size_t max_vertices)
+{
+    if (points.size() < 4) {
+        return TriangleMesh();
+    }
+    auto box = computeBoundingBox(points);
+    double tolerance = std::max(1e-12, (box.max - box.min).norm() * 1e-10);
+
+    QuickHull quickhull(points, tolerance);
+    if (!quickhull.initialize()) {
+        return TriangleMesh();
+    }
+    quickhull.run(max_vertices);
+    return quickhull.toMesh();
+}
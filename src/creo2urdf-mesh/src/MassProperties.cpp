@@ -0,0 +1,120 @@
+/**
+ * @file MassProperties.cpp
+ * @brief Contains the definition of the mass properties of a closed mesh.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/MassProperties.h>
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Number of triangles integrated together.
+ */
+constexpr std::size_t block_size = 256;
+
+using Block = Eigen::Array<double, Eigen::Dynamic, 1>;
+
+/**
+ * @brief Subexpressions of the integrals along one axis, see Eberly.
+ */
+struct Subexpressions {
+    Block f1, f2, f3, g0, g1, g2;
+
+    Subexpressions(const Block& w0, const Block& w1, const Block& w2) {
+        Block temp0 = w0 + w1;
+        f1 = temp0 + w2;
+        Block temp1 = w0 * w0;
+        Block temp2 = temp1 + w1 * temp0;
+        f2 = temp2 + w2 * f1;
+        f3 = w0 * temp1 + w1 * temp2 + w2 * f2;
+        g0 = f2 + w0 * (f1 + w0);
+        g1 = f2 + w1 * (f1 + w1);
+        g2 = f2 + w2 * (f1 + w2);
+    }
+};
+
+} // namespace
+
+bool computeMassProperties(const TriangleMesh& mesh, double density, MassProperties& properties)
+{
+    properties = MassProperties();
+
+    // Integrals of 1, x, y, z, x^2, y^2, z^2, xy, yz, zx over the volume
+    Eigen::Matrix<double, 10, 1> integrals = Eigen::Matrix<double, 10, 1>::Zero();
+    std::array<std::array<Block, 3>, 3> v;
+    for (std::size_t first = 0; first < mesh.triangles.size(); first += block_size) {
+        auto n = static_cast<Eigen::Index>(std::min(block_size, mesh.triangles.size() - first));
+        for (auto& vertex : v) {
+            for (auto& coordinate : vertex) {
+                coordinate.resize(n);
+            }
+        }
+        for (Eigen::Index t = 0; t < n; t++) {
+            const auto& triangle = mesh.triangles[first + t];
+            for (int k = 0; k < 3; k++) {
+                const auto& p = mesh.vertices[triangle[k]];
+                v[k][0][t] = p.x();
+                v[k][1][t] = p.y();
+                v[k][2][t] = p.z();
+            }
+        }
+
+        const Block& x0 = v[0][0]; const Block& y0 = v[0][1]; const Block& z0 = v[0][2];
+        const Block& x1 = v[1][0]; const Block& y1 = v[1][1]; const Block& z1 = v[1][2];
+        const Block& x2 = v[2][0]; const Block& y2 = v[2][1]; const Block& z2 = v[2][2];
+
+        // Normal of the triangles, scaled by twice their area
+        Block a1 = x1 - x0, b1 = y1 - y0, c1 = z1 - z0;
+        Block a2 = x2 - x0, b2 = y2 - y0, c2 = z2 - z0;
+        Block d0 = b1 * c2 - b2 * c1;
+        Block d1 = a2 * c1 - a1 * c2;
+        Block d2 = a1 * b2 - a2 * b1;
+
+        Subexpressions sx(x0, x1, x2);
+        Subexpressions sy(y0, y1, y2);
+        Subexpressions sz(z0, z1, z2);
+
+        integrals[0] += (d0 * sx.f1).sum();
+        integrals[1] += (d0 * sx.f2).sum();
+        integrals[2] += (d1 * sy.f2).sum();
+        integrals[3] += (d2 * sz.f2).sum();
+        integrals[4] += (d0 * sx.f3).sum();
+        integrals[5] += (d1 * sy.f3).sum();
+        integrals[6] += (d2 * sz.f3).sum();
+        integrals[7] += (d0 * (y0 * sx.g0 + y1 * sx.g1 + y2 * sx.g2)).sum();
+        integrals[8] += (d1 * (z0 * sy.g0 + z1 * sy.g1 + z2 * sy.g2)).sum();
+        integrals[9] += (d2 * (x0 * sz.g0 + x1 * sz.g1 + x2 * sz.g2)).sum();
+    }
+    integrals[0] /= 6.0;
+    integrals.segment<3>(1) /= 24.0;
+    integrals.segment<3>(4) /= 60.0;
+    integrals.segment<3>(7) /= 120.0;
+
+    if (!(integrals[0] > 0.0)) {
+        return false;
+    }
+
+    properties.volume = integrals[0];
+    properties.mass = density * properties.volume;
+    const Eigen::Vector3d c = integrals.segment<3>(1) / integrals[0];
+    properties.centerOfMass = c;
+
+    // Second moments moved to the center of mass
+    double v0 = integrals[0];
+    Eigen::Matrix3d& inertia = properties.inertia;
+    inertia(0, 0) = integrals[5] + integrals[6] - v0 * (c.y() * c.y() + c.z() * c.z());
+    inertia(1, 1) = integrals[4] + integrals[6] - v0 * (c.z() * c.z() + c.x() * c.x());
+    inertia(2, 2) = integrals[4] + integrals[5] - v0 * (c.x() * c.x() + c.y() * c.y());
+    inertia(0, 1) = inertia(1, 0) = -(integrals[7] - v0 * c.x() * c.y());
+    inertia(1, 2) = inertia(2, 1) = -(integrals[8] - v0 * c.y() * c.z());
+    inertia(0, 2) = inertia(2, 0) = -(integrals[9] - v0 * c.z() * c.x());
+    inertia *= density;
+    return true;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file MeshSymmetry.cpp
+ * @brief Contains the definition of the detection of meshes that are copies or reflections of each other.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/MeshSymmetry.h>
+
+#include <Eigen/Eigenvalues>
+
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * @brief Rounds a value to 4 significant digits.
+ */
+double roundSignificant(double value) {
+    if (value == 0.0) {
+        return 0.0;
+    }
+    double magnitude = std::pow(10.0, std::floor(std::log10(std::abs(value))) - 3);
+    return std::round(value / magnitude) * magnitude;
+}
+
+/**
+ * @brief Grid of the vertices of a mesh, with cells as big as the tolerance, to find the closest vertex in constant time.
+ */
+class VertexGrid {
+public:
+    VertexGrid(const std::vector<Eigen::Vector3d>& vertices, double cell) : m_vertices(vertices), m_cell(cell) {
+        for (std::size_t i = 0; i < vertices.size(); i++) {
+            m_cells[key(cellOf(vertices[i]))].push_back(i);
+        }
+    }
+
+    bool contains(const Eigen::Vector3d& p, double tolerance) const {
+        Eigen::Vector3i c = cellOf(p);
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dz = -1; dz <= 1; dz++) {
+                    auto it = m_cells.find(key(c + Eigen::Vector3i(dx, dy, dz)));
+                    if (it == m_cells.end()) {
+                        continue;
+                    }
+                    for (auto i : it->second) {
+                        if ((m_vertices[i] - p).squaredNorm() <= tolerance * tolerance) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    Eigen::Vector3i cellOf(const Eigen::Vector3d& p) const {
+        return (p / m_cell).array().floor().cast<int>();
+    }
+
+    static std::uint64_t key(const Eigen::Vector3i& c) {
+        return hashBytes(c.data(), sizeof(int) * 3);
+    }
+
+    const std::vector<Eigen::Vector3d>& m_vertices;
+    double m_cell;
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> m_cells;
+};
+
+} // namespace
+
+CanonicalFrame computeCanonicalFrame(const TriangleMesh& mesh)
+{
+    CanonicalFrame frame;
+    if (mesh.vertices.empty()) {
+        return frame;
+    }
+
+    for (const auto& v : mesh.vertices) {
+        frame.centroid += v;
+    }
+    frame.centroid /= static_cast<double>(mesh.vertices.size());
+    Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+    for (const auto& v : mesh.vertices) {
+        Eigen::Vector3d d = v - frame.centroid;
+        covariance += d * d.transpose();
+    }
+    covariance /= static_cast<double>(mesh.vertices.size());
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(covariance);
+    frame.axes = solver.eigenvectors();
+    frame.moments = solver.eigenvalues();
+
+    std::array<double, 5> descriptor{ static_cast<double>(mesh.vertices.size()), static_cast<double>(mesh.triangles.size()),
+                                      roundSignificant(frame.moments[0]), roundSignificant(frame.moments[1]), roundSignificant(frame.moments[2]) };
+    frame.shapeHash = hashBytes(descriptor.data(), sizeof(descriptor));
+    return frame;
+}
+
+bool findCongruence(const TriangleMesh& a, const CanonicalFrame& frame_a, const TriangleMesh& b, const CanonicalFrame& frame_b,
+                    bool mirrored, double tolerance, Eigen::Matrix3d& linear, Eigen::Vector3d& translation)
+{
+    if (a.vertices.size() != b.vertices.size() || a.vertices.empty() || tolerance <= 0.0) {
+        return false;
+    }
+
+    VertexGrid grid(b.vertices, tolerance);
+    // The principal axes are defined up to their sign, so the 8 combinations are tried
+    for (int signs = 0; signs < 8; signs++) {
+        Eigen::Vector3d flip((signs & 1) ? -1.0 : 1.0, (signs & 2) ? -1.0 : 1.0, (signs & 4) ? -1.0 : 1.0);
+        Eigen::Matrix3d candidate = frame_b.axes * flip.asDiagonal() * frame_a.axes.transpose();
+        if ((candidate.determinant() < 0.0) != mirrored) {
+            continue;
+        }
+        Eigen::Vector3d candidate_translation = frame_b.centroid - candidate * frame_a.centroid;
+
+        bool found = true;
+        for (const auto& v : a.vertices) {
+            if (!grid.contains(candidate * v + candidate_translation, tolerance)) {
+                found = false;
+                break;
+            }
+        }
+        if (found) {
+            linear = candidate;
+            translation = candidate_translation;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,318 @@
+/**
+ * @file PrimitiveFitting.cpp
+ * @brief Contains definitions for fitting geometric primitives to a mesh.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/PrimitiveFitting.h>
+#include <creo2urdf/mesh/ConvexHull.h>
+
+#include <Eigen/Eigenvalues>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+/**
+ * @brief Shuffles the points with a fixed seed, so that Welzl's algorithm runs in expected linear time and is deterministic.
+ */
+template <class Point>
+void shuffle(std::vector<Point>& points) {
+    std::mt19937 generator(0);
+    for (std::size_t i = points.size(); i > 1; i--) {
+        std::swap(points[i - 1], points[generator() % i]);
+    }
+}
+
+struct Circle {
+    Eigen::Vector2d center{ Eigen::Vector2d::Zero() };
+    double radius{ 0.0 };
+};
+
+struct Ball {
+    Eigen::Vector3d center{ Eigen::Vector3d::Zero() };
+    double radius{ 0.0 };
+};
+
+Circle circleFrom(const Eigen::Vector2d& a, const Eigen::Vector2d& b) {
+    return { (a + b) / 2.0, (a - b).norm() / 2.0 };
+}
+
+Circle circleFrom(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c) {
+    Eigen::Vector2d ab = b - a;
+    Eigen::Vector2d ac = c - a;
+    double det = 2.0 * (ab.x() * ac.y() - ab.y() * ac.x());
+    if (std::abs(det) <= 1e-30) {
+        // Collinear points, the circle is defined by the farthest pair
+        Circle circles[3] = { circleFrom(a, b), circleFrom(a, c), circleFrom(b, c) };
+        return *std::max_element(circles, circles + 3, [](const Circle& l, const Circle& r) { return l.radius < r.radius; });
+    }
+    Eigen::Vector2d offset((ac.y() * ab.squaredNorm() - ab.y() * ac.squaredNorm()) / det,
+                           (ab.x() * ac.squaredNorm() - ac.x() * ab.squaredNorm()) / det);
+    return { a + offset, offset.norm() };
+}
+
+Ball ballFrom(const Eigen::Vector3d& a, const Eigen::Vector3d& b) {
+    return { (a + b) / 2.0, (a - b).norm() / 2.0 };
+}
+
+Ball ballFrom(const Eigen::Vector3d& a, const Eigen::Vector3d& b, const Eigen::Vector3d& c) {
+    Eigen::Vector3d ab = b - a;
+    Eigen::Vector3d ac = c - a;
+    Eigen::Vector3d n = ab.cross(ac);
+    double den = 2.0 * n.squaredNorm();
+    if (den <= 1e-30) {
+        Ball balls[3] = { ballFrom(a, b), ballFrom(a, c), ballFrom(b, c) };
+        return *std::max_element(balls, balls + 3, [](const Ball& l, const Ball& r) { return l.radius < r.radius; });
+    }
+    Eigen::Vector3d offset = (ab.squaredNorm() * ac.cross(n) + ac.squaredNorm() * n.cross(ab)) / den;
+    return { a + offset, offset.norm() };
+}
+
+Ball ballFrom(const Eigen::Vector3d& a, const Eigen::Vector3d& b, const Eigen::Vector3d& c, const Eigen::Vector3d& d) {
+    Eigen::Matrix3d A;
+    A.row(0) = 2.0 * (b - a);
+    A.row(1) = 2.0 * (c - a);
+    A.row(2) = 2.0 * (d - a);
+    if (std::abs(A.determinant()) <= 1e-30) {
+        // Coplanar points, the smallest ball through three of them containing the fourth
+        Ball balls[4] = { ballFrom(a, b, c), ballFrom(a, b, d), ballFrom(a, c, d), ballFrom(b, c, d) };
+        return *std::max_element(balls, balls + 4, [](const Ball& l, const Ball& r) { return l.radius < r.radius; });
+    }
+    Eigen::Vector3d rhs((b - a).squaredNorm(), (c - a).squaredNorm(), (d - a).squaredNorm());
+    Eigen::Vector3d offset = A.partialPivLu().solve(rhs);
+    return { a + offset, offset.norm() };
+}
+
+Circle minimumEnclosingCircle(std::vector<Eigen::Vector2d> points, double tolerance) {
+    shuffle(points);
+    auto outside = [tolerance](const Circle& c, const Eigen::Vector2d& p) { return (p - c.center).norm() > c.radius + tolerance; };
+    Circle c{ points[0], 0.0 };
+    for (std::size_t i = 1; i < points.size(); i++) {
+        if (!outside(c, points[i])) continue;
+        c = { points[i], 0.0 };
+        for (std::size_t j = 0; j < i; j++) {
+            if (!outside(c, points[j])) continue;
+            c = circleFrom(points[i], points[j]);
+            for (std::size_t k = 0; k < j; k++) {
+                if (outside(c, points[k])) {
+                    c = circleFrom(points[i], points[j], points[k]);
+                }
+            }
+        }
+    }
+    // Guarantee the enclosure against the numerical error
+    for (const auto& p : points) {
+        c.radius = std::max(c.radius, (p - c.center).norm());
+    }
+    return c;
+}
+
+Ball minimumEnclosingBall(std::vector<Eigen::Vector3d> points, double tolerance) {
+    shuffle(points);
+    auto outside = [tolerance](const Ball& b, const Eigen::Vector3d& p) { return (p - b.center).norm() > b.radius + tolerance; };
+    Ball b{ points[0], 0.0 };
+    for (std::size_t i = 1; i < points.size(); i++) {
+        if (!outside(b, points[i])) continue;
+        b = { points[i], 0.0 };
+        for (std::size_t j = 0; j < i; j++) {
+            if (!outside(b, points[j])) continue;
+            b = ballFrom(points[i], points[j]);
+            for (std::size_t k = 0; k < j; k++) {
+                if (!outside(b, points[k])) continue;
+                b = ballFrom(points[i], points[j], points[k]);
+                for (std::size_t l = 0; l < k; l++) {
+                    if (outside(b, points[l])) {
+                        b = ballFrom(points[i], points[j], points[k], points[l]);
+                    }
+                }
+            }
+        }
+    }
+    for (const auto& p : points) {
+        b.radius = std::max(b.radius, (p - b.center).norm());
+    }
+    return b;
+}
+
+/**
+ * @brief Computes the principal axes of the surface of a closed mesh, as a right handed rotation.
+ */
+Eigen::Matrix3d computePrincipalAxes(const TriangleMesh& mesh) {
+    Eigen::Matrix3d second_moment = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d first_moment = Eigen::Vector3d::Zero();
+    double total_area = 0.0;
+    for (const auto& t : mesh.triangles) {
+        const auto& a = mesh.vertices[t[0]];
+        const auto& b = mesh.vertices[t[1]];
+        const auto& c = mesh.vertices[t[2]];
+        double area = (b - a).cross(c - a).norm() / 2.0;
+        Eigen::Vector3d centroid = (a + b + c) / 3.0;
+        total_area += area;
+        first_moment += area * centroid;
+        second_moment += area / 12.0 * (a * a.transpose() + b * b.transpose() + c * c.transpose() + 9.0 * centroid * centroid.transpose());
+    }
+    if (total_area <= 0.0) {
+        return Eigen::Matrix3d::Identity();
+    }
+    Eigen::Vector3d mean = first_moment / total_area;
+    Eigen::Matrix3d covariance = second_moment / total_area - mean * mean.transpose();
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(covariance);
+    Eigen::Matrix3d axes = solver.eigenvectors();
+    if (axes.determinant() < 0.0) {
+        axes.col(2) = -axes.col(2);
+    }
+    return axes;
+}
+
+FittedPrimitive fitBox(const std::vector<Eigen::Vector3d>& points, const Eigen::Matrix3d& frame) {
+    std::vector<Eigen::Vector3d> local;
+    local.reserve(points.size());
+    for (const auto& p : points) {
+        local.push_back(frame.transpose() * p);
+    }
+    auto box = computeBoundingBox(local);
+
+    FittedPrimitive primitive;
+    primitive.shape = PrimitiveShape::Box;
+    primitive.rotation = frame;
+    primitive.position = frame * ((box.min + box.max) / 2.0);
+    primitive.size = box.max - box.min;
+    primitive.volume = primitive.size.prod();
+    return primitive;
+}
+
+/**
+ * @brief Fits a cylinder or a capsule with the axis along the axis-th column of frame.
+ */
+FittedPrimitive fitRound(const std::vector<Eigen::Vector3d>& points, const Eigen::Matrix3d& frame, int axis, PrimitiveShape shape, double tolerance) {
+    // Cyclic permutation of the axes keeps the frame right handed, with z along the chosen axis
+    Eigen::Matrix3d rotation;
+    rotation << frame.col((axis + 1) % 3), frame.col((axis + 2) % 3), frame.col(axis);
+
+    std::vector<Eigen::Vector2d> planar;
+    std::vector<double> heights;
+    planar.reserve(points.size());
+    heights.reserve(points.size());
+    for (const auto& p : points) {
+        Eigen::Vector3d l = rotation.transpose() * p;
+        planar.emplace_back(l.x(), l.y());
+        heights.push_back(l.z());
+    }
+    Circle circle = minimumEnclosingCircle(planar, tolerance);
+
+    double bottom = 0.0;
+    double top = 0.0;
+    if (shape == PrimitiveShape::Cylinder) {
+        bottom = *std::min_element(heights.begin(), heights.end());
+        top = *std::max_element(heights.begin(), heights.end());
+    }
+    else {
+        // Each point must be inside one of the caps: the cylindrical part can be shorter by the height of the cap above the point
+        bottom = std::numeric_limits<double>::max();
+        top = std::numeric_limits<double>::lowest();
+        for (std::size_t i = 0; i < planar.size(); i++) {
+            double r2 = (planar[i] - circle.center).squaredNorm();
+            double cap = std::sqrt(std::max(0.0, circle.radius * circle.radius - r2));
+            bottom = std::min(bottom, heights[i] + cap);
+            top = std::max(top, heights[i] - cap);
+        }
+    }
+
+    FittedPrimitive primitive;
+    primitive.shape = shape;
+    primitive.rotation = rotation;
+    primitive.position = rotation * Eigen::Vector3d(circle.center.x(), circle.center.y(), (bottom + top) / 2.0);
+    primitive.radius = circle.radius;
+    primitive.length = std::max(0.0, top - bottom);
+    primitive.volume = pi * circle.radius * circle.radius * primitive.length;
+    if (shape == PrimitiveShape::Capsule) {
+        primitive.volume += 4.0 / 3.0 * pi * std::pow(circle.radius, 3);
+    }
+    return primitive;
+}
+
+} // namespace
+
+std::vector<FittedPrimitive> fitPrimitives(const TriangleMesh& mesh)
+{
+    std::vector<FittedPrimitive> primitives;
+    // Only the vertices of the hull matter for enclosing primitives
+    TriangleMesh hull = computeConvexHull(mesh.vertices);
+    if (hull.triangles.empty()) {
+        return primitives;
+    }
+    const auto& points = hull.vertices;
+    auto box = computeBoundingBox(points);
+    double tolerance = (box.max - box.min).norm() * 1e-9;
+
+    double hull_volume = computeVolume(hull);
+    double reference_volume = std::abs(computeVolume(mesh));
+    if (reference_volume <= 0.0 || reference_volume > hull_volume * (1.0 + 1e-6)) {
+        // The mesh is not closed
+        reference_volume = hull_volume;
+    }
+
+    const Eigen::Matrix3d frames[2] = { computePrincipalAxes(hull), Eigen::Matrix3d::Identity() };
+    auto smaller = [](const FittedPrimitive& a, const FittedPrimitive& b) { return a.volume < b.volume; };
+
+    FittedPrimitive best_box = std::min(fitBox(points, frames[0]), fitBox(points, frames[1]), smaller);
+    FittedPrimitive best_cylinder;
+    FittedPrimitive best_capsule;
+    best_cylinder.volume = best_capsule.volume = std::numeric_limits<double>::max();
+    for (const auto& frame : frames) {
+        for (int axis = 0; axis < 3; axis++) {
+            best_cylinder = std::min(best_cylinder, fitRound(points, frame, axis, PrimitiveShape::Cylinder, tolerance), smaller);
+            best_capsule = std::min(best_capsule, fitRound(points, frame, axis, PrimitiveShape::Capsule, tolerance), smaller);
+        }
+    }
+
+    Ball ball = minimumEnclosingBall(points, tolerance);
+    FittedPrimitive sphere;
+    sphere.shape = PrimitiveShape::Sphere;
+    sphere.position = ball.center;
+    sphere.radius = ball.radius;
+    sphere.volume = 4.0 / 3.0 * pi * std::pow(ball.radius, 3);
+
+    primitives = { best_box, best_cylinder, sphere, best_capsule };
+    for (auto& primitive : primitives) {
+        primitive.volumeError = (primitive.volume - reference_volume) / reference_volume;
+    }
+    return primitives;
+}
+
+bool fitBestPrimitive(const TriangleMesh& mesh, const std::vector<PrimitiveShape>& shapes, FittedPrimitive& best)
+{
+    bool found = false;
+    for (const auto& primitive : fitPrimitives(mesh)) {
+        if (std::find(shapes.begin(), shapes.end(), primitive.shape) == shapes.end()) {
+            continue;
+        }
+        if (!found || primitive.volumeError < best.volumeError) {
+            best = primitive;
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool computeEnclosingSphere(const std::vector<Eigen::Vector3d>& points, Eigen::Vector3d& center, double& radius)
+{
+    if (points.empty()) {
+        return false;
+    }
+    auto box = computeBoundingBox(points);
+    Ball ball = minimumEnclosingBall(points, (box.max - box.min).norm() * 1e-9);
+    center = ball.center;
+    radius = ball.radius;
+    return true;
+}
@@ -0,0 +1,273 @@
+/**
+ * @file SignedDistanceField.cpp
+ * @brief Contains definitions for the narrow band signed distance field of a mesh.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/SignedDistanceField.h>
+#include <creo2urdf/mesh/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+constexpr char sdf_magic[8] = { 'C', '2', 'U', 'S', 'D', 'F', 0, 0 };
+constexpr std::uint32_t sdf_version = 1;
+constexpr std::size_t sdf_header_size = 64;
+
+/**
+ * @brief Squared distance between a point and a triangle, from Ericson, Real-Time Collision Detection, 5.1.5.
+ */
+double squaredDistancePointTriangle(const Eigen::Vector3d& p, const Eigen::Vector3d& a, const Eigen::Vector3d& b, const Eigen::Vector3d& c) {
+    Eigen::Vector3d ab = b - a;
+    Eigen::Vector3d ac = c - a;
+    Eigen::Vector3d ap = p - a;
+    double d1 = ab.dot(ap);
+    double d2 = ac.dot(ap);
+    if (d1 <= 0.0 && d2 <= 0.0) return ap.squaredNorm();
+
+    Eigen::Vector3d bp = p - b;
+    double d3 = ab.dot(bp);
+    double d4 = ac.dot(bp);
+    if (d3 >= 0.0 && d4 <= d3) return bp.squaredNorm();
+
+    double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+        double v = d1 / (d1 - d3);
+        return (ap - v * ab).squaredNorm();
+    }
+
+    Eigen::Vector3d cp = p - c;
+    double d5 = ab.dot(cp);
+    double d6 = ac.dot(cp);
+    if (d6 >= 0.0 && d5 <= d6) return cp.squaredNorm();
+
+    double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+        double w = d2 / (d2 - d6);
+        return (ap - w * ac).squaredNorm();
+    }
+
+    double va = d3 * d6 - d5 * d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+        double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return (bp - w * (c - b)).squaredNorm();
+    }
+
+    double denom = 1.0 / (va + vb + vc);
+    double v = vb * denom;
+    double w = vc * denom;
+    return (ap - ab * v - ac * w).squaredNorm();
+}
+
+/**
+ * @brief Orientation of the 2D segment from the origin, with consistent tie breaking so that a ray
+ * crossing an edge or a vertex shared by several triangles is counted exactly once.
+ */
+int orientation(double x1, double y1, double x2, double y2, double& twice_signed_area) {
+    twice_signed_area = y1 * x2 - x1 * y2;
+    if (twice_signed_area > 0) return 1;
+    if (twice_signed_area < 0) return -1;
+    if (y2 > y1) return 1;
+    if (y2 < y1) return -1;
+    if (x1 > x2) return 1;
+    if (x1 < x2) return -1;
+    return 0;
+}
+
+/**
+ * @brief Tests whether the 2D point (y0, z0) is inside the projection of a triangle, returning its barycentric coordinates.
+ */
+bool pointInTriangle2D(double y0, double z0, const Eigen::Vector3d& p1, const Eigen::Vector3d& p2, const Eigen::Vector3d& p3, double& a, double& b, double& c) {
+    double y1 = p1.y() - y0, z1 = p1.z() - z0;
+    double y2 = p2.y() - y0, z2 = p2.z() - z0;
+    double y3 = p3.y() - y0, z3 = p3.z() - z0;
+    int sign_a = orientation(y2, z2, y3, z3, a);
+    if (sign_a == 0) return false;
+    int sign_b = orientation(y3, z3, y1, z1, b);
+    if (sign_b != sign_a) return false;
+    int sign_c = orientation(y1, z1, y2, z2, c);
+    if (sign_c != sign_a) return false;
+    double sum = a + b + c;
+    if (sum == 0.0) return false;
+    a /= sum;
+    b /= sum;
+    c /= sum;
+    return true;
+}
+
+template <class T>
+void writeValue(std::vector<char>& buffer, std::size_t offset, const T& value) {
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template <class T>
+T readValue(const std::vector<char>& buffer, std::size_t offset) {
+    T value;
+    std::memcpy(&value, buffer.data() + offset, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+bool computeSignedDistanceField(const TriangleMesh& mesh, const SignedDistanceFieldParameters& parameters, SignedDistanceField& field, unsigned n_threads)
+{
+    field = SignedDistanceField();
+    if (mesh.triangles.empty() || parameters.resolution <= 0.0) {
+        return false;
+    }
+
+    auto box = computeBoundingBox(mesh.vertices);
+    field.resolution = parameters.resolution;
+    field.narrowBand = static_cast<float>(parameters.narrowBand);
+    field.origin = box.min - Eigen::Vector3d::Constant(parameters.padding);
+    Eigen::Vector3d extent = box.max - box.min + Eigen::Vector3d::Constant(2.0 * parameters.padding);
+    std::size_t n_samples = 1;
+    for (int d = 0; d < 3; d++) {
+        field.size[d] = static_cast<std::uint32_t>(std::ceil(extent[d] / field.resolution)) + 1;
+        n_samples *= field.size[d];
+    }
+    if (n_samples > parameters.maxSamples) {
+        return false;
+    }
+    const std::size_t nx = field.size[0];
+    const std::size_t ny = field.size[1];
+    const std::size_t nz = field.size[2];
+    field.values.assign(n_samples, field.narrowBand);
+
+    // Grid range touched by each triangle, used to bucket the triangles by slice
+    auto toIndex = [&](double value, int d) {
+        long i = static_cast<long>(std::floor((value - field.origin[d]) / field.resolution));
+        return static_cast<std::size_t>(std::min<long>(std::max<long>(i, 0), static_cast<long>(field.size[d]) - 1));
+    };
+    std::vector<std::vector<std::uint32_t>> band_slices(nz);
+    std::vector<std::vector<std::uint32_t>> ray_slices(nz);
+    for (std::uint32_t t = 0; t < mesh.triangles.size(); t++) {
+        const auto& tri = mesh.triangles[t];
+        BoundingBox tri_box = computeBoundingBox({ mesh.vertices[tri[0]], mesh.vertices[tri[1]], mesh.vertices[tri[2]] });
+        std::size_t k_min = toIndex(tri_box.min.z() - parameters.narrowBand, 2);
+        std::size_t k_max = std::min(nz - 1, toIndex(tri_box.max.z() + parameters.narrowBand, 2) + 1);
+        for (std::size_t k = k_min; k <= k_max; k++) {
+            band_slices[k].push_back(t);
+        }
+        k_min = toIndex(tri_box.min.z(), 2);
+        k_max = std::min(nz - 1, toIndex(tri_box.max.z(), 2) + 1);
+        for (std::size_t k = k_min; k <= k_max; k++) {
+            ray_slices[k].push_back(t);
+        }
+    }
+
+    // Each slice is written by a single task, so the result does not depend on the scheduling
+    parallelFor(nz, [&](std::size_t k) {
+        float* slice = field.values.data() + k * nx * ny;
+        double z = field.origin.z() + k * field.resolution;
+
+        // Unsigned distance within the narrow band of each triangle
+        for (auto t : band_slices[k]) {
+            const auto& a = mesh.vertices[mesh.triangles[t][0]];
+            const auto& b = mesh.vertices[mesh.triangles[t][1]];
+            const auto& c = mesh.vertices[mesh.triangles[t][2]];
+            BoundingBox tri_box = computeBoundingBox({ a, b, c });
+            std::size_t i_min = toIndex(tri_box.min.x() - parameters.narrowBand, 0);
+            std::size_t i_max = std::min(nx - 1, toIndex(tri_box.max.x() + parameters.narrowBand, 0) + 1);
+            std::size_t j_min = toIndex(tri_box.min.y() - parameters.narrowBand, 1);
+            std::size_t j_max = std::min(ny - 1, toIndex(tri_box.max.y() + parameters.narrowBand, 1) + 1);
+            for (std::size_t j = j_min; j <= j_max; j++) {
+                for (std::size_t i = i_min; i <= i_max; i++) {
+                    Eigen::Vector3d p(field.origin.x() + i * field.resolution, field.origin.y() + j * field.resolution, z);
+                    float distance = static_cast<float>(std::sqrt(squaredDistancePointTriangle(p, a, b, c)));
+                    float& value = slice[i + nx * j];
+                    value = std::min(value, distance);
+                }
+            }
+        }
+
+        // Sign from the parity of the crossings of the ray along x through each row
+        std::vector<std::vector<std::uint32_t>> ray_rows(ny);
+        for (auto t : ray_slices[k]) {
+            const auto& tri = mesh.triangles[t];
+            double y_min = std::min({ mesh.vertices[tri[0]].y(), mesh.vertices[tri[1]].y(), mesh.vertices[tri[2]].y() });
+            double y_max = std::max({ mesh.vertices[tri[0]].y(), mesh.vertices[tri[1]].y(), mesh.vertices[tri[2]].y() });
+            std::size_t j_max = std::min(ny - 1, toIndex(y_max, 1) + 1);
+            for (std::size_t j = toIndex(y_min, 1); j <= j_max; j++) {
+                ray_rows[j].push_back(t);
+            }
+        }
+        std::vector<double> crossings;
+        for (std::size_t j = 0; j < ny; j++) {
+            double y = field.origin.y() + j * field.resolution;
+            crossings.clear();
+            for (auto t : ray_rows[j]) {
+                const auto& p1 = mesh.vertices[mesh.triangles[t][0]];
+                const auto& p2 = mesh.vertices[mesh.triangles[t][1]];
+                const auto& p3 = mesh.vertices[mesh.triangles[t][2]];
+                double a, b, c;
+                if (pointInTriangle2D(y, z, p1, p2, p3, a, b, c)) {
+                    crossings.push_back(a * p1.x() + b * p2.x() + c * p3.x());
+                }
+            }
+            std::sort(crossings.begin(), crossings.end());
+            std::size_t n_crossed = 0;
+            for (std::size_t i = 0; i < nx; i++) {
+                double x = field.origin.x() + i * field.resolution;
+                while (n_crossed < crossings.size() && crossings[n_crossed] < x) {
+                    n_crossed++;
+                }
+                if (n_crossed % 2 == 1) {
+                    slice[i + nx * j] = -slice[i + nx * j];
+                }
+            }
+        }
+    }, n_threads);
+
+    return true;
+}
+
+bool writeSignedDistanceField(const std::string& filename, const SignedDistanceField& field)
+{
+    std::ofstream output(filename, std::ios::out | std::ios::binary);
+    if (!output.is_open()) {
+        return false;
+    }
+    std::vector<char> header(sdf_header_size, 0);
+    std::memcpy(header.data(), sdf_magic, sizeof(sdf_magic));
+    writeValue(header, 8, sdf_version);
+    writeValue(header, 12, field.size[0]);
+    writeValue(header, 16, field.size[1]);
+    writeValue(header, 20, field.size[2]);
+    writeValue(header, 24, field.origin.x());
+    writeValue(header, 32, field.origin.y());
+    writeValue(header, 40, field.origin.z());
+    writeValue(header, 48, field.resolution);
+    writeValue(header, 56, field.narrowBand);
+    output.write(header.data(), header.size());
+    output.write(reinterpret_cast<const char*>(field.values.data()), field.values.size() * sizeof(float));
+    return static_cast<bool>(output);
+}
+
+bool readSignedDistanceField(const std::string& filename, SignedDistanceField& field)
+{
+    field = SignedDistanceField();
+    std::ifstream input(filename, std::ios::in | std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    std::vector<char> header(sdf_header_size, 0);
+    if (!input.read(header.data(), header.size()) || std::memcmp(header.data(), sdf_magic, sizeof(sdf_magic)) != 0 ||
+        readValue<std::uint32_t>(header, 8) != sdf_version) {
+        return false;
+    }
+    field.size = { readValue<std::uint32_t>(header, 12), readValue<std::uint32_t>(header, 16), readValue<std::uint32_t>(header, 20) };
+    field.origin = Eigen::Vector3d(readValue<double>(header, 24), readValue<double>(header, 32), readValue<double>(header, 40));
+    field.resolution = readValue<double>(header, 48);
+    field.narrowBand = readValue<float>(header, 56);
+    field.values.resize(static_cast<std::size_t>(field.size[0]) * field.size[1] * field.size[2]);
+    return static_cast<bool>(input.read(reinterpret_cast<char*>(field.values.data()), field.values.size() * sizeof(float)));
+}
@@ -0,0 +1,175 @@
+/**
+ * @file SphereTree.cpp
+ * @brief Contains definitions for the hierarchical sphere approximation of a mesh.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/SphereTree.h>
+#include <creo2urdf/mesh/PrimitiveFitting.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr int n_sample_directions = 64;
+
+/**
+ * @brief Directions evenly distributed on the unit sphere, along a Fibonacci spiral.
+ */
+const std::vector<Eigen::Vector3d> sample_directions = [] {
+    std::vector<Eigen::Vector3d> directions;
+    const double golden_angle = 3.14159265358979323846 * (3.0 - std::sqrt(5.0));
+    for (int i = 0; i < n_sample_directions; i++) {
+        double z = 1.0 - (2.0 * i + 1.0) / n_sample_directions;
+        double r = std::sqrt(1.0 - z * z);
+        directions.emplace_back(r * std::cos(golden_angle * i), r * std::sin(golden_angle * i), z);
+    }
+    return directions;
+}();
+
+/**
+ * @brief Computes the sphere enclosing a patch of triangles. Enclosing their vertices is enough, since the sphere is convex.
+ */
+SphereTreeNode computePatchSphere(const TriangleMesh& mesh, const std::vector<std::uint32_t>& patch) {
+    std::vector<std::uint32_t> indices;
+    indices.reserve(patch.size() * 3);
+    for (auto t : patch) {
+        indices.insert(indices.end(), mesh.triangles[t].begin(), mesh.triangles[t].end());
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    std::vector<Eigen::Vector3d> points;
+    points.reserve(indices.size());
+    for (auto i : indices) {
+        points.push_back(mesh.vertices[i]);
+    }
+
+    SphereTreeNode node;
+    computeEnclosingSphere(points, node.center, node.radius);
+
+    // The over-approximation is the largest distance between the outer side of the sphere and the patch,
+    // sampled along fixed directions and measured to the closest vertex
+    Eigen::Vector3d normal = Eigen::Vector3d::Zero();
+    double total_area = 0.0;
+    for (auto t : patch) {
+        const auto& tri = mesh.triangles[t];
+        Eigen::Vector3d n = (mesh.vertices[tri[1]] - mesh.vertices[tri[0]]).cross(mesh.vertices[tri[2]] - mesh.vertices[tri[0]]);
+        normal += n;
+        total_area += n.norm();
+    }
+    // If the patch is closed, or folded on itself, the sphere may protrude on every side
+    bool oriented = normal.norm() > 1e-3 * total_area;
+    normal.normalize();
+
+    node.overApproximation = 0.0;
+    for (const auto& direction : sample_directions) {
+        if (oriented && direction.dot(normal) < 0.0) {
+            continue;
+        }
+        Eigen::Vector3d sample = node.center + node.radius * direction;
+        double closest = std::numeric_limits<double>::max();
+        for (const auto& p : points) {
+            closest = std::min(closest, (p - sample).squaredNorm());
+        }
+        node.overApproximation = std::max(node.overApproximation, std::sqrt(closest));
+    }
+    return node;
+}
+
+/**
+ * @brief Splits a patch at the median of the centroids of its triangles along their longest axis.
+ */
+void splitPatch(const std::vector<Eigen::Vector3d>& centroids, std::vector<std::uint32_t>& patch, std::vector<std::uint32_t>& second) {
+    std::vector<Eigen::Vector3d> points;
+    points.reserve(patch.size());
+    for (auto t : patch) {
+        points.push_back(centroids[t]);
+    }
+    auto box = computeBoundingBox(points);
+    int axis = 0;
+    (box.max - box.min).maxCoeff(&axis);
+
+    // Ties are broken by index, so that the split does not depend on the implementation of nth_element
+    auto middle = patch.begin() + patch.size() / 2;
+    std::nth_element(patch.begin(), middle, patch.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return centroids[a][axis] < centroids[b][axis] || (centroids[a][axis] == centroids[b][axis] && a < b);
+    });
+    second.assign(middle, patch.end());
+    patch.erase(middle, patch.end());
+}
+
+} // namespace
+
+SphereTree computeSphereTree(const TriangleMesh& mesh, const SphereTreeParameters& parameters)
+{
+    SphereTree tree;
+    if (mesh.triangles.empty()) {
+        return tree;
+    }
+
+    std::vector<Eigen::Vector3d> centroids;
+    centroids.reserve(mesh.triangles.size());
+    for (const auto& t : mesh.triangles) {
+        centroids.push_back((mesh.vertices[t[0]] + mesh.vertices[t[1]] + mesh.vertices[t[2]]) / 3.0);
+    }
+
+    // Triangles of the patch enclosed by each node, released once the node is split
+    std::vector<std::vector<std::uint32_t>> patches(1);
+    patches[0].resize(mesh.triangles.size());
+    for (std::uint32_t t = 0; t < mesh.triangles.size(); t++) {
+        patches[0][t] = t;
+    }
+    tree.nodes.push_back(computePatchSphere(mesh, patches[0]));
+
+    std::size_t n_leaves = 1;
+    while (n_leaves < parameters.maxSpheres) {
+        // The leaf with the largest over-approximation is split first, ties go to the oldest node
+        std::int32_t worst = -1;
+        for (std::size_t i = 0; i < tree.nodes.size(); i++) {
+            const auto& node = tree.nodes[i];
+            if (node.nChildren > 0 || patches[i].size() < 2 || node.overApproximation <= parameters.maxOverApproximation) {
+                continue;
+            }
+            if (worst < 0 || node.overApproximation > tree.nodes[worst].overApproximation) {
+                worst = static_cast<std::int32_t>(i);
+            }
+        }
+        if (worst < 0) {
+            break;
+        }
+
+        std::vector<std::uint32_t> first = std::move(patches[worst]);
+        std::vector<std::uint32_t> second;
+        splitPatch(centroids, first, second);
+        patches[worst].clear();
+
+        tree.nodes[worst].firstChild = static_cast<std::int32_t>(tree.nodes.size());
+        tree.nodes[worst].nChildren = 2;
+        for (auto* patch : { &first, &second }) {
+            SphereTreeNode child = computePatchSphere(mesh, *patch);
+            child.parent = worst;
+            tree.nodes.push_back(child);
+            patches.push_back(std::move(*patch));
+        }
+        n_leaves++;
+    }
+    return tree;
+}
+
+std::vector<SphereTreeNode> getSphereTreeLeaves(const SphereTree& tree)
+{
+    std::vector<SphereTreeNode> leaves;
+    for (const auto& node : tree.nodes) {
+        if (node.nChildren == 0) {
+            leaves.push_back(node);
+        }
+    }
+    return leaves;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file TransformBatch.cpp
+ * @brief Contains the definitions of the kernels on batches of transforms and inertias.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/TransformBatch.h>
+
+namespace {
+
+using Column = Eigen::Map<Eigen::ArrayXd>;
+using ConstColumn = Eigen::Map<const Eigen::ArrayXd>;
+
+Column column(std::vector<double>& values) {
+    return Column(values.data(), static_cast<Eigen::Index>(values.size()));
+}
+
+ConstColumn column(const std::vector<double>& values) {
+    return ConstColumn(values.data(), static_cast<Eigen::Index>(values.size()));
+}
+
+/**
+ * @brief Gathers the elements of a batch, so that the following passes read contiguous arrays.
+ */
+Eigen::ArrayXd gather(const std::vector<double>& values, const std::vector<std::uint32_t>& index) {
+    Eigen::ArrayXd gathered(static_cast<Eigen::Index>(index.size()));
+    for (std::size_t k = 0; k < index.size(); k++) {
+        gathered[static_cast<Eigen::Index>(k)] = values[index[k]];
+    }
+    return gathered;
+}
+
+/**
+ * @brief Position of the element (row, col) of a symmetric tensor in InertiaBatch::tensor.
+ */
+constexpr int tensor_element[3][3] = { { 0, 3, 4 }, { 3, 1, 5 }, { 4, 5, 2 } };
+
+} // namespace
+
+void TransformBatch::resize(std::size_t n)
+{
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            rotation[3 * r + c].resize(n, r == c ? 1.0 : 0.0);
+        }
+        position[r].resize(n, 0.0);
+    }
+}
+
+std::size_t TransformBatch::append(const Eigen::Matrix3d& R, const Eigen::Vector3d& p)
+{
+    std::size_t i = size();
+    resize(i + 1);
+    set(i, R, p);
+    return i;
+}
+
+void TransformBatch::set(std::size_t i, const Eigen::Matrix3d& R, const Eigen::Vector3d& p)
+{
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            rotation[3 * r + c][i] = R(r, c);
+        }
+        position[r][i] = p[r];
+    }
+}
+
+Eigen::Matrix3d TransformBatch::getRotation(std::size_t i) const
+{
+    Eigen::Matrix3d R;
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            R(r, c) = rotation[3 * r + c][i];
+        }
+    }
+    return R;
+}
+
+Eigen::Vector3d TransformBatch::getPosition(std::size_t i) const
+{
+    return Eigen::Vector3d(position[0][i], position[1][i], position[2][i]);
+}
+
+std::size_t InertiaBatch::append(double m, const Eigen::Vector3d& com, const Eigen::Matrix3d& inertia)
+{
+    std::size_t i = size();
+    mass.push_back(m);
+    for (int r = 0; r < 3; r++) {
+        centerOfMass[r].push_back(com[r]);
+        for (int c = r; c < 3; c++) {
+            tensor[tensor_element[r][c]].push_back(inertia(r, c));
+        }
+    }
+    return i;
+}
+
+Eigen::Vector3d InertiaBatch::getCenterOfMass(std::size_t i) const
+{
+    return Eigen::Vector3d(centerOfMass[0][i], centerOfMass[1][i], centerOfMass[2][i]);
+}
+
+Eigen::Matrix3d InertiaBatch::getTensor(std::size_t i) const
+{
+    Eigen::Matrix3d inertia;
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            inertia(r, c) = tensor[tensor_element[r][c]][i];
+        }
+    }
+    return inertia;
+}
+
+void invertTransforms(const TransformBatch& a_H_b, TransformBatch& b_H_a)
+{
+    b_H_a.resize(a_H_b.size());
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            b_H_a.rotation[3 * r + c] = a_H_b.rotation[3 * c + r];
+        }
+    }
+    // b_p_a = -a_R_b^T * a_p_b
+    for (int r = 0; r < 3; r++) {
+        column(b_H_a.position[r]) = -(column(a_H_b.rotation[r]) * column(a_H_b.position[0]) +
+                                      column(a_H_b.rotation[3 + r]) * column(a_H_b.position[1]) +
+                                      column(a_H_b.rotation[6 + r]) * column(a_H_b.position[2]));
+    }
+}
+
+void composeTransforms(const TransformBatch& a_H_b, const std::vector<std::uint32_t>& lhs_index,
+                       const TransformBatch& b_H_c, const std::vector<std::uint32_t>& rhs_index,
+                       TransformBatch& a_H_c)
+{
+    std::array<Eigen::ArrayXd, 9> lhs_rotation, rhs_rotation;
+    std::array<Eigen::ArrayXd, 3> lhs_position, rhs_position;
+    for (int e = 0; e < 9; e++) {
+        lhs_rotation[e] = gather(a_H_b.rotation[e], lhs_index);
+        rhs_rotation[e] = gather(b_H_c.rotation[e], rhs_index);
+    }
+    for (int r = 0; r < 3; r++) {
+        lhs_position[r] = gather(a_H_b.position[r], lhs_index);
+        rhs_position[r] = gather(b_H_c.position[r], rhs_index);
+    }
+
+    a_H_c.resize(lhs_index.size());
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            column(a_H_c.rotation[3 * r + c]) = lhs_rotation[3 * r] * rhs_rotation[c] +
+                                                lhs_rotation[3 * r + 1] * rhs_rotation[3 + c] +
+                                                lhs_rotation[3 * r + 2] * rhs_rotation[6 + c];
+        }
+        column(a_H_c.position[r]) = lhs_rotation[3 * r] * rhs_position[0] +
+                                    lhs_rotation[3 * r + 1] * rhs_position[1] +
+                                    lhs_rotation[3 * r + 2] * rhs_position[2] + lhs_position[r];
+    }
+}
+
+void transformInertias(const TransformBatch& b_H_a, InertiaBatch& inertias)
+{
+    std::array<Eigen::ArrayXd, 3> com;
+    for (int r = 0; r < 3; r++) {
+        com[r] = column(inertias.centerOfMass[r]);
+    }
+    for (int r = 0; r < 3; r++) {
+        column(inertias.centerOfMass[r]) = column(b_H_a.rotation[3 * r]) * com[0] +
+                                           column(b_H_a.rotation[3 * r + 1]) * com[1] +
+                                           column(b_H_a.rotation[3 * r + 2]) * com[2] + column(b_H_a.position[r]);
+    }
+
+    // R * I, then (R * I) * R^T keeping the upper triangle
+    std::array<Eigen::ArrayXd, 9> RI;
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            RI[3 * r + c] = column(b_H_a.rotation[3 * r]) * column(inertias.tensor[tensor_element[0][c]]) +
+                            column(b_H_a.rotation[3 * r + 1]) * column(inertias.tensor[tensor_element[1][c]]) +
+                            column(b_H_a.rotation[3 * r + 2]) * column(inertias.tensor[tensor_element[2][c]]);
+        }
+    }
+    for (int r = 0; r < 3; r++) {
+        for (int c = r; c < 3; c++) {
+            column(inertias.tensor[tensor_element[r][c]]) = RI[3 * r] * column(b_H_a.rotation[3 * c]) +
+                                                            RI[3 * r + 1] * column(b_H_a.rotation[3 * c + 1]) +
+                                                            RI[3 * r + 2] * column(b_H_a.rotation[3 * c + 2]);
+        }
+    }
+}
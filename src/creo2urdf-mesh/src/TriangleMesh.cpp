@@ -0,0 +1,239 @@
+/**
+ * @file TriangleMesh.cpp
+ * @brief Contains definitions for the indexed triangle mesh I/O functions.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/TriangleMesh.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * @brief Key used to merge the vertices of a STL file, that are stored as single precision floats.
+ */
+struct VertexKey {
+    std::uint32_t x, y, z;
+    bool operator==(const VertexKey& other) const { return x == other.x && y == other.y && z == other.z; }
+};
+
+struct VertexKeyHash {
+    std::size_t operator()(const VertexKey& k) const {
+        return static_cast<std::size_t>(hashBytes(&k, sizeof(k)));
+    }
+};
+
+/**
+ * @brief Helper that merges the vertices with identical coordinates while building a mesh.
+ */
+class VertexWelder {
+public:
+    explicit VertexWelder(TriangleMesh& mesh) : m_mesh(mesh) {}
+
+    std::uint32_t add(float x, float y, float z) {
+        VertexKey key;
+        std::memcpy(&key.x, &x, sizeof(float));
+        std::memcpy(&key.y, &y, sizeof(float));
+        std::memcpy(&key.z, &z, sizeof(float));
+        auto it = m_indices.find(key);
+        if (it != m_indices.end()) {
+            return it->second;
+        }
+        auto index = static_cast<std::uint32_t>(m_mesh.vertices.size());
+        m_mesh.vertices.emplace_back(x, y, z);
+        m_indices.emplace(key, index);
+        return index;
+    }
+
+    void reserve(std::size_t n_vertices) { m_indices.reserve(n_vertices); }
+
+private:
+    TriangleMesh& m_mesh;
+    std::unordered_map<VertexKey, std::uint32_t, VertexKeyHash> m_indices;
+};
+
+void addTriangle(TriangleMesh& mesh, const std::array<std::uint32_t, 3>& t) {
+    // Degenerate triangles carry no geometry and break the adjacency of the later stages
+    if (t[0] == t[1] || t[1] == t[2] || t[0] == t[2]) {
+        return;
+    }
+    mesh.triangles.push_back(t);
+}
+
+bool readBinarySTL(const std::vector<char>& buffer, TriangleMesh& mesh) {
+    std::uint32_t n_triangles = 0;
+    std::memcpy(&n_triangles, buffer.data() + 80, sizeof(n_triangles));
+
+    VertexWelder welder(mesh);
+    welder.reserve(n_triangles / 2);
+    mesh.triangles.reserve(n_triangles);
+
+    const char* record = buffer.data() + 84;
+    for (std::uint32_t i = 0; i < n_triangles; i++, record += 50) {
+        float v[9];
+        // The first 12 bytes are the facet normal, which is recomputed from the vertices when needed
+        std::memcpy(v, record + 12, sizeof(v));
+        addTriangle(mesh, { welder.add(v[0], v[1], v[2]), welder.add(v[3], v[4], v[5]), welder.add(v[6], v[7], v[8]) });
+    }
+    return true;
+}
+
+bool readASCIISTL(const std::vector<char>& buffer, TriangleMesh& mesh) {
+    std::istringstream input(std::string(buffer.begin(), buffer.end()));
+    VertexWelder welder(mesh);
+    std::array<std::uint32_t, 3> triangle;
+    int n_vertices = 0;
+    std::string token;
+    while (input >> token) {
+        if (token == "vertex") {
+            float x, y, z;
+            if (!(input >> x >> y >> z) || n_vertices > 2) {
+                return false;
+            }
+            triangle[n_vertices++] = welder.add(x, y, z);
+        }
+        else if (token == "endfacet") {
+            if (n_vertices != 3) {
+                return false;
+            }
+            addTriangle(mesh, triangle);
+            n_vertices = 0;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool readSTL(const std::string& filename, TriangleMesh& mesh) {
+    mesh = TriangleMesh();
+    std::ifstream input(filename, std::ios::in | std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    std::vector<char> buffer((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    if (buffer.size() >= 84) {
+        std::uint32_t n_triangles = 0;
+        std::memcpy(&n_triangles, buffer.data() + 80, sizeof(n_triangles));
+        if (buffer.size() == 84 + 50 * static_cast<std::size_t>(n_triangles)) {
+            return readBinarySTL(buffer, mesh);
+        }
+    }
+    return readASCIISTL(buffer, mesh);
+}
+
+bool writeBinarySTL(const std::string& filename, const TriangleMesh& mesh) {
+    std::ofstream output(filename, std::ios::out | std::ios::binary);
+    if (!output.is_open()) {
+        return false;
+    }
+
+    // Same header written by sanitizeSTL, to avoid parsing the file as ASCII
+    char header[80] = "robot";
+    output.write(header, sizeof(header));
+    auto n_triangles = static_cast<std::uint32_t>(mesh.triangles.size());
+    output.write(reinterpret_cast<const char*>(&n_triangles), sizeof(n_triangles));
+
+    auto normals = computeTriangleNormals(mesh);
+    std::vector<char> records(50 * mesh.triangles.size(), 0);
+    char* record = records.data();
+    for (std::size_t i = 0; i < mesh.triangles.size(); i++) {
+        const auto& t = mesh.triangles[i];
+        const auto& a = mesh.vertices[t[0]];
+        const auto& b = mesh.vertices[t[1]];
+        const auto& c = mesh.vertices[t[2]];
+        const auto& n = normals[i];
+        float values[12] = { float(n.x()), float(n.y()), float(n.z()),
+                             float(a.x()), float(a.y()), float(a.z()),
+                             float(b.x()), float(b.y()), float(b.z()),
+                             float(c.x()), float(c.y()), float(c.z()) };
+        std::memcpy(record, values, sizeof(values));
+        record += 50;
+    }
+    output.write(records.data(), records.size());
+    return static_cast<bool>(output);
+}
+
+std::vector<Eigen::Vector3d> computeTriangleNormals(const TriangleMesh& mesh) {
+    std::vector<Eigen::Vector3d> normals(mesh.triangles.size());
+    for (std::size_t i = 0; i < mesh.triangles.size(); i++) {
+        const auto& t = mesh.triangles[i];
+        normals[i] = (mesh.vertices[t[1]] - mesh.vertices[t[0]]).cross(mesh.vertices[t[2]] - mesh.vertices[t[0]]);
+        double norm = normals[i].norm();
+        if (norm > 0.0) {
+            normals[i] /= norm;
+        }
+    }
+    return normals;
+}
+
+TriangleMesh weldTriangles(const std::vector<Eigen::Vector3d>& corners) {
+    TriangleMesh mesh;
+    VertexWelder welder(mesh);
+    welder.reserve(corners.size() / 6);
+    mesh.triangles.reserve(corners.size() / 3);
+    for (std::size_t i = 0; i + 2 < corners.size(); i += 3) {
+        std::array<Eigen::Vector3f, 3> c{ corners[i].cast<float>(), corners[i + 1].cast<float>(), corners[i + 2].cast<float>() };
+        // The degenerate triangles are dropped before welding, otherwise their vertices would stay in the mesh unreferenced
+        if (c[0] == c[1] || c[1] == c[2] || c[0] == c[2]) {
+            continue;
+        }
+        addTriangle(mesh, { welder.add(c[0].x(), c[0].y(), c[0].z()), welder.add(c[1].x(), c[1].y(), c[1].z()), welder.add(c[2].x(), c[2].y(), c[2].z()) });
+    }
+    return mesh;
+}
+
+BoundingBox computeBoundingBox(const std::vector<Eigen::Vector3d>& vertices) {
+    BoundingBox box;
+    if (vertices.empty()) {
+        return box;
+    }
+    box.min = box.max = vertices.front();
+    for (const auto& v : vertices) {
+        box.min = box.min.cwiseMin(v);
+        box.max = box.max.cwiseMax(v);
+    }
+    return box;
+}
+
+double computeVolume(const TriangleMesh& mesh) {
+    double volume = 0.0;
+    for (const auto& t : mesh.triangles) {
+        volume += mesh.vertices[t[0]].dot(mesh.vertices[t[1]].cross(mesh.vertices[t[2]]));
+    }
+    return volume / 6.0;
+}
+
+std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t seed) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = seed;
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::uint64_t hashMesh(const TriangleMesh& mesh) {
+    std::uint64_t hash = hashBytes(mesh.vertices.data(), mesh.vertices.size() * sizeof(Eigen::Vector3d));
+    return hashBytes(mesh.triangles.data(), mesh.triangles.size() * sizeof(mesh.triangles.front()), hash);
+}
+
+std::string hashToString(std::uint64_t hash) {
+    static const char digits[] = "0123456789abcdef";
+    std::string result(16, '0');
+    for (int i = 15; i >= 0; i--, hash >>= 4) {
+        result[i] = digits[hash & 0xf];
+    }
+    return result;
+}
@@ -0,0 +1,643 @@
+/**
+ * @file MeshTests.cpp
+ * @brief Contains the behavior checks of the mesh processing kernels on meshes with known analytic properties.
+ *
+ * Usage: creo2urdf-mesh-tests <test>
+ *
+ * Each test is registered in CTest with its name, and the executable returns a nonzero code if any check fails.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/mesh/CollisionDetection.h>
+#include <creo2urdf/mesh/ConvexDecomposition.h>
+#include <creo2urdf/mesh/ConvexHull.h>
+#include <creo2urdf/mesh/MassProperties.h>
+#include <creo2urdf/mesh/MeshSymmetry.h>
+#include <creo2urdf/mesh/PrimitiveFitting.h>
+#include <creo2urdf/mesh/SignedDistanceField.h>
+#include <creo2urdf/mesh/SphereTree.h>
+#include <creo2urdf/mesh/TransformBatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <utility>
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+/**
+ * @brief Number of checks that failed in the current test.
+ */
+int failures = 0;
+
+#define CHECK(condition)                                                                      \
+    do {                                                                                      \
+        if (!(condition)) {                                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            failures++;                                                                       \
+        }                                                                                     \
+    } while (false)
+
+#define CHECK_NEAR(value, expected, tolerance)                                                \
+    do {                                                                                      \
+        const double v = (value), e = (expected);                                             \
+        if (!(std::abs(v - e) <= (tolerance))) {                                              \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #value " = " << v  \
+                      << ", expected " << e << std::endl;                                     \
+            failures++;                                                                       \
+        }                                                                                     \
+    } while (false)
+
+/**
+ * @brief Builds the closed mesh of an axis aligned box, 8 vertices and 12 triangles.
+ */
+TriangleMesh boxMesh(const Eigen::Vector3d& min, const Eigen::Vector3d& max)
+{
+    TriangleMesh mesh;
+    for (int i = 0; i < 8; i++) {
+        mesh.vertices.emplace_back(i & 1 ? max.x() : min.x(), i & 2 ? max.y() : min.y(), i & 4 ? max.z() : min.z());
+    }
+    mesh.triangles = { { 0, 2, 3 }, { 0, 3, 1 }, { 4, 5, 7 }, { 4, 7, 6 },
+                       { 0, 1, 5 }, { 0, 5, 4 }, { 2, 6, 7 }, { 2, 7, 3 },
+                       { 0, 4, 6 }, { 0, 6, 2 }, { 1, 3, 7 }, { 1, 7, 5 } };
+    return mesh;
+}
+
+/**
+ * @brief Builds the closed mesh of a UV sphere centered in the origin.
+ */
+TriangleMesh sphereMesh(double radius, std::uint32_t n_rings, std::uint32_t n_sectors)
+{
+    TriangleMesh mesh;
+    mesh.vertices.emplace_back(0.0, 0.0, radius);
+    for (std::uint32_t i = 1; i < n_rings; i++) {
+        double theta = pi * i / n_rings;
+        for (std::uint32_t j = 0; j < n_sectors; j++) {
+            double phi = 2.0 * pi * j / n_sectors;
+            mesh.vertices.emplace_back(radius * std::sin(theta) * std::cos(phi), radius * std::sin(theta) * std::sin(phi), radius * std::cos(theta));
+        }
+    }
+    mesh.vertices.emplace_back(0.0, 0.0, -radius);
+    const std::uint32_t south = static_cast<std::uint32_t>(mesh.vertices.size() - 1);
+    auto ring = [n_sectors](std::uint32_t i, std::uint32_t j) { return 1 + (i - 1) * n_sectors + j % n_sectors; };
+    for (std::uint32_t j = 0; j < n_sectors; j++) {
+        mesh.triangles.push_back({ 0, ring(1, j), ring(1, j + 1) });
+        for (std::uint32_t i = 1; i + 1 < n_rings; i++) {
+            mesh.triangles.push_back({ ring(i, j), ring(i + 1, j), ring(i + 1, j + 1) });
+            mesh.triangles.push_back({ ring(i, j), ring(i + 1, j + 1), ring(i, j + 1) });
+        }
+        mesh.triangles.push_back({ south, ring(n_rings - 1, j + 1), ring(n_rings - 1, j) });
+    }
+    return mesh;
+}
+
+/**
+ * @brief Merges two meshes in a single one, without welding their vertices.
+ */
+TriangleMesh mergeMeshes(const TriangleMesh& a, const TriangleMesh& b)
+{
+    TriangleMesh mesh = a;
+    const std::uint32_t offset = static_cast<std::uint32_t>(a.vertices.size());
+    mesh.vertices.insert(mesh.vertices.end(), b.vertices.begin(), b.vertices.end());
+    for (const auto& t : b.triangles) {
+        mesh.triangles.push_back({ t[0] + offset, t[1] + offset, t[2] + offset });
+    }
+    return mesh;
+}
+
+/**
+ * @brief Applies a rigid motion to the vertices of a mesh.
+ */
+TriangleMesh transformMesh(const TriangleMesh& mesh, const Eigen::Matrix3d& R, const Eigen::Vector3d& p)
+{
+    TriangleMesh transformed = mesh;
+    for (auto& v : transformed.vertices) {
+        v = R * v + p;
+    }
+    return transformed;
+}
+
+/**
+ * @brief Checks that each directed edge of a mesh is matched by exactly one opposite edge.
+ */
+bool isClosed(const TriangleMesh& mesh)
+{
+    std::map<std::pair<std::uint32_t, std::uint32_t>, int> edges;
+    for (const auto& t : mesh.triangles) {
+        for (int k = 0; k < 3; k++) {
+            edges[{ t[k], t[(k + 1) % 3] }]++;
+        }
+    }
+    for (const auto& edge : edges) {
+        auto opposite = edges.find({ edge.first.second, edge.first.first });
+        if (edge.second != 1 || opposite == edges.end() || opposite->second != 1) {
+            return false;
+        }
+    }
+    return !mesh.triangles.empty();
+}
+
+/**
+ * @brief Checks that a point is inside a closed convex mesh, up to a tolerance, from the planes of its triangles.
+ */
+bool isInsideConvex(const TriangleMesh& hull, const Eigen::Vector3d& point, double tolerance)
+{
+    const auto normals = computeTriangleNormals(hull);
+    for (std::size_t i = 0; i < hull.triangles.size(); i++) {
+        if (normals[i].dot(point - hull.vertices[hull.triangles[i][0]]) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks that all the vertices of a closed mesh are on the inner side of the planes of its triangles.
+ */
+bool isConvex(const TriangleMesh& hull, double tolerance)
+{
+    return std::all_of(hull.vertices.begin(), hull.vertices.end(),
+                       [&](const Eigen::Vector3d& v) { return isInsideConvex(hull, v, tolerance); });
+}
+
+Eigen::Matrix3d randomRotation(std::mt19937& rng)
+{
+    std::normal_distribution<double> normal;
+    Eigen::Quaterniond q(normal(rng), normal(rng), normal(rng), normal(rng));
+    return q.normalized().toRotationMatrix();
+}
+
+Eigen::Vector3d randomVector(std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    return Eigen::Vector3d(uniform(rng), uniform(rng), uniform(rng));
+}
+
+void testConvexHull()
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> interior(0.05, 0.95);
+    const TriangleMesh cube = boxMesh(Eigen::Vector3d::Zero(), Eigen::Vector3d::Ones());
+    std::vector<Eigen::Vector3d> points = cube.vertices;
+    for (int i = 0; i < 200; i++) {
+        points.emplace_back(interior(rng), interior(rng), interior(rng));
+    }
+    std::shuffle(points.begin(), points.end(), rng);
+
+    TriangleMesh hull = computeConvexHull(points);
+    CHECK(hull.vertices.size() == 8);
+    CHECK(isClosed(hull));
+    CHECK(isConvex(hull, 1e-9));
+    CHECK_NEAR(computeVolume(hull), 1.0, 1e-9);
+    for (const auto& p : points) {
+        CHECK(isInsideConvex(hull, p, 1e-9));
+    }
+
+    // The hull limited in the number of vertices is contained in the exact one
+    const TriangleMesh sphere = sphereMesh(1.0, 16, 32);
+    TriangleMesh exact = computeConvexHull(sphere.vertices);
+    TriangleMesh limited = computeConvexHull(sphere.vertices, 20);
+    CHECK(exact.vertices.size() == sphere.vertices.size());
+    CHECK(limited.vertices.size() <= 20);
+    CHECK(isClosed(limited));
+    CHECK(isConvex(limited, 1e-9));
+    CHECK(computeVolume(limited) > 0.0);
+    CHECK(computeVolume(limited) < computeVolume(exact));
+    for (const auto& v : limited.vertices) {
+        CHECK(isInsideConvex(exact, v, 1e-9));
+    }
+
+    // Coplanar points have no hull
+    std::vector<Eigen::Vector3d> coplanar;
+    for (int i = 0; i < 20; i++) {
+        coplanar.emplace_back(interior(rng), interior(rng), 0.5);
+    }
+    CHECK(computeConvexHull(coplanar).triangles.empty());
+}
+
+void testConvexDecomposition()
+{
+    ConvexDecompositionParameters parameters;
+
+    // A convex mesh is not split
+    const TriangleMesh box = boxMesh(Eigen::Vector3d::Zero(), Eigen::Vector3d(1.0, 2.0, 3.0));
+    auto hulls = computeConvexDecomposition(box, parameters);
+    CHECK(hulls.size() == 1);
+    if (hulls.size() == 1) {
+        CHECK_NEAR(computeVolume(hulls[0]), 6.0, 1e-9);
+    }
+
+    // Two separated boxes are split in (at least) two hulls that cover them without filling the gap
+    const TriangleMesh pair = mergeMeshes(boxMesh(Eigen::Vector3d::Zero(), Eigen::Vector3d::Ones()),
+                                          boxMesh(Eigen::Vector3d(2.0, 0.0, 0.0), Eigen::Vector3d(3.0, 1.0, 1.0)));
+    hulls = computeConvexDecomposition(pair, parameters);
+    CHECK(hulls.size() >= 2);
+    CHECK(hulls.size() <= parameters.maxHulls);
+    double volume = 0.0;
+    for (const auto& hull : hulls) {
+        CHECK(hull.vertices.size() <= parameters.maxVerticesPerHull);
+        CHECK(isClosed(hull));
+        CHECK(isConvex(hull, 1e-9));
+        volume += computeVolume(hull);
+    }
+    CHECK_NEAR(volume, computeVolume(pair), 1e-6);
+    for (const auto& v : pair.vertices) {
+        CHECK(std::any_of(hulls.begin(), hulls.end(), [&](const TriangleMesh& hull) { return isInsideConvex(hull, v, 1e-9); }));
+    }
+
+    // The limits on the number of hulls and vertices are honored
+    parameters.maxHulls = 1;
+    parameters.maxVerticesPerHull = 12;
+    hulls = computeConvexDecomposition(sphereMesh(1.0, 16, 32), parameters);
+    CHECK(hulls.size() == 1);
+    if (hulls.size() == 1) {
+        CHECK(hulls[0].vertices.size() <= 12);
+        CHECK(isClosed(hulls[0]));
+    }
+}
+
+void testPrimitiveFitting()
+{
+    const TriangleMesh box = boxMesh(Eigen::Vector3d::Zero(), Eigen::Vector3d(1.0, 2.0, 3.0));
+    auto primitives = fitPrimitives(box);
+    CHECK(primitives.size() == 4);
+    if (primitives.size() == 4) {
+        const FittedPrimitive& fitted_box = primitives[static_cast<int>(PrimitiveShape::Box)];
+        CHECK(fitted_box.shape == PrimitiveShape::Box);
+        CHECK_NEAR(fitted_box.volume, 6.0, 1e-6);
+        CHECK_NEAR(fitted_box.volumeError, 0.0, 1e-6);
+        CHECK((fitted_box.position - Eigen::Vector3d(0.5, 1.0, 1.5)).norm() < 1e-6);
+        Eigen::Vector3d size = fitted_box.size;
+        std::sort(size.data(), size.data() + 3);
+        CHECK((size - Eigen::Vector3d(1.0, 2.0, 3.0)).norm() < 1e-6);
+        for (const auto& primitive : primitives) {
+            CHECK(primitive.volume >= 6.0 - 1e-6);
+        }
+    }
+
+    FittedPrimitive best;
+    CHECK(fitBestPrimitive(box, { PrimitiveShape::Sphere, PrimitiveShape::Box }, best));
+    CHECK(best.shape == PrimitiveShape::Box);
+    CHECK(!fitBestPrimitive(box, {}, best));
+
+    const TriangleMesh sphere = sphereMesh(2.0, 32, 64);
+    CHECK(fitBestPrimitive(sphere, { PrimitiveShape::Sphere, PrimitiveShape::Box, PrimitiveShape::Cylinder }, best));
+    CHECK(best.shape == PrimitiveShape::Sphere);
+    CHECK_NEAR(best.radius, 2.0, 1e-6);
+    CHECK(best.position.norm() < 1e-6);
+    CHECK(best.volumeError < 0.01);
+}
+
+void testSphereTree()
+{
+    // The spheres are the minimum ones enclosing the vertices of their patches
+    const TriangleMesh box = boxMesh(Eigen::Vector3d::Zero(), Eigen::Vector3d(1.0, 2.0, 3.0));
+    Eigen::Vector3d center;
+    double radius = 0.0;
+    CHECK(computeEnclosingSphere(box.vertices, center, radius));
+    CHECK((center - Eigen::Vector3d(0.5, 1.0, 1.5)).norm() < 1e-9);
+    CHECK_NEAR(radius, std::sqrt(14.0) / 2.0, 1e-9);
+    CHECK(!computeEnclosingSphere({}, center, radius));
+
+    const TriangleMesh mesh = mergeMeshes(sphereMesh(1.0, 12, 24),
+                                          boxMesh(Eigen::Vector3d(2.0, -0.5, -0.5), Eigen::Vector3d(4.0, 0.5, 0.5)));
+    SphereTreeParameters parameters;
+    parameters.maxSpheres = 16;
+    const SphereTree tree = computeSphereTree(mesh, parameters);
+    CHECK(!tree.nodes.empty());
+    if (tree.nodes.empty()) {
+        return;
+    }
+    CHECK(tree.nodes[0].parent == -1);
+    for (std::size_t i = 0; i < tree.nodes.size(); i++) {
+        const SphereTreeNode& node = tree.nodes[i];
+        for (std::uint32_t c = 0; c < node.nChildren; c++) {
+            const SphereTreeNode& child = tree.nodes[node.firstChild + c];
+            CHECK(child.parent == static_cast<std::int32_t>(i));
+            // The patch of a child is part of the one of its parent, so its enclosing sphere is not larger
+            CHECK(child.radius <= node.radius + 1e-9);
+        }
+    }
+    for (const auto& v : mesh.vertices) {
+        CHECK((v - tree.nodes[0].center).norm() <= tree.nodes[0].radius + 1e-9);
+    }
+
+    const auto leaves = getSphereTreeLeaves(tree);
+    CHECK(leaves.size() > 1);
+    CHECK(leaves.size() <= parameters.maxSpheres);
+    // The leaves cover the whole surface, sampled with the vertices and the centroids of the triangles
+    auto covered = [&leaves](const Eigen::Vector3d& p) {
+        return std::any_of(leaves.begin(), leaves.end(), [&p](const SphereTreeNode& leaf) { return (p - leaf.center).norm() <= leaf.radius + 1e-9; });
+    };
+    for (const auto& v : mesh.vertices) {
+        CHECK(covered(v));
+    }
+    for (const auto& t : mesh.triangles) {
+        CHECK(covered((mesh.vertices[t[0]] + mesh.vertices[t[1]] + mesh.vertices[t[2]]) / 3.0));
+    }
+
+    // A looser tolerance needs fewer spheres
+    parameters.maxOverApproximation = 10.0;
+    CHECK(getSphereTreeLeaves(computeSphereTree(mesh, parameters)).size() == 1);
+    CHECK(computeSphereTree(TriangleMesh(), parameters).nodes.empty());
+}
+
+void testSignedDistanceField()
+{
+    // The grid starts at the corner of the box minus the padding, so the padding and the sizes are chosen
+    // so that no sample lies on the faces or on the diagonals of the box, where the sign is undefined
+    const Eigen::Vector3d min(-0.413, -0.297, -0.219);
+    const Eigen::Vector3d max(0.391, 0.283, 0.257);
+    const TriangleMesh box = boxMesh(min, max);
+    SignedDistanceFieldParameters parameters;
+    parameters.resolution = 0.05;
+    parameters.narrowBand = 0.15;
+    parameters.padding = 0.173;
+    SignedDistanceField field;
+    CHECK(computeSignedDistanceField(box, parameters, field, 1));
+    CHECK(field.values.size() == std::size_t(field.size[0]) * field.size[1] * field.size[2]);
+    CHECK(field.values.size() > 1000);
+
+    auto box_distance = [&](const Eigen::Vector3d& p) {
+        Eigen::Vector3d outside = (p - max).cwiseMax(min - p).cwiseMax(0.0);
+        double inside = std::min((p - min).minCoeff(), (max - p).minCoeff());
+        return outside.norm() > 0.0 ? outside.norm() : -inside;
+    };
+    std::size_t n_inside = 0;
+    std::size_t n_band = 0;
+    for (std::uint32_t k = 0; k < field.size[2]; k++) {
+        for (std::uint32_t j = 0; j < field.size[1]; j++) {
+            for (std::uint32_t i = 0; i < field.size[0]; i++) {
+                const Eigen::Vector3d p = field.origin + field.resolution * Eigen::Vector3d(i, j, k);
+                const double expected = box_distance(p);
+                const double value = field.values[i + field.size[0] * (j + field.size[1] * k)];
+                CHECK((value < 0.0) == (expected < 0.0));
+                if (std::abs(expected) < parameters.narrowBand - 1e-6) {
+                    CHECK_NEAR(value, expected, 1e-5);
+                    n_band++;
+                }
+                else {
+                    CHECK(std::abs(value) <= parameters.narrowBand + 1e-6);
+                }
+                n_inside += expected < 0.0 ? 1 : 0;
+            }
+        }
+    }
+    CHECK(n_inside > 0);
+    CHECK(n_band > 0);
+
+    // The result does not depend on the number of threads
+    SignedDistanceField parallel;
+    CHECK(computeSignedDistanceField(box, parameters, parallel, 4));
+    CHECK(parallel.values == field.values);
+
+    // The file round trip is lossless
+    const std::string filename = "creo2urdf-mesh-tests.sdf";
+    CHECK(writeSignedDistanceField(filename, field));
+    SignedDistanceField read;
+    CHECK(readSignedDistanceField(filename, read));
+    CHECK(read.size == field.size);
+    CHECK(read.origin == field.origin);
+    CHECK(read.resolution == field.resolution);
+    CHECK(read.narrowBand == field.narrowBand);
+    CHECK(read.values == field.values);
+    std::remove(filename.c_str());
+    CHECK(!readSignedDistanceField(filename, read));
+
+    parameters.maxSamples = 100;
+    CHECK(!computeSignedDistanceField(box, parameters, field));
+    CHECK(!computeSignedDistanceField(TriangleMesh(), SignedDistanceFieldParameters(), field));
+}
+
+void testCollisionDetection()
+{
+    const MeshBVH cube = buildMeshBVH(boxMesh(-0.5 * Eigen::Vector3d::Ones(), 0.5 * Eigen::Vector3d::Ones()));
+    const MeshBVH sphere = buildMeshBVH(sphereMesh(0.5, 16, 32));
+    CHECK(!cube.nodes.empty());
+    CHECK(cube.triangles.size() == 12);
+
+    Eigen::Isometry3d identity = Eigen::Isometry3d::Identity();
+    Eigen::Isometry3d overlapping = Eigen::Isometry3d::Identity();
+    overlapping.translation() = Eigen::Vector3d(0.7, 0.1, 0.0);
+    Eigen::Isometry3d separated = Eigen::Isometry3d::Identity();
+    separated.translation() = Eigen::Vector3d(1.3, 0.0, 0.0);
+    // Rotated by 45 degrees around z, the corner of the cube reaches 0.707 from its center
+    Eigen::Isometry3d rotated = Eigen::Isometry3d::Identity();
+    rotated.linear() = Eigen::AngleAxisd(pi / 4.0, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+    Eigen::Isometry3d near = Eigen::Isometry3d::Identity();
+    near.translation() = Eigen::Vector3d(1.1, 0.0, 0.0);
+
+    CHECK(meshesIntersect(cube, identity, sphere, overlapping));
+    CHECK(!meshesIntersect(cube, identity, sphere, separated));
+    CHECK(meshesIntersect(cube, rotated, sphere, near));
+    CHECK(!meshesIntersect(cube, rotated, sphere, separated));
+    CHECK(meshesIntersect(cube, identity, cube, overlapping));
+    CHECK(!meshesIntersect(cube, identity, cube, separated));
+
+    std::vector<MeshPoses> samples;
+    for (const auto& pose : { overlapping, separated, near, overlapping }) {
+        samples.push_back({ identity, pose, rotated });
+    }
+    const std::vector<MeshBVH> meshes{ cube, sphere, cube };
+    const std::vector<std::pair<std::size_t, std::size_t>> pairs{ { 0, 1 }, { 0, 2 }, { 1, 2 } };
+    const auto counts = countCollisions(meshes, samples, pairs, 1);
+    CHECK(counts.size() == pairs.size());
+    if (counts.size() == pairs.size()) {
+        CHECK(counts[0] == 2);
+        CHECK(counts[1] == samples.size());
+        CHECK(counts[2] == 3);
+    }
+    CHECK(countCollisions(meshes, samples, pairs, 4) == counts);
+}
+
+void testMassProperties()
+{
+    // Box of sides 1, 2 and 3: I = m / 12 * (b^2 + c^2, a^2 + c^2, a^2 + b^2)
+    const double density = 2.0;
+    const TriangleMesh box = boxMesh(Eigen::Vector3d::Zero(), Eigen::Vector3d(1.0, 2.0, 3.0));
+    MassProperties properties;
+    CHECK(computeMassProperties(box, density, properties));
+    CHECK_NEAR(properties.volume, 6.0, 1e-12);
+    CHECK_NEAR(properties.mass, 12.0, 1e-12);
+    CHECK((properties.centerOfMass - Eigen::Vector3d(0.5, 1.0, 1.5)).norm() < 1e-12);
+    const Eigen::Matrix3d box_inertia = Eigen::Vector3d(13.0, 10.0, 5.0).asDiagonal();
+    CHECK((properties.inertia - box_inertia).norm() < 1e-10);
+
+    // A rigid motion moves the center of mass and rotates the inertia
+    std::mt19937 rng(2);
+    const Eigen::Matrix3d R = randomRotation(rng);
+    const Eigen::Vector3d p = randomVector(rng);
+    MassProperties moved;
+    CHECK(computeMassProperties(transformMesh(box, R, p), density, moved));
+    CHECK_NEAR(moved.mass, properties.mass, 1e-10);
+    CHECK((moved.centerOfMass - (R * properties.centerOfMass + p)).norm() < 1e-10);
+    CHECK((moved.inertia - R * box_inertia * R.transpose()).norm() < 1e-9);
+
+    // Sphere: I = 2 / 5 * m * r^2, converging with the tessellation
+    const double radius = 0.5;
+    MassProperties sphere;
+    CHECK(computeMassProperties(sphereMesh(radius, 128, 256), 1.0, sphere));
+    CHECK_NEAR(sphere.volume, 4.0 / 3.0 * pi * radius * radius * radius, 1e-3);
+    CHECK(sphere.centerOfMass.norm() < 1e-9);
+    for (int i = 0; i < 3; i++) {
+        CHECK_NEAR(sphere.inertia(i, i) / (sphere.mass * radius * radius), 0.4, 1e-3);
+    }
+    CHECK(std::abs(sphere.inertia(0, 1)) + std::abs(sphere.inertia(0, 2)) + std::abs(sphere.inertia(1, 2)) < 1e-9);
+
+    // A mesh inside out encloses no volume
+    TriangleMesh inverted = box;
+    for (auto& t : inverted.triangles) {
+        std::swap(t[1], t[2]);
+    }
+    CHECK(!computeMassProperties(inverted, density, properties));
+    CHECK(!computeMassProperties(TriangleMesh(), density, properties));
+}
+
+void testMeshSymmetry()
+{
+    // Irregular tetrahedron, which differs from its mirror image
+    TriangleMesh tetrahedron;
+    tetrahedron.vertices = { { 0.0, 0.0, 0.0 }, { 1.3, 0.0, 0.0 }, { 0.2, 0.9, 0.0 }, { 0.4, 0.3, 0.7 } };
+    tetrahedron.triangles = { { 0, 2, 1 }, { 0, 1, 3 }, { 1, 2, 3 }, { 0, 3, 2 } };
+    CHECK(computeVolume(tetrahedron) > 0.0);
+
+    std::mt19937 rng(3);
+    const Eigen::Matrix3d R = randomRotation(rng);
+    const Eigen::Vector3d p = randomVector(rng);
+    const TriangleMesh moved = transformMesh(tetrahedron, R, p);
+    TriangleMesh mirrored = transformMesh(tetrahedron, R * Eigen::Vector3d(-1.0, 1.0, 1.0).asDiagonal(), p);
+    for (auto& t : mirrored.triangles) {
+        std::swap(t[1], t[2]);
+    }
+
+    const CanonicalFrame frame = computeCanonicalFrame(tetrahedron);
+    const CanonicalFrame moved_frame = computeCanonicalFrame(moved);
+    const CanonicalFrame mirrored_frame = computeCanonicalFrame(mirrored);
+    CHECK(frame.shapeHash == moved_frame.shapeHash);
+    CHECK(frame.shapeHash == mirrored_frame.shapeHash);
+    CHECK((frame.moments - moved_frame.moments).norm() < 1e-9);
+    CHECK(frame.shapeHash != computeCanonicalFrame(transformMesh(tetrahedron, 2.0 * Eigen::Matrix3d::Identity(), p)).shapeHash);
+
+    Eigen::Matrix3d linear;
+    Eigen::Vector3d translation;
+    CHECK(findCongruence(tetrahedron, frame, moved, moved_frame, false, 1e-6, linear, translation));
+    CHECK((linear - R).norm() < 1e-6);
+    CHECK((translation - p).norm() < 1e-6);
+    CHECK(!findCongruence(tetrahedron, frame, moved, moved_frame, true, 1e-6, linear, translation));
+
+    CHECK(!findCongruence(tetrahedron, frame, mirrored, mirrored_frame, false, 1e-6, linear, translation));
+    CHECK(findCongruence(tetrahedron, frame, mirrored, mirrored_frame, true, 1e-6, linear, translation));
+    CHECK_NEAR(linear.determinant(), -1.0, 1e-6);
+    for (std::size_t i = 0; i < tetrahedron.vertices.size(); i++) {
+        CHECK((linear * tetrahedron.vertices[i] + translation - mirrored.vertices[i]).norm() < 1e-6);
+    }
+}
+
+void testTransformBatch()
+{
+    std::mt19937 rng(4);
+    const std::size_t n = 37;
+    TransformBatch a_H_b;
+    std::vector<Eigen::Isometry3d, Eigen::aligned_allocator<Eigen::Isometry3d>> reference;
+    for (std::size_t i = 0; i < n; i++) {
+        Eigen::Isometry3d H = Eigen::Isometry3d::Identity();
+        H.linear() = randomRotation(rng);
+        H.translation() = randomVector(rng);
+        CHECK(a_H_b.append(H.linear(), H.translation()) == i);
+        reference.push_back(H);
+    }
+    CHECK(a_H_b.size() == n);
+    CHECK((a_H_b.getRotation(5) - reference[5].linear()).norm() < 1e-15);
+    CHECK((a_H_b.getPosition(5) - reference[5].translation()).norm() < 1e-15);
+
+    TransformBatch b_H_a;
+    invertTransforms(a_H_b, b_H_a);
+    CHECK(b_H_a.size() == n);
+    for (std::size_t i = 0; i < n; i++) {
+        const Eigen::Isometry3d inverse = reference[i].inverse();
+        CHECK((b_H_a.getRotation(i) - inverse.linear()).norm() < 1e-12);
+        CHECK((b_H_a.getPosition(i) - inverse.translation()).norm() < 1e-12);
+    }
+
+    std::uniform_int_distribution<std::uint32_t> index(0, static_cast<std::uint32_t>(n - 1));
+    std::vector<std::uint32_t> lhs_index, rhs_index;
+    for (std::size_t k = 0; k < 2 * n; k++) {
+        lhs_index.push_back(index(rng));
+        rhs_index.push_back(index(rng));
+    }
+    TransformBatch a_H_c;
+    composeTransforms(b_H_a, lhs_index, a_H_b, rhs_index, a_H_c);
+    CHECK(a_H_c.size() == lhs_index.size());
+    for (std::size_t k = 0; k < lhs_index.size(); k++) {
+        const Eigen::Isometry3d expected = reference[lhs_index[k]].inverse() * reference[rhs_index[k]];
+        CHECK((a_H_c.getRotation(k) - expected.linear()).norm() < 1e-12);
+        CHECK((a_H_c.getPosition(k) - expected.translation()).norm() < 1e-12);
+    }
+
+    InertiaBatch inertias;
+    std::vector<Eigen::Matrix3d> tensors;
+    std::vector<Eigen::Vector3d> coms;
+    for (std::size_t i = 0; i < n; i++) {
+        const Eigen::Matrix3d R = randomRotation(rng);
+        const Eigen::Matrix3d tensor = R * (Eigen::Vector3d::Ones() + randomVector(rng).cwiseAbs()).asDiagonal() * R.transpose();
+        tensors.push_back(tensor);
+        coms.push_back(randomVector(rng));
+        CHECK(inertias.append(1.0 + i, coms.back(), tensor) == i);
+    }
+    CHECK((inertias.getTensor(3) - tensors[3]).norm() < 1e-15);
+    transformInertias(b_H_a, inertias);
+    CHECK(inertias.size() == n);
+    for (std::size_t i = 0; i < n; i++) {
+        const Eigen::Isometry3d b_H_a_i = reference[i].inverse();
+        CHECK_NEAR(inertias.mass[i], 1.0 + i, 0.0);
+        CHECK((inertias.getCenterOfMass(i) - b_H_a_i * coms[i]).norm() < 1e-12);
+        CHECK((inertias.getTensor(i) - b_H_a_i.linear() * tensors[i] * b_H_a_i.linear().transpose()).norm() < 1e-12);
+    }
+
+    TransformBatch identity;
+    identity.resize(3);
+    CHECK(identity.size() == 3);
+    CHECK(identity.getRotation(2).isIdentity());
+    CHECK(identity.getPosition(2).isZero());
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::map<std::string, std::function<void()>> tests{
+        { "ConvexHull", testConvexHull },
+        { "ConvexDecomposition", testConvexDecomposition },
+        { "PrimitiveFitting", testPrimitiveFitting },
+        { "SphereTree", testSphereTree },
+        { "SignedDistanceField", testSignedDistanceField },
+        { "CollisionDetection", testCollisionDetection },
+        { "MassProperties", testMassProperties },
+        { "MeshSymmetry", testMeshSymmetry },
+        { "TransformBatch", testTransformBatch },
+    };
+    if (argc != 2 || tests.count(argv[1]) == 0) {
+        std::cerr << "Usage: creo2urdf-mesh-tests <test>, with test one of:";
+        for (const auto& test : tests) {
+            std::cerr << " " << test.first;
+        }
+        std::cerr << std::endl;
+        return EXIT_FAILURE;
+    }
+    tests.at(argv[1])();
+    if (failures > 0) {
+        std::cerr << failures << " checks failed in " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
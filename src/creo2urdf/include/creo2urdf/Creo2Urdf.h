@@ -13,8 +13,12 @@
 #define CREO2URDF_H
 
 #include <creo2urdf/Utils.h>
+#include <creo2urdf/ExportConfig.h>
+#include <creo2urdf/JointParameterTable.h>
+#include <creo2urdf/KinematicGraph.h>
 #include <creo2urdf/Sensorizer.h>
 #include <creo2urdf/ElementTreeManager.h>
+#include <creo2urdf/bundle/Bundle.h>
 
 #include <pfcShrinkwrap.h>
 #include <pfcAssembly.h>
@@ -24,7 +28,6 @@
 #include <iDynTree/KinDynComputations.h>
 #include <iDynTree/Model/Traversal.h>
 
-#include <rapidcsv.h>
 
 
 /**
@@ -78,15 +81,56 @@ private:
     bool exportModelToUrdf(iDynTree::Model mdl, iDynTree::ModelExporterOptions options);
 
     /**
-     * @brief Compute spatial inertia from Creo mass properties. 
-     * The mass properties are overridden by the YAML configuration if present in the file.
+     * @brief Writes the velocity and effort limits of the joint parameter table in the limit elements of the exported URDF,
+     * since they cannot be set in the iDynTree joints. Only the limit elements are edited, the rest of the text is unchanged.
+     * @param[in,out] urdf The text of the exported URDF.
+     * @return True if the limits were written or there is nothing to write, false otherwise.
+     */
+    bool writeJointLimitsToUrdf(std::string& urdf) const;
+
+    /**
+     * @brief Collects the mass properties of a part from Creo, expressed in the link frame later by runCreoInertias.
+     * The mass is overridden by the YAML configuration if present in the file.
      * 
      * @param mass_prop The Creo mass properties.
-     * @param H The 3D transform matrix to express the center of mass in the link frame.
+     * @param linkFrame_H_csysPart The 3D transform from the coordinate system of the part to the link frame.
      * @param link_name The name of the link.
-     * @return The computed spatial inertia.
+     * @param check_consistency Whether an inertia that is not physically consistent is reported.
+     */
+    void collectCreoInertia(pfcMassProperty_ptr mass_prop, const iDynTree::Transform& linkFrame_H_csysPart, const std::string& link_name, bool check_consistency);
+
+    /**
+     * @brief Expresses the mass properties collected from Creo in the link frames, for all the links in one batched pass, and sets them in the model.
+     * The assigned inertias, already expressed in the link frames, replace the rotated tensors.
+     * @return True if all the checked inertias are physically consistent, false otherwise.
+     */
+    bool runCreoInertias();
+
+    /**
+     * @brief Rebuilds the model with the links added while processing the assembly, in the given order, moving their inertias and shapes.
+     * The joints are added afterwards in topological order, so that the indexes of links and joints, and the URDF, depend only on the robot.
+     * @param link_order The links of the kinematic graph, in topological order.
      */
-    iDynTree::SpatialInertia computeSpatialInertiafromCreo(pfcMassProperty_ptr mass_prop, iDynTree::Transform H, const std::string& link_name);
+    void orderModelLinks(const std::vector<GraphIndex>& link_order);
+
+    /**
+     * @brief Computes the rest transforms of all the joints of the kinematic graph in one batched pass, inverting the pose of each link once.
+     * @return std::vector<iDynTree::Transform> The transform from the parent link to the child link of each joint, in the order of the joints of the graph.
+     */
+    std::vector<iDynTree::Transform> computeJointRestTransforms() const;
+
+    /**
+     * @brief Read the mesh inertia parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readMeshInertiaFromConfig();
+
+    /**
+     * @brief Integrates the mass properties of the links from their visual meshes, in parallel, and compares them with the ones from Creo.
+     * The links beyond the tolerances are reported, and the inertias from the meshes replace the ones from Creo when requested.
+     * @return True if successful, false otherwise.
+     */
+    bool runMeshInertias();
 
     /**
      * @brief Populate the exported frame information map from the Creo model handle.
@@ -109,14 +153,232 @@ private:
      */
     void readExportedFramesFromConfig();
 
+    /**
+     * @brief Read the named mesh quality levels from the loaded YAML configuration.
+     * @return True if all the levels are valid, false otherwise.
+     */
+    bool readMeshQualityLevelsFromConfig();
+
+    /**
+     * @brief Read the adaptive mesh quality parameters and the assigned mesh qualities from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readAdaptiveMeshQualityFromConfig();
+
+    /**
+     * @brief Read the primitive fitting parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readPrimitiveFittingFromConfig();
+
+    /**
+     * @brief Fits the enclosing primitive with the lowest volume error to the collision meshes of the links, in parallel,
+     * and adds it as collision geometry. The fitted geometries are optionally saved as assignedCollisionGeometry entries.
+     * @return True if successful, false otherwise.
+     */
+    bool runPrimitiveFittings();
+
+    /**
+     * @brief Read the sphere tree parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readSphereTreesFromConfig();
+
+    /**
+     * @brief Computes the sphere trees of the collision meshes of the links, in parallel, and saves them in a side file.
+     * If requested, the leaf spheres are also added as collision geometry.
+     * @return True if successful, false otherwise.
+     */
+    bool runSphereTrees();
+
+    /**
+     * @brief Read the signed distance field parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readSignedDistanceFieldsFromConfig();
+
+    /**
+     * @brief Computes the signed distance fields of the collision meshes of the links, in parallel across links and slices,
+     * and writes each of them next to its mesh.
+     * @return True if successful, false otherwise.
+     */
+    bool runSignedDistanceFields();
+
+    /**
+     * @brief Read the allowed collision matrix parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readAllowedCollisionMatrixFromConfig();
+
+    /**
+     * @brief Computes which pairs of links never or always collide, by checking their collision meshes in configurations
+     * sampled within the joint limits, and saves them together with the adjacent links as disabled pairs of a SRDF file.
+     * It must be called once all the joints have been added to the model.
+     * @return True if successful, false otherwise.
+     */
+    bool computeAllowedCollisionMatrix();
+
+    /**
+     * @brief Adds a simple collision geometry to a link of the iDynTree model.
+     * @param link_name The name of the link in the URDF.
+     * @param geometry_info The collision geometry, expressed in the link frame.
+     */
+    void addCollisionGeometry(const std::string& link_name, const CollisionGeometryInfo& geometry_info);
+
+    /**
+     * @brief Read the convex decomposition parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readConvexDecompositionFromConfig();
+
+    /**
+     * @brief Decomposes the collision meshes of the links into convex hulls, in parallel, and adds one collision element per hull.
+     * The hulls are cached by the content hash of the mesh and the decomposition parameters.
+     * @return True if successful, false otherwise.
+     */
+    bool runConvexDecompositions();
+
     /**
      * @brief Creates a mesh file from the Creo model in the form defined in the configuration file.
+     * The part must already be in link_info_map, whose linkFrame_H_csysPart places the shared meshes.
      * @param component_handle The part as a Creo model.
      * @param mesh_transform The 3D transform associated to the mesh.
      * @return True if successful, false otherwise.
      */
     bool addMeshAndExport(pfcModel_ptr component_handle, const std::string& mesh_transform);
 
+    /**
+     * @brief Drops an exported mesh if another link already exported an identical one, comparing the hashes of their content.
+     * A tessellation kept in memory is dropped before being written, a file exported by Creo is removed.
+     * @param level_name The name of the quality level of the mesh, empty for the meshes without a level.
+     * @param mesh_path The path of the exported mesh.
+     * @param stem The name of the mesh without the formatting.
+     * @return The stem of the mesh to reference, that is the one of the first link that exported it.
+     */
+    std::string deduplicateMesh(const std::string& level_name, const std::string& mesh_path, const std::string& stem);
+
+    /**
+     * @brief Read the mesh cache parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readMeshCacheFromConfig();
+
+    /**
+     * @brief Finds the mesh exported in a previous run with the same key, if its content is still the one that was stored.
+     * @param cache_key The key of the mesh, made of the part identity and version stamp and of the export parameters.
+     * @return std::pair<bool, std::string> True and the path of the cached mesh if found, false if the mesh has to be exported.
+     */
+    std::pair<bool, std::string> findCachedMesh(const std::string& cache_key);
+
+    /**
+     * @brief Stores an exported mesh in the cache, together with its key and content hash.
+     * @param cache_key The key of the mesh.
+     * @param mesh_file_name The path of the exported mesh.
+     */
+    void storeCachedMesh(const std::string& cache_key, const std::string& mesh_file_name);
+
+    /**
+     * @brief Collects the names of the parts, of their datums and of the joints of an assembly and of its subassemblies.
+     * @param asmListItems The items of the assembly.
+     * @param parts Map storing the names of each part, by name of the part in Creo.
+     * @param joints Map storing the joints between the parts.
+     */
+    void collectPreflightItems(pfcModelItems_ptr asmListItems, std::map<std::string, PreflightPartInfo>& parts, std::map<std::string, JointInfo>& joints);
+
+    /**
+     * @brief Checks that the links, joints and frames referenced by the configuration and by the CSV exist in the assembly,
+     * before querying masses and exporting meshes. All the problems are reported at once.
+     * @param asmListItems The items of the root assembly.
+     * @param sensorizer The sensors read from the configuration.
+     * @return True if no problem was found, false otherwise.
+     */
+    bool runPreflight(pfcModelItems_ptr asmListItems, const Sensorizer& sensorizer);
+
+    /**
+     * @brief Parses the joints CSV once into the joint parameter table, reporting all its problems at once.
+     * @return True if the CSV was parsed without problems, false otherwise.
+     */
+    bool readJointParametersFromCsv();
+
+    /**
+     * @brief Read the mesh budget parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readMeshBudgetFromConfig();
+
+    /**
+     * @brief Reports triangles, vertices, file size and bounding box of the meshes of each link, and checks them against the budgets.
+     * It must be called once the meshes referenced by the links are final.
+     * @return True if the report was written and no budget is exceeded, false otherwise.
+     */
+    bool runMeshBudget();
+
+    /**
+     * @brief Read the bundle parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readBundleFromConfig();
+
+    /**
+     * @brief Writes the URDF, the meshes and the side files of the output folder in a single bundle file.
+     * The cache folders inside the output folder are skipped.
+     * @return True if successful, false otherwise.
+     */
+    bool exportBundle();
+
+    /**
+     * @brief Read the mirrored meshes parameters from the loaded YAML configuration.
+     * @return True if all the parameters are valid, false otherwise.
+     */
+    bool readMirroredMeshesFromConfig();
+
+    /**
+     * @brief Finds the meshes that are reflections of other meshes of the same level, in parallel, drops them and makes
+     * their links reference the other mesh through a reflected link_H_geometry and a negative scale along x.
+     * It must be called once all the stages reading the meshes are done.
+     * @return True if successful, false otherwise.
+     */
+    bool runMirroredMeshes();
+
+    /**
+     * @brief Reads an exported STL mesh, from the tessellation kept in memory if any, otherwise from file.
+     * @param mesh_path The path of the mesh.
+     * @param mesh The mesh, in the frame and units of the file.
+     * @return True if successful, false otherwise.
+     */
+    bool readMesh(const std::string& mesh_path, TriangleMesh& mesh) const;
+
+    /**
+     * @brief Writes the tessellations kept in memory that were not dropped as copies or reflections of other meshes, in parallel,
+     * and stores them in the cache. It must be called after runMirroredMeshes and before the stages reading the files.
+     * @return True if successful, false otherwise.
+     */
+    bool writeMeshBuffers();
+
+    /**
+     * @brief Reads an exported STL mesh of a link and expresses it in the link frame, in meters.
+     * @param link_name The name of the link in the URDF.
+     * @param mesh_path The path of the mesh.
+     * @param mesh The mesh read from file.
+     * @return True if successful, false otherwise.
+     */
+    bool readMeshInLinkFrame(const std::string& link_name, const std::string& mesh_path, TriangleMesh& mesh) const;
+
+    /**
+     * @brief Exports the mesh of a part to file. With meshBackend tessellation the mesh is only kept in mesh_buffer_map,
+     * and written by writeMeshBuffers.
+     * If maxTrianglesPerPart is set, the quality of STL meshes is lowered to the highest one whose triangles fit in the budget,
+     * estimated from the triangles of the previous exports, see MeshQualitySearch.
+     * @param component_handle The part as a Creo model.
+     * @param mesh_transform The name of the csys in which the mesh is expressed.
+     * @param mesh_file_name The path of the file to write.
+     * @param mesh_format The format of the mesh, one of the keys of mesh_types_supported_extension_map.
+     * @param mesh_quality The quality of the tessellation, between 1 and 10.
+     * @return True if successful, false otherwise.
+     */
+    bool exportMesh(pfcModel_ptr component_handle, const std::string& mesh_transform, const std::string& mesh_file_name,
+                    const std::string& mesh_format, int mesh_quality);
+
     /**
      * @brief Load YAML configuration from a file.
      * @param filename The name of the YAML configuration file.
@@ -124,13 +386,34 @@ private:
      */
     bool loadYamlConfig(const std::string& filename);
 
+    /**
+     * @brief Reads and parses configuration files in parallel, reusing the files with the same content parsed in the previous runs.
+     * @param jobs The files to parse, whose node is filled with a clone of the parsed content.
+     * @return True if all the files were parsed, false otherwise.
+     */
+    bool parseYamlFiles(std::vector<YamlIncludeJob>& jobs);
+
+    /**
+     * @brief Writes the configuration, with the includes merged and the keys sorted, to the output folder.
+     * @return True if the file was written, false otherwise.
+     */
+    bool writeMergedConfig();
+
     bool processAsmItems(pfcModelItems_ptr asmListItems, pfcModel_ptr model_owner, iDynTree::Transform parentAsm_H_csysAsm = iDynTree::Transform::Identity());
 
-    bool setJointParametersFromCsv(const rapidcsv::Document& csv, const std::string& joint_name, 
+    /**
+     * @brief Sets the position limits, the damping and the friction of a joint from its row of the joint parameter table.
+     * @param table The joint parameter table.
+     * @param joint_name The URDF name of the joint.
+     * @param joint The joint to set.
+     * @param conversion_factor Factor converting the position limits of the CSV to the units of the joint.
+     * @return True if the joint has a row in the table, false otherwise.
+     */
+    bool setJointParametersFromCsv(const JointParameterTable& table, const std::string& joint_name,
         iDynTree::IJoint& joint, double conversion_factor);
 
     /**
-     * @brief Get the renamed element from the configuration.
+     * @brief Get the renamed element from the configuration, from the rename map or the rename patterns.
      * @param elem_name The original element name.
      * @return The renamed element name.
      */
@@ -140,9 +423,85 @@ private:
     std::map<std::string, JointInfo> joint_info_map; /**< Map storing information about joints. */
     std::map<std::string, LinkInfo> link_info_map; /**< Map storing information about links. */
     std::map<std::string, ExportedFrameInfo> exported_frame_info_map; /**< Map storing information about exported frames. */
+    KinematicGraph kinematic_graph; /**< Links, joints and exported frames indexed by integers, built once the assembly has been processed. */
     std::map<std::string, std::array<double,3>> assigned_inertias_map; /**< Map storing assigned inertias. 0 -> xx, 1 -> yy, 2 -> zz. */
+    CreoInertiaBatch creo_inertia_batch; /**< Mass properties queried from Creo, expressed in the link frames by runCreoInertias. */
     std::map<std::string, CollisionGeometryInfo> assigned_collision_geometry_map; /**< Map storing assigned collision geometries. */
+    std::vector<MeshQualityLevel> mesh_quality_levels; /**< Named mesh quality levels exported in the same run. */
+    std::map<std::string, int> assigned_mesh_quality_map; /**< Map storing the mesh quality assigned to specific links. */
+    bool adaptiveMeshQuality{ false }; /**< Flag indicating whether the mesh quality is computed from the size of each part. */
+    double chordTolerance{ 1e-4 }; /**< Chord tolerance in meters used for computing the adaptive mesh quality. */
+    size_t maxTrianglesPerPart{ 0 }; /**< Maximum number of triangles of each exported STL mesh, 0 means no limit. */
+    bool tessellateMeshes{ false }; /**< Flag indicating whether the STL meshes are tessellated in memory instead of exported by Creo. */
+    std::map<std::string, TriangleMesh> mesh_buffer_map; /**< Map storing the tessellation of each mesh file written from memory. */
+    std::map<std::string, std::string> unwritten_mesh_map; /**< Map storing the cache key of each tessellation not written to its file yet, empty if it is not cached. */
+    bool preflight{ true }; /**< Flag indicating whether the references of the configuration are checked before processing the assembly. */
+    bool deduplicateMeshes{ false }; /**< Flag indicating whether identical meshes are exported once and shared by the links. */
+    std::map<std::string, std::string> deduplicated_mesh_map; /**< Map storing the stem of the mesh exported for each level and content hash. */
+    std::map<std::string, std::string> deduplicated_part_map; /**< Map storing the stem of the mesh exported for each level, part, csys and quality. */
+    std::map<std::string, iDynTree::Transform> link_H_geometry_map; /**< Map storing the transform of the shared mesh of each link. */
+    bool meshCache{ false }; /**< Flag indicating whether the exported meshes are cached across runs. */
+    std::string mesh_cache_path{ "" }; /**< Folder storing the meshes exported in the previous runs. */
+    size_t mesh_cache_hits{ 0 }; /**< Number of meshes copied from the cache in this run. */
+    size_t mesh_cache_misses{ 0 }; /**< Number of meshes exported from Creo in this run. */
+    size_t mesh_cache_invalid{ 0 }; /**< Number of cache entries discarded because their content changed. */
+    std::map<std::string, std::string> mesh_uri_path_map; /**< Map storing the path of the file of each mesh referenced by the links. */
+    std::set<std::string> output_side_files; /**< Files other than the URDF and the meshes of the links written in the output folder by this run. */
+    bool meshBudget{ false }; /**< Flag indicating whether the mesh budget report is written. */
+    MeshBudget mesh_budget_per_link; /**< Budget of the meshes of each link. */
+    MeshBudget mesh_budget_total; /**< Budget of the meshes of the whole robot. */
+    std::map<std::string, MeshBudget> assigned_mesh_budget_map; /**< Map storing the budgets of specific links, overriding the per link one. */
+    std::string mesh_budget_report_file{ "meshBudget.csv" }; /**< File in which the statistics of the meshes are saved. */
+    bool bundle{ false }; /**< Flag indicating whether the export is also saved as a single bundle file. */
+    BundleOptions bundle_options; /**< Compression and alignment of the bundle. */
+    std::string bundle_output_file{ "" }; /**< File of the output folder in which the bundle is saved. */
+    bool mirroredMeshes{ false }; /**< Flag indicating whether the meshes that are reflections of other meshes are shared. */
+    double mirrored_meshes_tolerance{ 1e-5 }; /**< Distance between the vertices of two reflected meshes, relative to the diagonal of their bounding box. */
+    std::set<std::string> mirrored_meshes_links; /**< Links whose meshes can be replaced by reflections, empty means all of them. */
+    std::vector<MirroredMeshJob> mirrored_mesh_jobs; /**< Mesh files collected while processing the assembly. */
+    bool meshInertia{ false }; /**< Flag indicating whether the mass properties of the links are integrated from their meshes. */
+    double mesh_inertia_density{ 0.0 }; /**< Density in kg/m^3 of the links, 0 means derived from the mass from Creo. */
+    std::map<std::string, double> mesh_inertia_densities_map; /**< Map storing the densities assigned to specific links. */
+    double mesh_inertia_tolerance{ 0.05 }; /**< Relative error of mass and inertia above which a link is reported. */
+    double mesh_inertia_com_tolerance{ 0.001 }; /**< Error in meters of the center of mass above which a link is reported. */
+    std::string mesh_inertia_substitute{ "never" }; /**< When the inertias from the meshes replace the ones from Creo: never, missing or always. */
+    std::set<std::string> mesh_inertia_links; /**< Links whose mass properties are integrated, empty means all of them. */
+    std::string mesh_inertia_report_file{ "meshInertia.csv" }; /**< File in which the comparison with Creo is saved. */
+    std::vector<MeshInertiaJob> mesh_inertia_jobs; /**< Integrations collected while processing the assembly. */
+    bool primitiveFitting{ false }; /**< Flag indicating whether primitives are fitted to the collision meshes. */
+    std::vector<PrimitiveShape> primitive_fitting_shapes; /**< Shapes among which the fitted primitive is chosen. */
+    std::set<std::string> primitive_fitting_links; /**< Links to which a primitive is fitted, empty means all of them. */
+    std::string primitive_fitting_output_file{ "" }; /**< File in which the fitted geometries are saved, empty means not saved. */
+    std::vector<PrimitiveFittingJob> primitive_fitting_jobs; /**< Fittings collected while processing the assembly. */
+    bool sphereTrees{ false }; /**< Flag indicating whether the sphere trees of the collision meshes are computed. */
+    SphereTreeParameters sphere_tree_parameters; /**< Parameters of the sphere trees, in meters. */
+    std::set<std::string> sphere_tree_links; /**< Links whose sphere tree is computed, empty means all of them. */
+    std::string sphere_tree_output_file{ "sphereTrees.yaml" }; /**< File in which the sphere trees are saved. */
+    bool sphereTreesInURDF{ false }; /**< Flag indicating whether the leaf spheres replace the collision meshes in the URDF. */
+    std::vector<SphereTreeJob> sphere_tree_jobs; /**< Sphere trees collected while processing the assembly. */
+    bool signedDistanceFields{ false }; /**< Flag indicating whether the signed distance fields of the collision meshes are computed. */
+    SignedDistanceFieldParameters signed_distance_field_parameters; /**< Parameters of the signed distance fields, in meters. */
+    std::set<std::string> signed_distance_field_links; /**< Links whose signed distance field is computed, empty means all of them. */
+    std::vector<SignedDistanceFieldJob> signed_distance_field_jobs; /**< Signed distance fields collected while processing the assembly. */
+    bool allowedCollisionMatrix{ false }; /**< Flag indicating whether the allowed collision matrix is computed. */
+    size_t allowed_collision_matrix_samples{ 1000 }; /**< Number of configurations in which the collisions are checked. */
+    double allowed_collision_matrix_always_ratio{ 0.95 }; /**< Ratio of the samples in collision above which a pair is considered always colliding. */
+    unsigned allowed_collision_matrix_seed{ 0 }; /**< Seed of the generator of the sampled configurations. */
+    std::set<std::string> allowed_collision_matrix_links; /**< Links whose collisions are checked, empty means all of them. */
+    std::string allowed_collision_matrix_output_file{ "" }; /**< SRDF file in which the disabled pairs are saved. */
+    std::map<std::string, std::string> allowed_collision_matrix_meshes; /**< Collision meshes of the checked links, collected while processing the assembly. */
+    bool convexDecomposition{ false }; /**< Flag indicating whether the collision meshes are decomposed into convex hulls. */
+    ConvexDecompositionParameters convex_decomposition_parameters; /**< Parameters of the convex decomposition. */
+    std::set<std::string> convex_decomposition_links; /**< Links whose collision mesh is decomposed, empty means all of them. */
+    std::string convex_decomposition_cache_path{ "" }; /**< Folder storing the hulls of the already decomposed meshes. */
+    std::vector<ConvexDecompositionJob> convex_decomposition_jobs; /**< Decompositions collected while processing the assembly. */
     YAML::Node config; /**< YAML configuration node, storing the content of the configuration file. */
+    JointParameterTable joint_parameter_table; /**< Joint parameters parsed from the CSV. */
+    std::unordered_map<std::uint64_t, YAML::Node> yaml_file_cache; /**< Map storing the configuration files parsed in the previous runs, by hash of their content. */
+    std::string normalized_config{ "" }; /**< Configuration with the includes merged and the keys sorted. */
+    std::uint64_t config_hash{ 0 }; /**< Hash of the normalized configuration. */
+    std::string merged_config_output_file{ "mergedConfig.yaml" }; /**< File of the output folder in which the normalized configuration is saved. */
+    ExportConfig export_config; /**< Lookups of the configuration done per link and per joint, compiled when the configuration is loaded. */
     bool exportAllUseradded{ false }; /**< Flag indicating whether to export all user-added frames. */
     bool exportFirstBaseLinkAdditionalFrameAsFakeURDFBase{ false };  /**< Flag to export the first additional frame attached to the base link as fake urdf base. */
     
@@ -0,0 +1,119 @@
+/** @file ExportConfig.h
+ *  @brief Contains declarations for the ExportConfig class, the typed view of the configuration queried while exporting.
+ *
+ * The YAML configuration is compiled once after being loaded into hash maps,
+ * so that the lookups done for every link and joint do not walk the YAML nodes.
+ *
+ *  @bug The names resolved by the rename patterns are cached, so the class is not thread safe.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef EXPORTCONFIG_H
+#define EXPORTCONFIG_H
+
+#include <array>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+/**
+ * @brief Rule renaming every element whose name matches a regular expression.
+ */
+struct RenameRule {
+    std::string pattern; ///< ECMAScript regular expression matched against the whole name.
+    std::regex regex; ///< Compiled pattern.
+    std::string replacement; ///< Format of the new name, in which $1, $2, ... are the groups of the pattern.
+};
+
+/**
+ * @brief Typed configuration of the export, compiled from the YAML configuration.
+ */
+class ExportConfig {
+public:
+    /**
+     * @brief Compiles the keys of the configuration that are looked up per link and per joint.
+     * The previously compiled content is discarded.
+     *
+     * @param config The YAML configuration, with the includes already merged.
+     * @param[out] warnings Inconsistencies that do not prevent the export, e.g. two elements renamed to the same name.
+     * @param[out] error Description of the first malformed key, if any.
+     * @return True if the configuration was compiled, false if a key is malformed.
+     */
+    bool compile(const YAML::Node& config, std::vector<std::string>& warnings, std::string& error);
+
+    /**
+     * @brief Discards the compiled configuration.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the URDF name of an element of the assembly.
+     * The rename map is looked up first, then the rename patterns in the order in which they are listed.
+     *
+     * @param cad_name The name of the element in Creo.
+     * @return std::pair<bool, std::string> True and the new name if the element is renamed, false and cad_name otherwise.
+     */
+    std::pair<bool, std::string> rename(const std::string& cad_name) const;
+
+    /**
+     * @brief Gets the name in Creo of an element from its URDF name.
+     * The names produced by the rename patterns are known only after being resolved by rename.
+     *
+     * @param urdf_name The name of the element in the URDF.
+     * @return std::pair<bool, std::string> True and the name in Creo if found, false and an empty string otherwise.
+     */
+    std::pair<bool, std::string> reverseRename(const std::string& urdf_name) const;
+
+    /**
+     * @brief Gets the frame chosen in linkFrames for a link.
+     *
+     * @param urdf_link_name The URDF name of the link.
+     * @return std::pair<bool, std::string> True and the name of the frame if the link is listed, false and an empty string otherwise.
+     */
+    std::pair<bool, std::string> linkFrame(const std::string& urdf_link_name) const;
+
+    /**
+     * @brief Checks whether the rotation axis of a joint is listed in reverseRotationAxis.
+     *
+     * @param joint_name The URDF name of the joint.
+     * @return True if the axis has to be reversed, false otherwise.
+     */
+    bool isRotationAxisReversed(const std::string& joint_name) const;
+
+    /**
+     * @brief Gets the mass assigned to a link in assignedMasses.
+     *
+     * @param link_name The name of the link.
+     * @return std::pair<bool, double> True and the mass in kg if assigned, false and 0 otherwise.
+     */
+    std::pair<bool, double> assignedMass(const std::string& link_name) const;
+
+    /**
+     * @brief Gets the color assigned to a link in assignedColors.
+     *
+     * @param link_name The URDF name of the link.
+     * @return std::pair<bool, std::array<double, 4>> True and the RGBA color if assigned, false and zeros otherwise.
+     */
+    std::pair<bool, std::array<double, 4>> assignedColor(const std::string& link_name) const;
+
+private:
+    std::unordered_map<std::string, std::string> rename_map; /**< Map storing the URDF name of the elements listed in rename. */
+    std::vector<RenameRule> rename_rules; /**< Rules listed in renamePatterns. */
+    mutable std::unordered_map<std::string, std::pair<bool, std::string>> rename_cache; /**< Map storing the names already resolved by the rename patterns. */
+    mutable std::unordered_map<std::string, std::string> reverse_rename_map; /**< Map storing the name in Creo of each renamed element. */
+    std::unordered_map<std::string, std::string> link_frame_map; /**< Map storing the link frame of the links listed in linkFrames. */
+    std::unordered_set<std::string> reversed_rotation_axes; /**< Joints listed in reverseRotationAxis. */
+    std::unordered_map<std::string, double> assigned_mass_map; /**< Map storing the masses listed in assignedMasses. */
+    std::unordered_map<std::string, std::array<double, 4>> assigned_color_map; /**< Map storing the colors listed in assignedColors. */
+};
+
+#endif // !EXPORTCONFIG_H
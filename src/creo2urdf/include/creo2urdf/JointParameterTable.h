@@ -0,0 +1,87 @@
+/** @file JointParameterTable.h
+ *  @brief Contains declarations for the JointParameterTable class, the typed content of the joints CSV.
+ *
+ * The CSV is parsed once into a table of numbers indexed by joint name,
+ * so that setting the parameters of a joint does not look up labels and convert text again.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef JOINTPARAMETERTABLE_H
+#define JOINTPARAMETERTABLE_H
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Parameters of a joint read from the CSV. The parameters missing from the CSV, or whose cell is empty, are NaN.
+ */
+struct JointParameters {
+    double lower_limit{ std::numeric_limits<double>::quiet_NaN() }; ///< Lower position limit, in degrees for revolute joints.
+    double upper_limit{ std::numeric_limits<double>::quiet_NaN() }; ///< Upper position limit, in degrees for revolute joints.
+    double velocity_limit{ std::numeric_limits<double>::quiet_NaN() }; ///< Velocity limit, in rad/s or m/s.
+    double effort_limit{ std::numeric_limits<double>::quiet_NaN() }; ///< Effort limit, in Nm or N.
+    double damping{ std::numeric_limits<double>::quiet_NaN() }; ///< Viscous friction coefficient.
+    double friction{ std::numeric_limits<double>::quiet_NaN() }; ///< Static friction.
+};
+
+/**
+ * @brief Joint parameters read from the CSV, indexed by joint name.
+ */
+class JointParameterTable {
+public:
+    /**
+     * @brief Parses the CSV. The first column contains the joint names and the first line the names of the parameters.
+     * The previously loaded content is discarded.
+     *
+     * @param path The path of the CSV file.
+     * @param[out] problems Duplicated joints and cells that are not numbers, all reported at once.
+     * @param[out] warnings Unknown columns, which are ignored and do not make the parsing fail.
+     * @return True if the file was parsed without problems, false otherwise.
+     */
+    bool load(const std::string& path, std::vector<std::string>& problems, std::vector<std::string>& warnings);
+
+    /**
+     * @brief Discards the loaded content.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the parameters of a joint.
+     *
+     * @param joint_name The URDF name of the joint.
+     * @return const JointParameters* The parameters, or nullptr if the joint has no row.
+     */
+    const JointParameters* find(const std::string& joint_name) const;
+
+    /**
+     * @brief Checks whether a column is present in the CSV.
+     *
+     * @param column_name The name of the column, e.g. lower_limit.
+     * @return True if the column is present, false otherwise.
+     */
+    bool hasColumn(const std::string& column_name) const;
+
+    /**
+     * @brief Gets the names of the joints in the order of the rows.
+     *
+     * @return const std::vector<std::string>& The joint names.
+     */
+    const std::vector<std::string>& jointNames() const { return joint_names; }
+
+private:
+    std::vector<JointParameters> rows; /**< Parameters of each row, in the order of the file. */
+    std::vector<std::string> joint_names; /**< Joint name of each row. */
+    std::unordered_map<std::string, size_t> row_index_map; /**< Map storing the row of each joint. */
+    std::vector<std::string> column_names; /**< Names of the parameters present in the file. */
+};
+
+#endif // !JOINTPARAMETERTABLE_H
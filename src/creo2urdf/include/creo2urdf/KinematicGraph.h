@@ -0,0 +1,205 @@
+/** @file KinematicGraph.h
+ *  @brief Contains declarations for the NameInterner and KinematicGraph classes.
+ *
+ * Once the assembly has been traversed, links, joints and exported frames are indexed by integers,
+ * with their names interned once and secondary indexes from every name to the element,
+ * so that the stages after the traversal do not search the maps keyed by strings.
+ *
+ *  @bug No known bugs.
+ *
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef KINEMATICGRAPH_H
+#define KINEMATICGRAPH_H
+
+#include <creo2urdf/Utils.h>
+#include <creo2urdf/ExportConfig.h>
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using NameId = std::uint32_t; ///< Identifier of an interned name.
+using GraphIndex = std::uint32_t; ///< Index of a link, joint or frame of the kinematic graph.
+
+constexpr NameId invalidNameId = std::numeric_limits<NameId>::max(); ///< Identifier of the names that are not interned.
+constexpr GraphIndex invalidGraphIndex = std::numeric_limits<GraphIndex>::max(); ///< Index of the elements that are not in the graph.
+
+/**
+ * @brief Stores each distinct name once and assigns it a dense identifier.
+ */
+class NameInterner {
+public:
+    /**
+     * @brief Interns a name.
+     * @param name The name.
+     * @return NameId The identifier of the name, the same for equal names.
+     */
+    NameId intern(const std::string& name);
+
+    /**
+     * @brief Finds the identifier of a name without interning it.
+     * @param name The name.
+     * @return NameId The identifier of the name, invalidNameId if it was never interned.
+     */
+    NameId find(const std::string& name) const;
+
+    /**
+     * @brief Gets an interned name.
+     * @param id The identifier of the name.
+     * @return const std::string& The name, valid until the interner is cleared.
+     */
+    const std::string& name(NameId id) const { return names[id]; }
+
+    /**
+     * @brief Gets the number of interned names, that is one more than the largest identifier.
+     */
+    size_t size() const { return names.size(); }
+
+    /**
+     * @brief Discards all the names.
+     */
+    void clear();
+
+private:
+    struct NameHash {
+        size_t operator()(const std::string* name) const { return std::hash<std::string>()(*name); }
+    };
+    struct NameEqual {
+        bool operator()(const std::string* a, const std::string* b) const { return *a == *b; }
+    };
+
+    std::deque<std::string> names; /**< Interned names, whose addresses do not change when new names are added. */
+    std::unordered_map<const std::string*, NameId, NameHash, NameEqual> id_map; /**< Map storing the identifier of each name. */
+};
+
+/**
+ * @brief Link of the kinematic graph.
+ */
+struct GraphLink {
+    NameId cad_name{ invalidNameId }; ///< Name of the part in Creo.
+    NameId urdf_name{ invalidNameId }; ///< Name of the link in the URDF.
+    GraphIndex parent_joint{ invalidGraphIndex }; ///< Joint connecting the link to its parent, invalidGraphIndex for the roots.
+    const LinkInfo* info{ nullptr }; ///< Information collected while processing the assembly.
+};
+
+/**
+ * @brief Joint of the kinematic graph.
+ */
+struct GraphJoint {
+    NameId cad_name{ invalidNameId }; ///< Name of the joint built from the names in Creo of the parent and of the child.
+    NameId urdf_name{ invalidNameId }; ///< Name of the joint in the URDF.
+    NameId datum_name{ invalidNameId }; ///< Name of the axis or of the coordinate system defining the joint.
+    GraphIndex parent_link{ invalidGraphIndex }; ///< Parent link.
+    GraphIndex child_link{ invalidGraphIndex }; ///< Child link.
+    const JointInfo* info{ nullptr }; ///< Information collected while processing the assembly.
+};
+
+/**
+ * @brief Exported frame of the kinematic graph.
+ */
+struct GraphFrame {
+    NameId name{ invalidNameId }; ///< Name of the coordinate system in Creo.
+    GraphIndex link{ invalidGraphIndex }; ///< Link to which the frame is attached, invalidGraphIndex if not found.
+    const ExportedFrameInfo* info{ nullptr }; ///< Information collected while processing the assembly.
+};
+
+/**
+ * @brief Range of indexes stored contiguously, e.g. the child joints of a link.
+ */
+struct GraphIndexRange {
+    const GraphIndex* first{ nullptr };
+    const GraphIndex* last{ nullptr };
+    const GraphIndex* begin() const { return first; }
+    const GraphIndex* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+};
+
+/**
+ * @brief Links, joints and exported frames of the assembly indexed by integers, with the child joints of each link stored contiguously.
+ */
+class KinematicGraph {
+public:
+    /**
+     * @brief Builds the graph from the maps filled while processing the assembly.
+     * The joints of a cut assembly, whose parent or child is not a link, are left out.
+     * The maps must not be modified while the graph is used, since the graph points to their elements.
+     *
+     * @param link_info_map Map of the links, by name of the part in Creo.
+     * @param joint_info_map Map of the joints, by name built from the names in Creo of the parent and of the child.
+     * @param exported_frame_info_map Map of the exported frames, by name of the coordinate system.
+     * @param export_config The compiled configuration, used for the URDF names.
+     */
+    void build(const std::map<std::string, LinkInfo>& link_info_map,
+               const std::map<std::string, JointInfo>& joint_info_map,
+               const std::map<std::string, ExportedFrameInfo>& exported_frame_info_map,
+               const ExportConfig& export_config);
+
+    /**
+     * @brief Discards the graph and the interned names.
+     */
+    void clear();
+
+    const std::vector<GraphLink>& links() const { return graph_links; }
+    const std::vector<GraphJoint>& joints() const { return graph_joints; }
+    const std::vector<GraphFrame>& frames() const { return graph_frames; }
+
+    /**
+     * @brief Gets an interned name of the graph.
+     */
+    const std::string& name(NameId id) const { return interner.name(id); }
+
+    /**
+     * @brief Gets the joints whose parent is a link.
+     * @param link The index of the link.
+     * @return GraphIndexRange The indexes of the joints.
+     */
+    GraphIndexRange childJoints(GraphIndex link) const;
+
+    /**
+     * @brief Sorts links and joints topologically, depth first from the root, visiting the child joints of each link in the order of their URDF names.
+     * The links not reachable from the root follow, starting from the ones without a parent joint, in the order of their URDF names.
+     * The order depends only on the URDF names and on the structure of the graph, not on the names in Creo.
+     *
+     * @param root_urdf_name URDF name of the root link, the links without a parent joint are the roots if it is not in the graph.
+     * @param[out] link_order The links, each after the parent of its parent joint.
+     * @param[out] joint_order The joints, each after its parent link; a joint closing a loop follows the joints reaching its child.
+     */
+    void topologicalOrder(const std::string& root_urdf_name, std::vector<GraphIndex>& link_order, std::vector<GraphIndex>& joint_order) const;
+
+    GraphIndex findLink(const std::string& cad_name) const { return lookup(link_by_cad_name, cad_name); }
+    GraphIndex findLinkByUrdfName(const std::string& urdf_name) const { return lookup(link_by_urdf_name, urdf_name); }
+    GraphIndex findJoint(const std::string& cad_name) const { return lookup(joint_by_cad_name, cad_name); }
+    GraphIndex findJointByUrdfName(const std::string& urdf_name) const { return lookup(joint_by_urdf_name, urdf_name); }
+    /**
+     * @brief Finds the joint defined by an axis or a coordinate system. If several joints use the same datum, the first in the order of their names is returned.
+     */
+    GraphIndex findJointByDatum(const std::string& datum_name) const { return lookup(joint_by_datum_name, datum_name); }
+    GraphIndex findFrame(const std::string& frame_name) const { return lookup(frame_by_name, frame_name); }
+
+private:
+    GraphIndex lookup(const std::vector<GraphIndex>& index, const std::string& name) const;
+    void setIndex(std::vector<GraphIndex>& index, NameId id, GraphIndex value); // Keeps the first value set for a name
+
+    NameInterner interner; /**< Names of the links, joints, datums and frames. */
+    std::vector<GraphLink> graph_links; /**< Links, in the order of their names in Creo. */
+    std::vector<GraphJoint> graph_joints; /**< Joints, in the order of their names in Creo. */
+    std::vector<GraphFrame> graph_frames; /**< Exported frames, in the order of their names. */
+    std::vector<GraphIndex> child_joint_offsets; /**< Offset in child_joints of the child joints of each link, with one more element for the end. */
+    std::vector<GraphIndex> child_joints; /**< Child joints of all the links, grouped by parent link. */
+    std::vector<GraphIndex> link_by_cad_name; /**< Link of each interned name, indexed by NameId. */
+    std::vector<GraphIndex> link_by_urdf_name; /**< Link of each interned name, indexed by NameId. */
+    std::vector<GraphIndex> joint_by_cad_name; /**< Joint of each interned name, indexed by NameId. */
+    std::vector<GraphIndex> joint_by_urdf_name; /**< Joint of each interned name, indexed by NameId. */
+    std::vector<GraphIndex> joint_by_datum_name; /**< First joint using each interned datum name, indexed by NameId. */
+    std::vector<GraphIndex> frame_by_name; /**< Exported frame of each interned name, indexed by NameId. */
+};
+
+#endif // !KINEMATICGRAPH_H
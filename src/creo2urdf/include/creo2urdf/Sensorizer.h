@@ -16,6 +16,7 @@
 #define SENSORIZER_H
 
 #include <creo2urdf/Utils.h>
+#include <creo2urdf/KinematicGraph.h>
 
 #include <libxml2/libxml/parser.h>
 #include <libxml2/libxml/tree.h>
@@ -23,6 +24,17 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <unordered_map>
+
+/**
+ * @brief Parses an XML fragment, made of one or more elements, and serializes it again without the blanks between the elements.
+ * @param fragment The XML fragment.
+ * @param[out] xml The serialized elements.
+ * @param[out] error The message of the parser if the fragment is not well formed.
+ * @return True if the fragment is well formed, false otherwise.
+ */
+bool parseXMLFragment(const std::string& fragment, std::string& xml, std::string& error);
+
 /**
  * @brief Represents a Sensorizer class, used read sensors information from a YAML node, 
  * and create the related XML blobs to feed to iDynTree Model Exporter.
@@ -41,28 +53,51 @@ struct Sensorizer {
      */
     void readSensorsFromConfig(const YAML::Node& config);
 
+    /**
+     * @brief Reads the arrays of sensors from a YAML node, and the CSV of their poses.
+     * @param config The YAML node containing sensor configuration.
+     * @param config_folder The folder of the main YAML file, with the trailing separator, to which the CSV paths are relative.
+     * @return True if all the arrays are valid, false otherwise.
+     */
+    bool readSensorArraysFromConfig(const YAML::Node& config, const std::string& config_folder);
+
     /**
      * @brief Assigns a 3D transform to a force/torque sensor based on provided information.
-     * @param exported_frame_info_map A map of exported frame information.
-     * @param link_info_map A map of link information.
-     * @param joint_info_map A map of joint information.
+     * @param kinematic_graph The links, joints and exported frames of the assembly.
      * @param scale The scale for the position part of the 3D transform.
      */
-    void assignTransformToFTSensor(const std::map<std::string, ExportedFrameInfo>& exported_frame_info_map,
-                                   const std::map<std::string, LinkInfo>& link_info_map,
-                                   const std::map<std::string, JointInfo>& joint_info_map,
+    void assignTransformToFTSensor(const KinematicGraph& kinematic_graph,
                                    const std::array<double, 3> scale);
 
     /**
      * @brief Assigns a 3D transform to all sensors based on provided information.
-     * @param exported_frame_info_map A map of exported frame information.
-     * @param link_info_map A map of link information.
+     * @param kinematic_graph The links, joints and exported frames of the assembly.
      * @param scale The scale for the position part of the 3D transform.
      */
-    void assignTransformToSensors(const std::map<std::string, ExportedFrameInfo>& exported_frame_info_map,
-                                  const std::map<std::string, LinkInfo>& link_info_map,
+    void assignTransformToSensors(const KinematicGraph& kinematic_graph,
                                   const std::array<double, 3> scale);
 
+    /**
+     * @brief Generates the sensors of the arrays, with their transforms, and appends them to sensors.
+     * The frames of the sensors of each array are resolved together from the coordinate systems of the part, listed once.
+     * To be called after assignTransformToSensors, since the transforms of the generated sensors are already set.
+     *
+     * @param kinematic_graph The links, joints and exported frames of the assembly.
+     * @param scale The scale for the position part of the 3D transform.
+     * @return True if all the arrays generated at least one sensor, false otherwise.
+     */
+    bool expandSensorArrays(const KinematicGraph& kinematic_graph,
+                            const std::array<double, 3> scale);
+
+    /**
+     * @brief Parses once each distinct XML blob of the sensors, whatever the number of sensors sharing it,
+     * and reports the blobs that are not well formed with the names of the sensors using them.
+     * To be called after expandSensorArrays and before building the XML blobs, which only include the blobs parsed here.
+     *
+     * @return True if all the blobs are well formed, false otherwise.
+     */
+    bool parseSensorXMLBlobs();
+
     /**
      * @brief Builds a vector of XML trees as strings for force/torque sensors, 
      * starting from the information retrieved in the YAML. The XML trees are returned in this
@@ -92,10 +127,29 @@ struct Sensorizer {
     std::vector<SensorInfo> sensors;
 
     /**
-     * @brief YAML node containing sensor configuration.
+     * @brief Vector containing the arrays of sensors, expanded into sensors by expandSensorArrays.
      */
-    YAML::Node m_config;
+    std::vector<SensorArrayInfo> sensor_arrays;
 
+private:
+    /**
+     * @brief Gets the coordinate systems of the part of a link, listed the first time they are needed.
+     * @return const PartDatumTable* The coordinate systems, nullptr if the part has none.
+     */
+    const PartDatumTable* getDatumTable(const KinematicGraph& kinematic_graph, GraphIndex link, const std::array<double, 3>& scale);
+
+    /**
+     * @brief XML blob of the sensors, parsed once.
+     */
+    struct ParsedXMLBlob {
+        bool valid{ false }; ///< True if the blob is well formed.
+        std::string xml; ///< Serialized elements of the blob, written as they are in each sensor.
+        std::string error; ///< Message of the parser if the blob is not well formed.
+        std::vector<std::string> sensorNames; ///< Names of the sensors using the blob, if it is not well formed.
+    };
+
+    std::map<GraphIndex, PartDatumTable> part_datum_tables; /**< Coordinate systems of the parts, by link. */
+    std::unordered_map<std::string, ParsedXMLBlob> parsed_xml_blobs; /**< Parsed XML blobs of the sensors, by content. */
 };
 
 
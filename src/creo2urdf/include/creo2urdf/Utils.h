@@ -20,6 +20,7 @@
 #include <string>
 #include <array>
 #include <map>
+#include <set>
 #include <unordered_map>
 
 #include <pfcGlobal.h>
@@ -34,6 +35,15 @@
 #include <iDynTree/Model/FixedJoint.h>
 #include <yaml-cpp/yaml.h>
 
+#include <creo2urdf/mesh/ConvexDecomposition.h>
+#include <creo2urdf/mesh/PrimitiveFitting.h>
+#include <creo2urdf/mesh/SphereTree.h>
+#include <creo2urdf/mesh/SignedDistanceField.h>
+#include <creo2urdf/mesh/CollisionDetection.h>
+#include <creo2urdf/mesh/MassProperties.h>
+#include <creo2urdf/mesh/MeshSymmetry.h>
+#include <creo2urdf/mesh/TransformBatch.h>
+
 /**
  * @brief Small positive value used for numerical precision comparisons.
  */
@@ -57,6 +67,18 @@ constexpr double deg2rad = 1 / rad2deg;
  */
 constexpr double gravity_z = -9.81;
 
+/**
+ * @brief Relative chord tolerance (chord height over part size) obtained with the lowest mesh quality.
+ */
+constexpr double coarsest_relative_chord_tolerance = 1e-2;
+
+/**
+ * @brief Number of mesh quality steps needed to reduce the relative chord tolerance by a factor 10.
+ *
+ * With this value the quality 10 corresponds to a relative chord tolerance of 1e-4.
+ */
+constexpr double mesh_quality_steps_per_decade = 4.5;
+
 /**
  * @brief Map containing the supported mesh types and their corresponding file extensions.
  */
@@ -121,6 +143,7 @@ enum class ShapeType {
     Box,        ///< Box shape type.
     Cylinder,   ///< Cylinder shape type.
     Sphere,     ///< Sphere shape type.
+    Capsule,    ///< Capsule shape type, exported as a cylinder with a sphere at each end.
     None        ///< Default or invalid shape type.
 };
 
@@ -145,6 +168,7 @@ static const std::map<ShapeType, std::string> shape_type_map = {
     { ShapeType::Sphere, "sphere" }, /// < Sphere shape type.
     { ShapeType::Cylinder, "cylinder"}, /// < Cylinder shape type.
     { ShapeType::Sphere, "sphere"}, /// < Sphere shape type.
+    { ShapeType::Capsule, "capsule"}, /// < Capsule shape type.
     { ShapeType::None, "empty"} /// < Default or invalid shape type.
 };
 
@@ -181,6 +205,24 @@ struct SensorInfo {
     std::vector<std::string> xmlBlobs;          ///< Additional XML blobs that can be appended to the XML tree.
 };
 
+/**
+ * @brief Array of sensors of the same type attached to a link, generated from the coordinate systems whose name matches a pattern or from a CSV of poses.
+ * The names and the XML blobs are templates, in which {link}, {frame} and {index} are replaced by the link, the coordinate system or pose name, and the position in the array.
+ */
+struct SensorArrayInfo {
+    std::string linkName{ "" };                  ///< Name of the link at which the sensors are attached.
+    std::string frameNamePattern{ "" };          ///< Regular expression matched against the names of the coordinate systems of the part, empty if posesFile is used.
+    std::string posesFile{ "" };                 ///< CSV of the poses with respect to the link frame, empty if frameNamePattern is used.
+    std::vector<std::string> poseNames;          ///< Name of each pose read from posesFile.
+    std::vector<iDynTree::Transform> poses;      ///< Poses read from posesFile.
+    std::string sensorName{ "{link}_{frame}" };  ///< Template of the names of the sensors.
+    std::string exportedFrameName{ "" };         ///< Template of the names of the exported frames, the name of the sensor if empty.
+    bool exportFrameInURDF{ false };             ///< Flag indicating whether to export the frames in URDF.
+    SensorType type{ SensorType::None };         ///< Type of the sensors.
+    double updateRate{ 100 };                    ///< Update rate of the sensors.
+    std::vector<std::string> xmlBlobs;           ///< Templates of the additional XML blobs of each sensor.
+};
+
 /**
  * @brief Information about a Force Torque sensor. Forces are measured in N, torques in N*m.
  */
@@ -218,6 +260,159 @@ struct CollisionGeometryInfo {
     iDynTree::Transform link_H_geometry{iDynTree::Transform::Identity()}; ///< 3D transform from link reference frame to simplified geometry.
 };
 
+/**
+ * @brief Named mesh quality level. Each level is exported in its own subfolder of the output path.
+ *
+ * The levels named "visual" and "collision" are referenced by the visual and collision elements of the links.
+ */
+struct MeshQualityLevel {
+    std::string name{""}; ///< Name of the level, used also as name of the subfolder.
+    int quality{3}; ///< Quality of the exported meshes, between 1 and 10.
+    std::map<std::string, int> linkOverrides; ///< Quality of specific links, overriding the one of the level.
+};
+
+/**
+ * @brief Limits on the meshes of a link or of the whole robot, 0 means no limit.
+ */
+struct MeshBudget {
+    size_t maxTriangles{0}; ///< Maximum number of triangles.
+    size_t maxVertices{0}; ///< Maximum number of vertices.
+    size_t maxFileSize{0}; ///< Maximum size of the mesh files, in bytes.
+};
+
+/**
+ * @brief Search of the highest mesh quality whose tessellation fits in a triangle budget, with few exports.
+ * The next quality is estimated from the triangles of the last export, assuming that they grow as the inverse
+ * of the chord height (see computeChordHeight) for the first estimate, then with the growth measured between
+ * the last two exports. It is kept between the highest quality known to fit and the lowest quality known not to fit.
+ */
+class MeshQualitySearch {
+public:
+    /**
+     * @brief Starts the search from the requested quality, the highest one that can be chosen.
+     */
+    MeshQualitySearch(int quality, size_t max_triangles);
+
+    /**
+     * @brief Gets the quality of the next export.
+     */
+    int quality() const { return current_quality; }
+
+    /**
+     * @brief Gets the highest quality whose export fits in the budget, 0 if none fits.
+     * The last export that fits is the one with this quality.
+     */
+    int bestQuality() const { return fitting_quality; }
+
+    /**
+     * @brief Records the triangles of the mesh exported with quality().
+     * @return bool True if another quality has to be exported, false if the search is over.
+     */
+    bool next(size_t n_triangles);
+
+private:
+    size_t max_triangles{ 0 }; /**< Maximum number of triangles. */
+    int current_quality{ 1 }; /**< Quality of the next export. */
+    int fitting_quality{ 0 }; /**< Highest quality known to fit, 0 if none. */
+    int failing_quality{ 11 }; /**< Lowest quality known not to fit, or one more than the requested quality. */
+    int last_quality{ 0 }; /**< Quality of the previous export. */
+    size_t last_triangles{ 0 }; /**< Triangles of the previous export, 0 before the first one. */
+};
+
+/**
+ * @brief Statistics of a mesh file referenced by the links, computed after all the meshes have been exported.
+ */
+struct MeshStatisticsJob {
+    std::string mesh_path{""}; ///< Path of the mesh file.
+    TriangleMesh mesh; ///< Content of the mesh, in the frame and units of the file.
+    size_t file_size{0}; ///< Size of the file in bytes.
+    std::string error{""}; ///< Reason of the failure, empty on success.
+};
+
+/**
+ * @brief Configuration file to parse, either the main one or one of its includes.
+ */
+struct YamlIncludeJob {
+    std::string path{""}; ///< Path of the file.
+    std::string content{""}; ///< Content of the file.
+    std::uint64_t hash{0}; ///< Hash of the content, key of the cache of the parsed files.
+    bool cached{false}; ///< True if the file was already parsed in a previous run.
+    YAML::Node node; ///< Parsed content.
+    std::string error{""}; ///< Reason of the failure, empty on success.
+};
+
+/**
+ * @brief Primitive fitting of the collision mesh of a link, computed after all the meshes have been exported.
+ */
+struct PrimitiveFittingJob {
+    std::string link_name{""}; ///< Name of the link in the URDF.
+    std::string mesh_path{""}; ///< Path of the exported collision mesh.
+    iDynTree::ExternalMesh collision_mesh; ///< Collision mesh of the link, used as fallback.
+    CollisionGeometryInfo geometry; ///< Fitted collision geometry, in the link frame.
+    double volume_error{0.0}; ///< Volume in excess of the fitted geometry, relative to the volume of the mesh.
+    std::string error{""}; ///< Reason of the failure, empty on success.
+};
+
+/**
+ * @brief Sphere tree of the collision mesh of a link, computed after all the meshes have been exported.
+ */
+struct SphereTreeJob {
+    std::string link_name{""}; ///< Name of the link in the URDF.
+    std::string mesh_path{""}; ///< Path of the exported collision mesh.
+    bool embed_in_urdf{false}; ///< Flag indicating whether the leaves replace the collision mesh in the URDF.
+    iDynTree::ExternalMesh collision_mesh; ///< Collision mesh of the link, used as fallback when the leaves are embedded.
+    SphereTree tree; ///< Sphere tree in the link frame, in meters.
+    std::string error{""}; ///< Reason of the failure, empty on success.
+};
+
+/**
+ * @brief Signed distance field of the collision mesh of a link, computed after all the meshes have been exported.
+ */
+struct SignedDistanceFieldJob {
+    std::string link_name{""}; ///< Name of the link in the URDF.
+    std::string mesh_path{""}; ///< Path of the exported collision mesh.
+    std::string sdf_path{""}; ///< Path of the binary grid written next to the mesh.
+    std::string error{""}; ///< Reason of the failure, empty on success.
+};
+
+/**
+ * @brief Mass properties of a link integrated from its mesh, computed after all the meshes have been exported.
+ */
+struct MeshInertiaJob {
+    std::string link_name{""}; ///< Name of the link in the URDF.
+    std::string mesh_path{""}; ///< Path of the exported visual mesh.
+    double density{0.0}; ///< Density of the link in kg/m^3, 0 means derived from the mass from Creo.
+    MassProperties unit_density_properties; ///< Mass properties in the link frame, in meters, with unit density.
+    std::string error{""}; ///< Reason of the failure, empty on success.
+};
+
+/**
+ * @brief Mesh file referenced by the links, compared with the other ones once all the meshes have been exported
+ * to find the reflections.
+ */
+struct MirroredMeshJob {
+    std::string level_name{""}; ///< Name of the quality level of the mesh, empty for the meshes without a level.
+    std::string uri{""}; ///< Filename of the mesh in the URDF.
+    std::string mesh_path{""}; ///< Path of the mesh file.
+    TriangleMesh mesh; ///< Content of the mesh, in the frame and units of the file.
+    CanonicalFrame frame; ///< Principal frame of the mesh.
+    std::string error{""}; ///< Reason of the failure, empty on success.
+};
+
+/**
+ * @brief Convex decomposition of the collision mesh of a link, computed after all the meshes have been exported.
+ */
+struct ConvexDecompositionJob {
+    std::string link_name{""}; ///< Name of the link in the URDF.
+    std::string mesh_path{""}; ///< Path of the exported collision mesh.
+    std::string hull_path_prefix{""}; ///< Path of the hull files without the index and the extension.
+    std::string hull_uri_prefix{""}; ///< Filename of the hulls in the URDF without the index and the extension.
+    iDynTree::ExternalMesh collision_mesh; ///< Collision mesh of the link, used as template for the hulls and as fallback.
+    size_t n_hulls{0}; ///< Number of hulls written by the decomposition.
+    bool cache_hit{false}; ///< Flag indicating whether the hulls have been copied from the cache.
+    std::string error{""}; ///< Reason of the failure, empty on success.
+};
+
 /**
  * @brief Enumeration representing types of joints and their allowed motion.
  */
@@ -264,6 +459,37 @@ struct LinkInfo {
     iDynTree::Transform rootAsm_H_linkFrame{iDynTree::Transform::Identity()}; ///< 3D Transform from the root to the link's reference frame.
     iDynTree::Transform csysAsm_H_linkFrame{iDynTree::Transform::Identity()}; ///< 3D Transform from the assembly to the link's reference frame.
     std::string link_frame_name{""}; ///< Name of the link frame.
+    iDynTree::Transform linkFrame_H_csysPart{iDynTree::Transform::Identity()}; ///< 3D Transform from the coordinate system of the part to the link's reference frame, inverted once per link.
+};
+
+/**
+ * @brief Mass properties of the parts queried from Creo while processing the assembly, expressed in the link frames all together once the traversal is done.
+ */
+struct CreoInertiaBatch {
+    std::vector<std::string> link_names; ///< Name of the link of each inertia.
+    std::vector<bool> check_consistency; ///< Whether an inertia that is not physically consistent is reported, false when the mesh replaces a missing one.
+    TransformBatch linkFrame_H_csysPart; ///< 3D Transform from the coordinate system of each part to its link frame.
+    InertiaBatch inertias; ///< Mass, center of mass and inertia tensor of each part, in the coordinate system of the part until expressed in the link frame.
+
+    void clear() { *this = CreoInertiaBatch(); }
+};
+
+/**
+ * @brief Coordinate systems of a part, listed once and indexed by name, so that many frames of the same part are resolved without listing them again.
+ */
+struct PartDatumTable {
+    std::vector<std::string> csys_names; ///< Names of the coordinate systems, in the order of the part.
+    TransformBatch csysPart_H_csys; ///< 3D Transform from the default coordinate system of the part to each coordinate system.
+    std::unordered_map<std::string, size_t> csys_index_map; ///< Map storing the index of each name, the first coordinate system wins.
+};
+
+/**
+ * @brief Names of a part and of its datums, collected by the preflight checks without querying masses or meshes.
+ */
+struct PreflightPartInfo {
+    std::string urdf_name{""}; ///< Name of the link in the URDF.
+    std::set<std::string> csys_names; ///< Names of the coordinate systems of the part.
+    std::set<std::string> axis_names; ///< Names of the axes of the part.
 };
 
 /**
@@ -403,8 +629,76 @@ void printRotationMatrix(pfcMatrix3D_ptr m);
  */
 void sanitizeSTL(std::string stl);
 
+/**
+ * @brief Counts the triangles of a STL file, either binary or ASCII.
+ *
+ * @param stl Path of the STL file
+ * @param binary True if the file is a binary STL, false if it is an ASCII STL
+ * @return std::pair<bool, size_t> Success flag and number of triangles of the file
+ */
+std::pair<bool, size_t> countSTLTriangles(const std::string& stl, bool binary);
+
+/**
+ * @brief Computes the diagonal of the bounding box of a solid, used as a measure of its size.
+ *
+ * @param modelhdl The solid of which to compute the size
+ * @param scale The factor used to scale the bounding box (e.g. from mm to m)
+ * @return std::pair<bool, double> Success flag and length of the diagonal
+ */
+std::pair<bool, double> getBoundingBoxDiagonal(pfcModel_ptr modelhdl, const array<double, 3>& scale);
+
+/**
+ * @brief Computes the mesh quality needed to tessellate a part within a chord tolerance.
+ * The quality grows with the ratio between the size of the part and the tolerance,
+ * see coarsest_relative_chord_tolerance and mesh_quality_steps_per_decade.
+ *
+ * @param size The size of the part, e.g. the diagonal of its bounding box
+ * @param chord_tolerance The maximum distance between the tessellation and the surface, in the same unit of size
+ * @return int The mesh quality, between 1 and 10
+ */
+int computeAdaptiveMeshQuality(double size, double chord_tolerance);
+
+/**
+ * @brief Computes the chord height of the tessellation of a part with a given mesh quality, inverting computeAdaptiveMeshQuality.
+ *
+ * @param size The size of the part, e.g. the diagonal of its bounding box
+ * @param quality The mesh quality, between 1 and 10
+ * @return double The maximum distance between the tessellation and the surface, in the same unit of size
+ */
+double computeChordHeight(double size, int quality);
+
+/**
+ * @brief Tessellates the surfaces of a part directly in memory with the Creo tessellation API, without writing a file.
+ *
+ * @param modelhdl The part to tessellate
+ * @param csys_name The name of the csys of the part in which the vertices are expressed, as for the STL export
+ * @param quality The mesh quality, between 1 and 10, mapped to the chord height and to the angle control of the tessellation
+ * @param[out] mesh The tessellation, in the units of the part
+ * @return bool True if successful, false otherwise
+ */
+bool tessellatePart(pfcModel_ptr modelhdl, const std::string& csys_name, int quality, TriangleMesh& mesh);
+
 std::pair<bool, std::string> getFirstCoordinateSystemName(pfcModel_ptr modelhdl);
 
+/**
+ * @brief Lists the coordinate systems of a part and their transforms in one pass.
+ *
+ * @param modelhdl The part model.
+ * @param scale The scaling factor for the position of the transforms.
+ * @param[out] table The coordinate systems of the part.
+ * @return bool True if the part has coordinate systems, false otherwise.
+ */
+bool getPartDatumTable(pfcModel_ptr modelhdl, const array<double, 3>& scale, PartDatumTable& table);
+
+/**
+ * @brief Gets a transform of a batch as an iDynTree transform.
+ *
+ * @param batch The batch of transforms.
+ * @param i The index of the transform.
+ * @return iDynTree::Transform The transform.
+ */
+iDynTree::Transform getTransformFromBatch(const TransformBatch& batch, size_t i);
+
 /**
  * @brief Retrieves the transformation from the owner assembly to a specified link frame in the context of a component path.
  *
@@ -436,15 +730,15 @@ std::pair<bool, iDynTree::Transform> getTransformFromPart(pfcModel_ptr modelhdl,
 
 /**
  * @brief Gets the desired axis the from the model.
- * The direction is expressed in the coordinate system defined by link_frame_name.
+ * The direction is expressed in the link frame.
  * 
- * @param modelhdl The model handle that contains link_frame_name
+ * @param modelhdl The model handle that contains the axis
  * @param axis_name The name of the desired axis of which to retrieve the direction
- * @param link_frame_name The name of the frame belonging to modelhdl
+ * @param linkFrame_H_csysPart The 3D transform from the coordinate system of the part to the link frame, see LinkInfo
  * @param scale The scaling factor for the origin of the child frame
  * @return std::tuple<bool, iDynTree::Direction, iDynTree::Position>>  Tuple containing a success/failure flag, the axis direction, and the position of the middle point of the axis in the link csys in order that the frame lies on the axis.
  */
-std::tuple<bool, iDynTree::Direction, iDynTree::Position> getAxisFromPart(pfcModel_ptr modelhdl, const std::string& axis_name, const std::string& link_frame_name, const array<double, 3>& scale);
+std::tuple<bool, iDynTree::Direction, iDynTree::Position> getAxisFromPart(pfcModel_ptr modelhdl, const std::string& axis_name, const iDynTree::Transform& linkFrame_H_csysPart, const array<double, 3>& scale);
 
 /**
  * @brief Extracts the folder path from a file path.
@@ -454,8 +748,40 @@ std::tuple<bool, iDynTree::Direction, iDynTree::Position> getAxisFromPart(pfcMod
  */
 std::string extractFolderPath(const std::string& filePath);
 
+/**
+ * @brief Creates a directory if it does not exist yet. The parent directory must exist.
+ *
+ * @param path The path of the directory to create.
+ * @return bool True if the directory exists at the end of the call, false otherwise.
+ */
+bool createDirectory(const std::string& path);
+
+/**
+ * @brief Copies a file, overwriting the destination.
+ * @param source The path of the file to copy.
+ * @param destination The path of the copy.
+ * @return True if the file was copied, false otherwise.
+ */
+bool copyFile(const std::string& source, const std::string& destination);
+
+/**
+ * @brief Reads the whole content of a file.
+ * @param path The path of the file to read.
+ * @return std::pair<bool, std::string> Success flag and bytes of the file.
+ */
+std::pair<bool, std::string> readFileContent(const std::string& path);
+
+/**
+ * @brief Hashes the content of a file.
+ * @param path The path of the file to hash.
+ * @return std::pair<bool, std::uint64_t> Success flag and hash of the bytes of the file.
+ */
+std::pair<bool, std::uint64_t> hashFile(const std::string& path);
+
 /**
  * @brief Merge two YAML nodes, recursively.
+ * Maps are merged key by key, sequences are appended and anything else is overwritten by src.
+ * The merged parts of src are shared with dest, so src must not be modified afterwards.
  * 
  * @param dest The destination YAML node.
  * @param src The source YAML node.
@@ -464,4 +790,12 @@ std::string extractFolderPath(const std::string& filePath);
  */
 void mergeYAMLNodes(YAML::Node& dest, const YAML::Node& src);
 
+/**
+ * @brief Emits a YAML node with the keys of its maps sorted, so that equivalent configurations give the same text.
+ *
+ * @param node The YAML node.
+ * @return std::string The normalized YAML document.
+ */
+std::string normalizeYAML(const YAML::Node& node);
+
 #endif // !UTILS_H
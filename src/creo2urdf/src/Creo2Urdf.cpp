@@ -16,8 +16,16 @@
 #include <iDynTree/EigenHelpers.h>
 #include <iDynTree/ModelTransformers.h>
 
+#include <creo2urdf/mesh/Parallel.h>
+
 #include <Eigen/Core>
 
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <regex>
+
 bool Creo2Urdf::processAsmItems(pfcModelItems_ptr asmListItems, pfcModel_ptr model_owner, iDynTree::Transform parentAsm_H_csysAsm) {
 
     for (int i = 0; i < asmListItems->getarraysize(); i++)
@@ -67,13 +75,7 @@ bool Creo2Urdf::processAsmItems(pfcModelItems_ptr asmListItems, pfcModel_ptr mod
         else {
             link_frame_name = "";
             urdf_link_name = getRenameElementFromConfig(link_name);
-            for (const auto& lf : config["linkFrames"]) {
-                if (lf["linkName"].Scalar() != urdf_link_name)
-                {
-                    continue;
-                }
-                link_frame_name = lf["frameName"].Scalar();
-            }
+            std::tie(std::ignore, link_frame_name) = export_config.linkFrame(urdf_link_name);
 
             if (link_frame_name.empty()) {
                 std::tie(ret, link_frame_name) = getFirstCoordinateSystemName(component_handle);
@@ -106,8 +108,6 @@ bool Creo2Urdf::processAsmItems(pfcModelItems_ptr asmListItems, pfcModel_ptr mod
             return false;
         }
 
-        auto mass_prop = pfcSolid::cast(component_handle)->GetMassProperty();
-
         std::tie(ret, csysPart_H_link_frame) = getTransformFromPart(component_handle, link_frame_name, scale);
         if (!ret && warningsAreFatal)
         {
@@ -115,17 +115,18 @@ bool Creo2Urdf::processAsmItems(pfcModelItems_ptr asmListItems, pfcModel_ptr mod
         }
 
         iDynTree::Link link;
-        link.setInertia(computeSpatialInertiafromCreo(mass_prop, csysPart_H_link_frame, urdf_link_name));
-
-        if (!link.getInertia().isPhysicallyConsistent())
-        {
-            printToMessageWindow(link_name + " is NOT physically consistent!", c2uLogLevel::WARN);
-            if (warningsAreFatal) {
-                return false;
-            }
+        auto linkFrame_H_csysPart = csysPart_H_link_frame.inverse();
+        bool mesh_inertia = meshInertia && (mesh_inertia_links.empty() || mesh_inertia_links.count(urdf_link_name) > 0);
+        if (mesh_inertia && mesh_inertia_substitute == "always") {
+            // The inertia is integrated from the mesh by runMeshInertias, without querying the mass properties
+        }
+        else {
+            auto mass_prop = pfcSolid::cast(component_handle)->GetMassProperty();
+            // Missing inertias are replaced by the ones of the meshes, and checked again by runMeshInertias
+            collectCreoInertia(mass_prop, linkFrame_H_csysPart, urdf_link_name, !(mesh_inertia && mesh_inertia_substitute == "missing"));
         }
 
-        LinkInfo l_info{ urdf_link_name, component_handle, parentAsm_H_linkFrame, csysAsm_H_linkFrame, link_frame_name };
+        LinkInfo l_info{ urdf_link_name, component_handle, parentAsm_H_linkFrame, csysAsm_H_linkFrame, link_frame_name, linkFrame_H_csysPart };
         link_info_map.insert(std::make_pair(link_name, l_info));
         populateExportedFrameInfoMap(component_handle);
 
@@ -144,11 +145,42 @@ void Creo2Urdf::OnCommand() {
 
     // Let's clear the map in case of multiple click
     if (joint_info_map.size() > 0) {
+        kinematic_graph.clear();
         joint_info_map.clear();
         link_info_map.clear();
         exported_frame_info_map.clear();
         assigned_inertias_map.clear();
+        creo_inertia_batch.clear();
         assigned_collision_geometry_map.clear();
+        mesh_quality_levels.clear();
+        assigned_mesh_quality_map.clear();
+        primitive_fitting_shapes.clear();
+        primitive_fitting_links.clear();
+        primitive_fitting_jobs.clear();
+        convex_decomposition_links.clear();
+        convex_decomposition_jobs.clear();
+        sphere_tree_links.clear();
+        sphere_tree_jobs.clear();
+        signed_distance_field_links.clear();
+        signed_distance_field_jobs.clear();
+        allowed_collision_matrix_links.clear();
+        allowed_collision_matrix_meshes.clear();
+        mesh_inertia_densities_map.clear();
+        mesh_inertia_links.clear();
+        mesh_inertia_jobs.clear();
+        deduplicated_mesh_map.clear();
+        deduplicated_part_map.clear();
+        link_H_geometry_map.clear();
+        mirrored_meshes_links.clear();
+        mirrored_mesh_jobs.clear();
+        mesh_cache_hits = 0;
+        mesh_cache_misses = 0;
+        mesh_cache_invalid = 0;
+        mesh_uri_path_map.clear();
+        output_side_files.clear();
+        assigned_mesh_budget_map.clear();
+        mesh_buffer_map.clear();
+        unwritten_mesh_map.clear();
     }
     m_session_ptr = pfcGetProESession();
     if (!m_session_ptr) {
@@ -188,7 +220,6 @@ void Creo2Urdf::OnCommand() {
         csv_file_open_option->SetDialogLabel("Select the csv");
         m_csv_path = string(m_session_ptr->UIOpenFile(csv_file_open_option));
     }
-    rapidcsv::Document joints_csv_table(m_csv_path, rapidcsv::LabelParams(0, 0));
     // Output folder path
     if (m_output_path.empty()) {
         auto output_folder_open_option = pfcDirectorySelectionOptions::Create();
@@ -196,6 +227,12 @@ void Creo2Urdf::OnCommand() {
         m_output_path = string(m_session_ptr->UISelectDirectory(output_folder_open_option));
     }
     printToMessageWindow("Output path is: " + m_output_path);
+    if (!writeMergedConfig()) {
+        printToMessageWindow("Failed to write the merged configuration", c2uLogLevel::WARN);
+    }
+    else {
+        output_side_files.insert(m_output_path + "\\" + merged_config_output_file);
+    }
     
 
     iDynRedirectErrors idyn_redirect;
@@ -255,6 +292,25 @@ void Creo2Urdf::OnCommand() {
         exportFirstBaseLinkAdditionalFrameAsFakeURDFBase = config["exportFirstBaseLinkAdditionalFrameAsFakeURDFBase"].as<bool>();
     }
 
+    if (config["preflight"].IsDefined()) {
+        preflight = config["preflight"].as<bool>();
+    }
+
+    if (config["deduplicateMeshes"].IsDefined()) {
+        deduplicateMeshes = config["deduplicateMeshes"].as<bool>();
+    }
+
+    if (config["meshBackend"].IsDefined()) {
+        const auto& backend = config["meshBackend"].Scalar();
+        if (backend != "export" && backend != "tessellation") {
+            printToMessageWindow("meshBackend must be export or tessellation", c2uLogLevel::WARN);
+            if (warningsAreFatal) {
+                return;
+            }
+        }
+        tessellateMeshes = backend == "tessellation";
+    }
+
     if (config["urdfNumericalPrecision"].IsDefined())
     {
         urdfNumericalPrecision = config["urdfNumericalPrecision"].as<int>();
@@ -268,11 +324,58 @@ void Creo2Urdf::OnCommand() {
     readExportedFramesFromConfig();
     readAssignedInertiasFromConfig();
     readAssignedCollisionGeometryFromConfig();
+    if (!readMeshQualityLevelsFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readAdaptiveMeshQualityFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readMeshInertiaFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readPrimitiveFittingFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readConvexDecompositionFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readSphereTreesFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readJointParametersFromCsv() && warningsAreFatal) {
+        return;
+    }
+    if (!readSignedDistanceFieldsFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readAllowedCollisionMatrixFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readMirroredMeshesFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readMeshCacheFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readMeshBudgetFromConfig() && warningsAreFatal) {
+        return;
+    }
+    if (!readBundleFromConfig() && warningsAreFatal) {
+        return;
+    }
 
     Sensorizer sensorizer;
 
     sensorizer.readFTSensorsFromConfig(config);
     sensorizer.readSensorsFromConfig(config);
+    if (!sensorizer.readSensorArraysFromConfig(config, extractFolderPath(m_yaml_path)) && warningsAreFatal) {
+        return;
+    }
+
+    if (!runPreflight(asm_component_list, sensorizer) && warningsAreFatal) {
+        printToMessageWindow("The configuration references elements that are not in the assembly", c2uLogLevel::WARN);
+        return;
+    }
 
     // Let's traverse the model tree and get all links and axis properties
     bool ok = processAsmItems(asm_component_list, m_root_asm_model_ptr);
@@ -281,35 +384,82 @@ void Creo2Urdf::OnCommand() {
         return;
     }
 
-    // Now we have to add joints to the iDynTree model
+    if (!runCreoInertias() && warningsAreFatal) {
+        printToMessageWindow("Failed to process the assembly", c2uLogLevel::WARN);
+        return;
+    }
+
+    kinematic_graph.build(link_info_map, joint_info_map, exported_frame_info_map, export_config);
+
+    // The links and the joints are added in topological order from the root, so that their indexes do not depend on the names in Creo
+    std::vector<GraphIndex> link_order;
+    std::vector<GraphIndex> joint_order;
+    kinematic_graph.topologicalOrder(config["root"].IsDefined() ? config["root"].Scalar() : "root_link", link_order, joint_order);
+    orderModelLinks(link_order);
+
+    if (meshCache) {
+        size_t n_meshes = mesh_cache_hits + mesh_cache_misses;
+        printToMessageWindow("Mesh cache: " + to_string(mesh_cache_hits) + " of " + to_string(n_meshes) + " meshes from cache (" +
+                             to_string(n_meshes > 0 ? 100 * mesh_cache_hits / n_meshes : 0) + "%), " + to_string(mesh_cache_invalid) + " invalid entries discarded");
+    }
+
+    if (!runMeshInertias() && warningsAreFatal) {
+        printToMessageWindow("Failed to compute the inertias from the meshes", c2uLogLevel::WARN);
+        return;
+    }
+
+    if (!runPrimitiveFittings() && warningsAreFatal) {
+        printToMessageWindow("Failed to fit the collision primitives", c2uLogLevel::WARN);
+        return;
+    }
+
+    if (!runConvexDecompositions() && warningsAreFatal) {
+        printToMessageWindow("Failed to decompose the collision meshes", c2uLogLevel::WARN);
+        return;
+    }
+
+    if (!runSphereTrees() && warningsAreFatal) {
+        printToMessageWindow("Failed to compute the sphere trees", c2uLogLevel::WARN);
+        return;
+    }
+
+    if (!runSignedDistanceFields() && warningsAreFatal) {
+        printToMessageWindow("Failed to compute the signed distance fields", c2uLogLevel::WARN);
+        return;
+    }
 
-    for (auto & joint_info : joint_info_map) {
-        auto parent_link_name = joint_info.second.parent_link_name;
-        auto child_link_name = joint_info.second.child_link_name;
-        auto datum_name = joint_info.second.datum_name;
-        auto joint_name = getRenameElementFromConfig(joint_info.first);
+    // Now we have to add joints to the iDynTree model, in topological order so that identical robots give identical models
+    auto joint_rest_transforms = computeJointRestTransforms();
 
+    for (const auto& joint_info : joint_info_map) {
         // This handles the case of a "cut" assembly, where we have an axis but we miss the child link.
-        if (child_link_name.empty() || link_info_map.find(parent_link_name) == link_info_map.end() || link_info_map.find(child_link_name) == link_info_map.end()) {
-            printToMessageWindow("Skipping joint " + joint_name + " child link name " + child_link_name + " parent link name " + parent_link_name , c2uLogLevel::WARN);
-            continue;
+        if (kinematic_graph.findJoint(joint_info.first) == invalidGraphIndex) {
+            printToMessageWindow("Skipping joint " + getRenameElementFromConfig(joint_info.first) + " child link name " + joint_info.second.child_link_name +
+                                 " parent link name " + joint_info.second.parent_link_name , c2uLogLevel::WARN);
         }
+    }
+
+    for (GraphIndex joint_index : joint_order) {
+        const auto& graph_joint = kinematic_graph.joints()[joint_index];
+        const auto& joint_info = *graph_joint.info;
+        const auto& parent_link_name = joint_info.parent_link_name;
+        const auto& datum_name = joint_info.datum_name;
+        const auto& joint_name = kinematic_graph.name(graph_joint.urdf_name);
 
-        auto asm_owner_H_parent_link = link_info_map.at(parent_link_name).rootAsm_H_linkFrame;
-        auto asm_owner_H_child_link = link_info_map.at(child_link_name).rootAsm_H_linkFrame;
-        auto parent_model = link_info_map.at(parent_link_name).modelhdl;
-        auto parent_link_frame = link_info_map.at(parent_link_name).link_frame_name;
+        const auto& parent_link = kinematic_graph.links()[graph_joint.parent_link];
+        const auto& child_link = kinematic_graph.links()[graph_joint.child_link];
+        const auto& urdf_parent_link_name = kinematic_graph.name(parent_link.urdf_name);
+        const auto& urdf_child_link_name = kinematic_graph.name(child_link.urdf_name);
+        auto parent_model = parent_link.info->modelhdl;
+        auto parent_link_frame = parent_link.info->link_frame_name;
 
-        //printToMessageWindow("Parent link H " + asm_owner_H_parent_link.toString());
-        //printToMessageWindow("Child  link H " + asm_owner_H_child_link.toString());
-        iDynTree::Transform parentLink_H_childLink = iDynTree::Transform::Identity();
-        parentLink_H_childLink = asm_owner_H_parent_link.inverse() * asm_owner_H_child_link;
+        const iDynTree::Transform& parentLink_H_childLink = joint_rest_transforms[joint_index];
 
-        if (joint_info.second.type == JointType::Revolute || joint_info.second.type == JointType::Linear) {
+        if (joint_info.type == JointType::Revolute || joint_info.type == JointType::Linear) {
 
             iDynTree::Direction direction;
             iDynTree::Position axis_mid_point_pos_in_parent;
-            std::tie(ret, direction, axis_mid_point_pos_in_parent) = getAxisFromPart(parent_model, datum_name, parent_link_frame, scale);
+            std::tie(ret, direction, axis_mid_point_pos_in_parent) = getAxisFromPart(parent_model, datum_name, parent_link.info->linkFrame_H_csysPart, scale);
 
             if (!ret)
             {
@@ -322,14 +472,11 @@ void Creo2Urdf::OnCommand() {
                 }
             }
 
-            if (config["reverseRotationAxis"].IsDefined() && 
-                config["reverseRotationAxis"].Scalar().find(joint_name) != std::string::npos)
+            if (export_config.isRotationAxisReversed(joint_name))
             {
                 direction = direction.reverse();
             }
 
-            auto urdf_parent_link_name = getRenameElementFromConfig(parent_link_name);
-
             iDynTree::Axis idyn_axis{ direction, parentLink_H_childLink.getPosition() };
 
             // Check if the axis is aligned with the link frame
@@ -339,52 +486,52 @@ void Creo2Urdf::OnCommand() {
             }
 
             std::shared_ptr<iDynTree::IJoint> joint_sh_ptr;
-            if (joint_info.second.type == JointType::Revolute) {
+            if (joint_info.type == JointType::Revolute) {
                 joint_sh_ptr = std::make_shared<iDynTree::RevoluteJoint>();
                 dynamic_cast<iDynTree::RevoluteJoint*>(joint_sh_ptr.get())->setAxis(idyn_axis);
             }
-            else if (joint_info.second.type == JointType::Linear) {
+            else if (joint_info.type == JointType::Linear) {
                 joint_sh_ptr = std::make_shared<iDynTree::PrismaticJoint>();
                 dynamic_cast<iDynTree::PrismaticJoint*>(joint_sh_ptr.get())->setAxis(idyn_axis);
             }
 
             joint_sh_ptr->setRestTransform(parentLink_H_childLink);
             double conversion_factor = 1.0;
-            if (joint_info.second.type == JointType::Revolute) {
+            if (joint_info.type == JointType::Revolute) {
                 conversion_factor = deg2rad;
             }
 
             // Read limits from CSV data, until it is possible to do so from Creo directly
-            setJointParametersFromCsv(joints_csv_table, joint_name, *joint_sh_ptr, conversion_factor);
+            setJointParametersFromCsv(joint_parameter_table, joint_name, *joint_sh_ptr, conversion_factor);
 
-            if (idyn_model.addJoint(getRenameElementFromConfig(parent_link_name),
-                getRenameElementFromConfig(child_link_name), joint_name, joint_sh_ptr.get()) == iDynTree::JOINT_INVALID_INDEX) {
+            if (idyn_model.addJoint(urdf_parent_link_name,
+                urdf_child_link_name, joint_name, joint_sh_ptr.get()) == iDynTree::JOINT_INVALID_INDEX) {
                 printToMessageWindow("FAILED TO ADD JOINT " + joint_name, c2uLogLevel::WARN);
                 if (warningsAreFatal) {
                     return;
                 }
             }
         }
-        else if (joint_info.second.type == JointType::Fixed) {
+        else if (joint_info.type == JointType::Fixed) {
             iDynTree::FixedJoint joint(parentLink_H_childLink);
-            if (idyn_model.addJoint(getRenameElementFromConfig(parent_link_name),
-                getRenameElementFromConfig(child_link_name), joint_name, &joint) == iDynTree::JOINT_INVALID_INDEX) {
+            if (idyn_model.addJoint(urdf_parent_link_name,
+                urdf_child_link_name, joint_name, &joint) == iDynTree::JOINT_INVALID_INDEX) {
                 printToMessageWindow("FAILED TO ADD JOINT " + joint_name, c2uLogLevel::WARN);
                 if (warningsAreFatal) {
                     return;
                 }
             }
         }
-            else if (joint_info.second.type == JointType::Spherical) {
+            else if (joint_info.type == JointType::Spherical) {
             iDynTree::SphericalJoint joint;
             joint.setAttachedLinks(
-                idyn_model.getLinkIndex(getRenameElementFromConfig(parent_link_name)),
-                idyn_model.getLinkIndex(getRenameElementFromConfig(child_link_name))
+                idyn_model.getLinkIndex(urdf_parent_link_name),
+                idyn_model.getLinkIndex(urdf_child_link_name)
             );
             joint.setRestTransform(parentLink_H_childLink);
             iDynTree::Transform parent_link_H_joint_center = iDynTree::Transform::Identity();
             std::tie(ret, parent_link_H_joint_center) = getTransformFromPart(parent_model, datum_name, scale);
-            joint.setJointCenter(idyn_model.getLinkIndex(getRenameElementFromConfig(parent_link_name)), parent_link_H_joint_center.getPosition());
+            joint.setJointCenter(idyn_model.getLinkIndex(urdf_parent_link_name), parent_link_H_joint_center.getPosition());
             if (idyn_model.addJoint(joint_name, &joint) == iDynTree::JOINT_INVALID_INDEX) {
                 printToMessageWindow("FAILED TO ADD JOINT " + joint_name, c2uLogLevel::WARN);
                 if (warningsAreFatal) {
@@ -394,10 +541,39 @@ void Creo2Urdf::OnCommand() {
         }
     }
 
+    if (!computeAllowedCollisionMatrix() && warningsAreFatal) {
+        printToMessageWindow("Failed to compute the allowed collision matrix", c2uLogLevel::WARN);
+        return;
+    }
+
+    if (!runMirroredMeshes() && warningsAreFatal) {
+        printToMessageWindow("Failed to share the mirrored meshes", c2uLogLevel::WARN);
+        return;
+    }
+
+    if (!writeMeshBuffers()) {
+        printToMessageWindow("Failed to write the meshes", c2uLogLevel::WARN);
+        return;
+    }
+
+    if (!runMeshBudget() && warningsAreFatal) {
+        printToMessageWindow("The meshes exceed their budget", c2uLogLevel::WARN);
+        return;
+    }
+
     // Assign the transforms for the sensors
-    sensorizer.assignTransformToSensors(exported_frame_info_map, link_info_map, scale);
+    sensorizer.assignTransformToSensors(kinematic_graph, scale);
     // Assign the transforms for the ft sensors
-    sensorizer.assignTransformToFTSensor(exported_frame_info_map, link_info_map, joint_info_map, scale);
+    sensorizer.assignTransformToFTSensor(kinematic_graph, scale);
+    // Generate the sensors of the arrays, whose transforms are resolved together
+    if (!sensorizer.expandSensorArrays(kinematic_graph, scale) && warningsAreFatal) {
+        printToMessageWindow("Failed to generate the sensor arrays", c2uLogLevel::WARN);
+        return;
+    }
+    // Parse the blobs of the sensors once, whatever the number of sensors sharing them
+    if (!sensorizer.parseSensorXMLBlobs() && warningsAreFatal) {
+        return;
+    }
 
     // Let's add sensors and ft sensors frames
 
@@ -469,15 +645,23 @@ void Creo2Urdf::OnCommand() {
 
     // Add FTs and other sensors as XML blobs for now
 
-    std::vector<std::string> ft_xml_blobs = sensorizer.buildFTXMLBlobs();
+    // The blobs are moved in the options, thousands of sensors give thousands of strings
+    export_options.xmlBlobs = sensorizer.buildFTXMLBlobs();
     std::vector<std::string> sens_xml_blobs = sensorizer.buildSensorsXMLBlobs();
+    export_options.xmlBlobs.reserve(export_options.xmlBlobs.size() + sens_xml_blobs.size() + 1);
+    std::move(sens_xml_blobs.begin(), sens_xml_blobs.end(), std::back_inserter(export_options.xmlBlobs));
 
-    export_options.xmlBlobs.insert(export_options.xmlBlobs.end(), ft_xml_blobs.begin(), ft_xml_blobs.end());
-    export_options.xmlBlobs.insert(export_options.xmlBlobs.end(), sens_xml_blobs.begin(), sens_xml_blobs.end());
-    
     if (config["XMLBlobs"].IsDefined()) {
         auto config_xml_blobs = config["XMLBlobs"].as<std::vector<std::string>>();
-        export_options.xmlBlobs.insert(export_options.xmlBlobs.end(), config_xml_blobs.begin(), config_xml_blobs.end());
+        // The blobs that are not well formed are reported and skipped, as the blobs of the sensors
+        std::string xml, error;
+        for (size_t i = 0; i < config_xml_blobs.size(); i++) {
+            if (!parseXMLFragment(config_xml_blobs[i], xml, error)) {
+                printToMessageWindow("Skipping XMLBlobs entry " + to_string(i) + " that is not well formed (" + error + ")\n" + config_xml_blobs[i], c2uLogLevel::WARN);
+                continue;
+            }
+            export_options.xmlBlobs.push_back(std::move(config_xml_blobs[i]));
+        }
         // Adding gazebo pose as xml blob at the end of the urdf.
         std::string gazebo_pose_xml_str{""};
         gazebo_pose_xml_str = to_string(originXYZ[0]) + " " + to_string(originXYZ[1]) + " " + to_string(originXYZ[2]) + " " + to_string(originRPY[0]) + " " + to_string(originRPY[1]) + " " + to_string(originRPY[2]);
@@ -485,27 +669,33 @@ void Creo2Urdf::OnCommand() {
         export_options.xmlBlobs.push_back(gazebo_pose_xml_str);
     }
 
-    exportModelToUrdf(idyn_model, export_options);
+    if (exportModelToUrdf(idyn_model, export_options) && !exportBundle()) {
+        printToMessageWindow("Failed to write the bundle", c2uLogLevel::WARN);
+    }
 
     // Let's clear the map in case of multiple click TODO UNIFY
     m_yaml_path.clear();
     m_csv_path.clear();
     m_output_path.clear();
     config = YAML::Node();
+    kinematic_graph.clear();
+    export_config.clear();
+    joint_parameter_table.clear();
     m_root_asm_model_ptr = nullptr;
 
     return;
 }
 
-bool Creo2Urdf::setJointParametersFromCsv(const rapidcsv::Document& csv, const std::string& joint_name, 
+bool Creo2Urdf::setJointParametersFromCsv(const JointParameterTable& table, const std::string& joint_name, 
     iDynTree::IJoint& joint, double conversion_factor = 1.0)
 {
-    if (csv.GetRowIdx(joint_name) < 0) return false;
+    auto parameters = table.find(joint_name);
+    if (parameters == nullptr) return false;
 
-    double min = csv.GetCell<double>("lower_limit", joint_name) * conversion_factor;
-    double max = csv.GetCell<double>("upper_limit", joint_name) * conversion_factor;
+    double min = parameters->lower_limit * conversion_factor;
+    double max = parameters->upper_limit * conversion_factor;
 
-    if (!std::isinf(min) && !std::isinf(max))
+    if (std::isfinite(min) && std::isfinite(max))
     {
         joint.enablePosLimits(true);
         joint.setPosLimits(0, min, max);
@@ -514,9 +704,119 @@ bool Creo2Urdf::setJointParametersFromCsv(const rapidcsv::Document& csv, const s
     //joint.setRestTransform();
 
     joint.setJointDynamicsType(iDynTree::URDFJointDynamics);
-    joint.setDamping(0, csv.GetCell<double>("damping", joint_name));
-    joint.setStaticFriction(0, csv.GetCell<double>("friction", joint_name));
+    if (!std::isnan(parameters->damping)) {
+        joint.setDamping(0, parameters->damping);
+    }
+    if (!std::isnan(parameters->friction)) {
+        joint.setStaticFriction(0, parameters->friction);
+    }
+
+    return true;
+}
+
+bool Creo2Urdf::readJointParametersFromCsv()
+{
+    std::vector<std::string> problems;
+    std::vector<std::string> warnings;
+    bool ok = joint_parameter_table.load(m_csv_path, problems, warnings);
+    for (const auto& warning : warnings) {
+        printToMessageWindow(warning, c2uLogLevel::WARN);
+    }
+    for (const auto& problem : problems) {
+        printToMessageWindow(problem, c2uLogLevel::WARN);
+    }
+    printToMessageWindow("Joint parameters: " + to_string(joint_parameter_table.jointNames().size()) + " joints read from " + m_csv_path);
+    return ok;
+}
+
+bool Creo2Urdf::writeJointLimitsToUrdf(std::string& urdf) const
+{
+    if (!joint_parameter_table.hasColumn("velocity_limit") && !joint_parameter_table.hasColumn("effort_limit")) {
+        return true;
+    }
+
+    // Shortest decimal representation that reads back as the same double, without exponent for the integer digits
+    auto format_number = [](double value) {
+        char buffer[32];
+        int integer_digits = (std::abs(value) >= 1.0 && std::abs(value) < 1e15) ? static_cast<int>(std::floor(std::log10(std::abs(value)))) + 1 : 1;
+        for (int precision = integer_digits; precision <= 17; precision++) {
+            std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+            if (std::strtod(buffer, nullptr) == value) {
+                break;
+            }
+        }
+        return std::string(buffer);
+    };
+    // Value of an attribute in the text of a start tag, the exporter writes the values between double quotes
+    auto find_attribute = [](const std::string& tag, const std::string& name, size_t& value_begin, size_t& value_end) {
+        size_t pos = tag.find(" " + name + "=\"");
+        if (pos == std::string::npos) {
+            return false;
+        }
+        value_begin = pos + name.size() + 3;
+        value_end = tag.find('"', value_begin);
+        return value_end != std::string::npos;
+    };
+    // Sets an attribute in the text of a start tag, adding it at the end of the tag if missing
+    auto set_attribute = [&find_attribute](std::string& tag, const std::string& name, const std::string& value) {
+        size_t value_begin = 0;
+        size_t value_end = 0;
+        if (find_attribute(tag, name, value_begin, value_end)) {
+            tag.replace(value_begin, value_end - value_begin, value);
+            return;
+        }
+        size_t tag_end = tag.size() - (tag.compare(tag.size() - 2, 2, "/>") == 0 ? 2 : 1);
+        tag.insert(tag_end, " " + name + "=\"" + value + "\"");
+    };
+
+    // Only the limit elements are edited in the text of the exporter, the rest of the URDF is left as it is.
+    // The joints of the model are the ones with a type, unlike e.g. the joints of the transmissions in the XML blobs
+    size_t n_joints = 0;
+    for (size_t joint_begin = urdf.find("<joint "); joint_begin != std::string::npos; joint_begin = urdf.find("<joint ", joint_begin + 1)) {
+        size_t joint_tag_end = urdf.find('>', joint_begin);
+        if (joint_tag_end == std::string::npos) {
+            break;
+        }
+        std::string joint_tag = urdf.substr(joint_begin, joint_tag_end - joint_begin + 1);
+        size_t name_begin = 0, name_end = 0, type_begin = 0, type_end = 0;
+        if (urdf[joint_tag_end - 1] == '/' || !find_attribute(joint_tag, "name", name_begin, name_end) || !find_attribute(joint_tag, "type", type_begin, type_end)) {
+            continue;
+        }
+        auto parameters = joint_parameter_table.find(joint_tag.substr(name_begin, name_end - name_begin));
+        if (parameters == nullptr || joint_tag.compare(type_begin, type_end - type_begin, "fixed") == 0 ||
+            (std::isnan(parameters->velocity_limit) && std::isnan(parameters->effort_limit))) {
+            continue;
+        }
+        size_t joint_end = urdf.find("</joint>", joint_tag_end);
+        if (joint_end == std::string::npos) {
+            break;
+        }
+
+        size_t limit_begin = urdf.find("<limit", joint_tag_end);
+        std::string limit_tag;
+        if (limit_begin != std::string::npos && limit_begin < joint_end) {
+            limit_tag = urdf.substr(limit_begin, urdf.find('>', limit_begin) - limit_begin + 1);
+        }
+        else {
+            // A new element, indented as the other children of the joint
+            size_t line_begin = urdf.rfind('\n', joint_end) + 1;
+            std::string indent = urdf.substr(line_begin, joint_end - line_begin);
+            limit_tag = "<limit/>";
+            urdf.insert(line_begin, indent + "  " + limit_tag + "\n");
+            limit_begin = line_begin + indent.size() + 2;
+        }
+        size_t limit_tag_size = limit_tag.size();
+        if (!std::isnan(parameters->effort_limit)) {
+            set_attribute(limit_tag, "effort", format_number(parameters->effort_limit));
+        }
+        if (!std::isnan(parameters->velocity_limit)) {
+            set_attribute(limit_tag, "velocity", format_number(parameters->velocity_limit));
+        }
+        urdf.replace(limit_begin, limit_tag_size, limit_tag);
+        n_joints++;
+    }
 
+    printToMessageWindow("Joint parameters: velocity and effort limits written for " + to_string(n_joints) + " joints");
     return true;
 }
 
@@ -546,70 +846,158 @@ bool Creo2Urdf::exportModelToUrdf(iDynTree::Model mdl, iDynTree::ModelExporterOp
         return false;
     }
 
-    if (!mdl_exporter.exportModelToFile(m_output_path+ "\\" + "model.urdf"))
+    // The URDF is exported in memory, so that the limits of the joint parameters are added before it is written once
+    std::string urdf;
+    if (!mdl_exporter.exportModelToString(urdf))
     {
         printToMessageWindow("Error exporting the urdf. See iDynTreeErrors.txt for details", c2uLogLevel::WARN);
         return false;
     }
 
+    if (!writeJointLimitsToUrdf(urdf))
+    {
+        printToMessageWindow("Failed to write the velocity and effort limits in the urdf", c2uLogLevel::WARN);
+        return false;
+    }
+
+    std::string urdf_path = m_output_path + "\\" + "model.urdf";
+    std::ofstream urdf_file(urdf_path, std::ios::out | std::ios::binary);
+    urdf_file << urdf;
+    if (!urdf_file)
+    {
+        printToMessageWindow("Unable to write " + urdf_path, c2uLogLevel::WARN);
+        return false;
+    }
+
     printToMessageWindow("Urdf created successfully!");
     return true;
 }
 
-iDynTree::SpatialInertia Creo2Urdf::computeSpatialInertiafromCreo(pfcMassProperty_ptr mass_prop, iDynTree::Transform H, const std::string& link_name) {
+void Creo2Urdf::collectCreoInertia(pfcMassProperty_ptr mass_prop, const iDynTree::Transform& linkFrame_H_csysPart, const std::string& link_name, bool check_consistency) {
     auto com = mass_prop->GetGravityCenter();
     auto inertia_tensor = mass_prop->GetCenterGravityInertiaTensor();
 
-    iDynTree::RotationalInertiaRaw idyn_inertia_tensor_csysPart_orientation = iDynTree::RotationalInertiaRaw::Zero();
-    iDynTree::RotationalInertiaRaw idyn_inertia_tensor_link_orientation = iDynTree::RotationalInertiaRaw::Zero();
-
-    bool assigned_inertia_flag = assigned_inertias_map.find(link_name) != assigned_inertias_map.end();
-    for (int i_row = 0; i_row < idyn_inertia_tensor_csysPart_orientation.rows(); i_row++) {
-        for (int j_col = 0; j_col < idyn_inertia_tensor_csysPart_orientation.cols(); j_col++) {
-            if ((assigned_inertia_flag) && (i_row == j_col)) {
-                // The assigned inertia is already expressed in the link frame
-                idyn_inertia_tensor_link_orientation.setVal(i_row, j_col, assigned_inertias_map.at(link_name)[i_row]);
-            }
-            else {
-                idyn_inertia_tensor_csysPart_orientation.setVal(i_row, j_col, inertia_tensor->get(i_row, j_col) * scale[i_row] * scale[j_col]);
-            }
+    Eigen::Matrix3d inertia_tensor_csysPart;
+    for (int i_row = 0; i_row < 3; i_row++) {
+        for (int j_col = 0; j_col < 3; j_col++) {
+            inertia_tensor_csysPart(i_row, j_col) = inertia_tensor->get(i_row, j_col) * scale[i_row] * scale[j_col];
         }
     }
 
-    iDynTree::Position com_child({ com->get(0) * scale[0] , com->get(1) * scale[1], com->get(2) * scale[2] });
-
-    // Account for csysPart_H_link_frame transformation
+    // The COM returned by Creo's GetGravityCenter seems to be expressed in the root frame, so we need
+    // to transform it back to the link frame before passing it to iDynTree's fromRotationalInertiaWrtCenterOfMass.
+    // This is done by runCreoInertias for all the links together
     // See https://github.com/mesh-iit/ergocub-software/issues/224#issuecomment-1985692598 for full contents
+    Eigen::Vector3d com_csysPart(com->get(0) * scale[0], com->get(1) * scale[1], com->get(2) * scale[2]);
 
-    // The COM returned by Creo's GetGravityCenter seems to be expressed in the root frame, so we need 
-    // to transform it back to the link frame before passing it to iDynTree's fromRotationalInertiaWrtCenterOfMass
-    com_child = H.inverse() * com_child;
+    double mass{ 0.0 };
+    bool mass_assigned{ false };
+    std::tie(mass_assigned, mass) = export_config.assignedMass(link_name);
+    if (!mass_assigned) {
+        mass = mass_prop->GetMass();
+    }
+
+    creo_inertia_batch.link_names.push_back(link_name);
+    creo_inertia_batch.check_consistency.push_back(check_consistency);
+    creo_inertia_batch.linkFrame_H_csysPart.append(iDynTree::toEigen(linkFrame_H_csysPart.getRotation()), iDynTree::toEigen(linkFrame_H_csysPart.getPosition()));
+    creo_inertia_batch.inertias.append(mass, com_csysPart, inertia_tensor_csysPart);
+}
+
+bool Creo2Urdf::runCreoInertias() {
+    auto& batch = creo_inertia_batch;
 
     // The inertia returned by Creo's GetCenterGravityInertiaTensor seems to be expressed with the COM as the
     // point in which it is expressed, and with the orientation of the CSYS of the part, so we rotate it back with
-    // the orientation of the link frame, unless an assignedInertia is used
-    if (!assigned_inertia_flag) {
-        // Note, this auto-defined methods are Eigen::Map, so they are reference to data that remains
-        // stored in the original iDynTree object, see https://eigen.tuxfamily.org/dox/group__TutorialMapClass.html
-        auto inertia_tensor_root = iDynTree::toEigen(idyn_inertia_tensor_csysPart_orientation);
-        auto inertia_tensor_link = iDynTree::toEigen(idyn_inertia_tensor_link_orientation);
-        auto csysPart_R_link = iDynTree::toEigen(H.getRotation());
+    // the orientation of the link frame, see Equation 15 of https://ocw.mit.edu/courses/16-07-dynamics-fall-2009/dd277ec654440f4c2b5b07d6c286c3fd_MIT16_07F09_Lec26.pdf
+    transformInertias(batch.linkFrame_H_csysPart, batch.inertias);
+
+    bool ok = true;
+    for (size_t i = 0; i < batch.link_names.size(); i++) {
+        const auto& link_name = batch.link_names[i];
+        iDynTree::RotationalInertiaRaw idyn_inertia_tensor_link_orientation = iDynTree::RotationalInertiaRaw::Zero();
+        auto assigned_inertia = assigned_inertias_map.find(link_name);
+        if (assigned_inertia != assigned_inertias_map.end()) {
+            // The assigned inertia is already expressed in the link frame
+            for (int i_diag = 0; i_diag < 3; i_diag++) {
+                idyn_inertia_tensor_link_orientation.setVal(i_diag, i_diag, assigned_inertia->second[i_diag]);
+            }
+        }
+        else {
+            iDynTree::toEigen(idyn_inertia_tensor_link_orientation) = batch.inertias.getTensor(i);
+        }
 
-        // See Equation 15 of https://ocw.mit.edu/courses/16-07-dynamics-fall-2009/dd277ec654440f4c2b5b07d6c286c3fd_MIT16_07F09_Lec26.pdf
-        inertia_tensor_link = csysPart_R_link.transpose()*inertia_tensor_root*csysPart_R_link;
+        Eigen::Vector3d com_link = batch.inertias.getCenterOfMass(i);
+        iDynTree::Position com_child(com_link.x(), com_link.y(), com_link.z());
+        double mass = batch.inertias.mass[i];
+        iDynTree::SpatialInertia sp_inertia(mass, com_child, idyn_inertia_tensor_link_orientation);
+        sp_inertia.fromRotationalInertiaWrtCenterOfMass(mass, com_child, idyn_inertia_tensor_link_orientation);
+
+        auto link_index = idyn_model.getLinkIndex(link_name);
+        if (link_index != iDynTree::LINK_INVALID_INDEX) {
+            idyn_model.getLink(link_index)->setInertia(sp_inertia);
+        }
+        if (batch.check_consistency[i] && !sp_inertia.isPhysicallyConsistent())
+        {
+            printToMessageWindow(link_name + " is NOT physically consistent!", c2uLogLevel::WARN);
+            ok = false;
+        }
     }
+    batch.clear();
+    return ok;
+}
 
-    double mass{ 0.0 };
-    if (config["assignedMasses"][link_name].IsDefined()) {
-        mass = config["assignedMasses"][link_name].as<double>();
+void Creo2Urdf::orderModelLinks(const std::vector<GraphIndex>& link_order) {
+    iDynTree::Model ordered_model;
+    auto& visual_shapes = idyn_model.visualSolidShapes().getLinkSolidShapes();
+    auto& collision_shapes = idyn_model.collisionSolidShapes().getLinkSolidShapes();
+    for (GraphIndex l : link_order) {
+        const auto& link_name = kinematic_graph.name(kinematic_graph.links()[l].urdf_name);
+        auto link_index = idyn_model.getLinkIndex(link_name);
+        if (link_index == iDynTree::LINK_INVALID_INDEX) {
+            continue;
+        }
+        auto ordered_link_index = ordered_model.addLink(link_name, *idyn_model.getLink(link_index));
+        if (ordered_link_index == iDynTree::LINK_INVALID_INDEX) {
+            continue;
+        }
+        // The shapes are moved, the model being replaced does not own them anymore
+        ordered_model.visualSolidShapes().getLinkSolidShapes()[ordered_link_index] = std::move(visual_shapes[link_index]);
+        visual_shapes[link_index].clear();
+        ordered_model.collisionSolidShapes().getLinkSolidShapes()[ordered_link_index] = std::move(collision_shapes[link_index]);
+        collision_shapes[link_index].clear();
     }
-    else {
-        mass = mass_prop->GetMass();
+    idyn_model = ordered_model;
+}
+
+std::vector<iDynTree::Transform> Creo2Urdf::computeJointRestTransforms() const {
+    const auto& links = kinematic_graph.links();
+    const auto& joints = kinematic_graph.joints();
+
+    TransformBatch rootAsm_H_linkFrame;
+    rootAsm_H_linkFrame.resize(links.size());
+    for (size_t l = 0; l < links.size(); l++) {
+        const auto& H = links[l].info->rootAsm_H_linkFrame;
+        rootAsm_H_linkFrame.set(l, iDynTree::toEigen(H.getRotation()), iDynTree::toEigen(H.getPosition()));
     }
-    iDynTree::SpatialInertia sp_inertia(mass, com_child, idyn_inertia_tensor_link_orientation);
-    sp_inertia.fromRotationalInertiaWrtCenterOfMass(mass, com_child, idyn_inertia_tensor_link_orientation);
+    TransformBatch linkFrame_H_rootAsm;
+    invertTransforms(rootAsm_H_linkFrame, linkFrame_H_rootAsm);
+
+    std::vector<std::uint32_t> parent_links, child_links;
+    parent_links.reserve(joints.size());
+    child_links.reserve(joints.size());
+    for (const auto& joint : joints) {
+        parent_links.push_back(joint.parent_link);
+        child_links.push_back(joint.child_link);
+    }
+    TransformBatch parentLink_H_childLink;
+    composeTransforms(linkFrame_H_rootAsm, parent_links, rootAsm_H_linkFrame, child_links, parentLink_H_childLink);
 
-    return sp_inertia;
+    std::vector<iDynTree::Transform> rest_transforms;
+    rest_transforms.reserve(joints.size());
+    for (size_t j = 0; j < joints.size(); j++) {
+        rest_transforms.push_back(getTransformFromBatch(parentLink_H_childLink, j));
+    }
+    return rest_transforms;
 }
 
 void Creo2Urdf::populateExportedFrameInfoMap(pfcModel_ptr modelhdl) {
@@ -643,13 +1031,11 @@ void Creo2Urdf::populateExportedFrameInfoMap(pfcModel_ptr modelhdl) {
             auto& link_info = link_info_map.at(link_name);
             bool ret{ false };
             iDynTree::Transform csys_H_additionalFrame {iDynTree::Transform::Identity()};
-            iDynTree::Transform csys_H_linkFrame {iDynTree::Transform::Identity()};
             iDynTree::Transform linkFrame_H_additionalFrame {iDynTree::Transform::Identity()};
 
             std::tie(ret, csys_H_additionalFrame) = getTransformFromPart(modelhdl, csys_name, scale);
-            std::tie(ret, csys_H_linkFrame) = getTransformFromPart(modelhdl, link_info.link_frame_name, scale);
 
-            linkFrame_H_additionalFrame = csys_H_linkFrame.inverse() * csys_H_additionalFrame;
+            linkFrame_H_additionalFrame = link_info.linkFrame_H_csysPart * csys_H_additionalFrame;
             exported_frame_info.linkFrame_H_additionalFrame = linkFrame_H_additionalFrame;
 
         }
@@ -685,6 +1071,10 @@ void Creo2Urdf::readAssignedCollisionGeometryFromConfig() {
         case ShapeType::Sphere:
             cgi.radius = cg["geometricShape"]["radius"].as<double>();
             break;
+        case ShapeType::Capsule:
+            cgi.radius = cg["geometricShape"]["radius"].as<double>();
+            cgi.length = cg["geometricShape"]["length"].as<double>();
+            break;
         case ShapeType::None:
             break;
         default:
@@ -720,102 +1110,1908 @@ void Creo2Urdf::readExportedFramesFromConfig() {
     }
 }
 
-bool Creo2Urdf::addMeshAndExport(pfcModel_ptr component_handle, const std::string& mesh_transform)
-{
-    bool export_mesh = true;
-    std::string file_extension = ".stl";
-    std::string meshFormat = "stl_binary";
-    std::string link_name = component_handle->GetFullName();
-    std::string renamed_link_name = link_name;
- 
-    if (config["rename"][link_name].IsDefined())
-    {
-        renamed_link_name = config["rename"][link_name].Scalar();
+bool Creo2Urdf::readMeshQualityLevelsFromConfig() {
+    if (!config["meshQualityLevels"].IsDefined()) {
+        return true;
     }
+    bool ok = true;
+    for (const auto& ql : config["meshQualityLevels"]) {
+        MeshQualityLevel level;
+        if (ql["name"].IsDefined()) {
+            level.name = ql["name"].Scalar();
+        }
+        if (level.name.empty()) {
+            printToMessageWindow("meshQualityLevels: every level must have a name", c2uLogLevel::WARN);
+            ok = false;
+            continue;
+        }
+        if (!ql["quality"].IsDefined()) {
+            printToMessageWindow("meshQualityLevels: level " + level.name + " must have a quality", c2uLogLevel::WARN);
+            ok = false;
+            continue;
+        }
 
-    if (config["exportMeshes"].IsDefined())
-    {
-        export_mesh = config["exportMeshes"].as<bool>();
-    }
+        try {
+            level.quality = ql["quality"].as<int>();
+            if (ql["linkOverrides"].IsDefined()) {
+                level.linkOverrides = ql["linkOverrides"].as<std::map<std::string, int>>();
+            }
+        }
+        catch (const YAML::Exception& bad_value) {
+            printToMessageWindow("meshQualityLevels: level " + level.name + " is not valid, " + bad_value.msg, c2uLogLevel::WARN);
+            ok = false;
+            continue;
+        }
 
+        bool quality_in_range = level.quality >= 1 && level.quality <= 10;
+        for (const auto& lo : level.linkOverrides) {
+            quality_in_range = quality_in_range && lo.second >= 1 && lo.second <= 10;
+        }
+        if (!quality_in_range) {
+            printToMessageWindow("meshQualityLevels: the quality of level " + level.name + " must be between 1 and 10", c2uLogLevel::WARN);
+            ok = false;
+            continue;
+        }
 
-    if (config["stringToRemoveFromMeshFileName"].IsDefined())
-    {
-        link_name.erase(link_name.find(config["stringToRemoveFromMeshFileName"].Scalar()), 
-            config["stringToRemoveFromMeshFileName"].Scalar().length());
-    }
+        if (level.name != "visual" && level.name != "collision") {
+            printToMessageWindow("meshQualityLevels: level " + level.name + " is exported as side files, only the levels visual and collision are referenced by the URDF");
+        }
 
-    // Make all alphabetic characters lowercase
-    if (config["forcelowercase"].IsDefined() && config["forcelowercase"].as<bool>())
-    {
-        std::transform(link_name.begin(), link_name.end(), link_name.begin(),
-            [](unsigned char c) { return std::tolower(c); });
+        mesh_quality_levels.push_back(level);
     }
+    return ok;
+}
 
-    if (config["meshFormat"].IsDefined()) {
-        meshFormat = config["meshFormat"].Scalar();
-        if (mesh_types_supported_extension_map.find(meshFormat) != mesh_types_supported_extension_map.end()) {
-            file_extension = mesh_types_supported_extension_map.at(meshFormat);
-        }
-        else {
-            printToMessageWindow("Mesh format " + meshFormat + " is not supported", c2uLogLevel::WARN);
-            if (warningsAreFatal) {
-                return false;
-            }
+bool Creo2Urdf::readAdaptiveMeshQualityFromConfig() {
+    bool ok = true;
+    if (config["meshQualityMode"].IsDefined()) {
+        const auto& mode = config["meshQualityMode"].Scalar();
+        if (mode != "fixed" && mode != "adaptive") {
+            printToMessageWindow("meshQualityMode must be fixed or adaptive", c2uLogLevel::WARN);
+            ok = false;
         }
+        adaptiveMeshQuality = mode == "adaptive";
     }
-    // Assign name
-    string file_format = "%s";
-    int mesh_quality = 3;
-    if (config["filenameformat"].IsDefined()) {
-        file_format = config["filenameformat"].Scalar();
+
+    if (config["chordTolerance"].IsDefined()) {
+        chordTolerance = config["chordTolerance"].as<double>();
+        if (chordTolerance <= 0.0) {
+            printToMessageWindow("chordTolerance must be positive", c2uLogLevel::WARN);
+            ok = false;
+        }
     }
-    else if (meshFormat != "step") {
-        // We use ExportIntf3D for step format, applies the extension to the file name.
-        file_format += file_extension;
+
+    if (config["maxTrianglesPerPart"].IsDefined()) {
+        maxTrianglesPerPart = config["maxTrianglesPerPart"].as<size_t>();
     }
 
-    if (config["meshQuality"].IsDefined()) {
-        mesh_quality = config["meshQuality"].as<int>();
-        if (mesh_quality < 1 || mesh_quality > 10) {
-            printToMessageWindow("Mesh quality is too low, or too hight, the range is between 1 and 10", c2uLogLevel::WARN);
-            if (warningsAreFatal) {
-                printToMessageWindow("Aborting the mesh exportation", c2uLogLevel::WARN);
-                return false;
+    if (config["assignedMeshQuality"].IsDefined()) {
+        assigned_mesh_quality_map = config["assignedMeshQuality"].as<std::map<std::string, int>>();
+        for (const auto& amq : assigned_mesh_quality_map) {
+            if (amq.second < 1 || amq.second > 10) {
+                printToMessageWindow("assignedMeshQuality of " + amq.first + " must be between 1 and 10", c2uLogLevel::WARN);
+                ok = false;
             }
         }
     }
+    return ok;
+}
 
-    // We assume there is only one of occurrence to replace
-    file_format.replace(file_format.find("%s"), 2, link_name); // 2 is sizeof %s, in this way we keep the formatting extension
+bool Creo2Urdf::readMeshInertiaFromConfig() {
+    meshInertia = config["meshInertia"].IsDefined();
+    if (!meshInertia) {
+        return true;
+    }
 
-    if (export_mesh)
-    {
-        std::string mesh_file_name = file_format;
-        if (file_format.find("/") != std::string::npos)
-        {
-            mesh_file_name = file_format.substr(file_format.find_last_of("/") + 1);
+    bool ok = true;
+    const auto& mi = config["meshInertia"];
+    if (mi["density"].IsDefined()) {
+        mesh_inertia_density = mi["density"].as<double>();
+    }
+    if (mi["assignedDensities"].IsDefined()) {
+        for (const auto& density : mi["assignedDensities"]) {
+            mesh_inertia_densities_map[density.first.Scalar()] = density.second.as<double>();
         }
-        mesh_file_name = m_output_path + "\\" + mesh_file_name;
-
-        try {
-            if (meshFormat == "stl_binary") {
+    }
+    if (mi["tolerance"].IsDefined()) {
+        mesh_inertia_tolerance = mi["tolerance"].as<double>();
+    }
+    if (mi["comTolerance"].IsDefined()) {
+        mesh_inertia_com_tolerance = mi["comTolerance"].as<double>();
+    }
+    if (mi["substitute"].IsDefined()) {
+        mesh_inertia_substitute = mi["substitute"].Scalar();
+    }
+    if (mi["links"].IsDefined()) {
+        auto links = mi["links"].as<std::vector<std::string>>();
+        mesh_inertia_links.insert(links.begin(), links.end());
+    }
+    if (mi["reportFile"].IsDefined()) {
+        mesh_inertia_report_file = mi["reportFile"].Scalar();
+    }
+
+    if (mesh_inertia_density < 0.0) {
+        printToMessageWindow("meshInertia: density must not be negative", c2uLogLevel::WARN);
+        ok = false;
+    }
+    for (const auto& density : mesh_inertia_densities_map) {
+        if (density.second <= 0.0) {
+            printToMessageWindow("meshInertia: the density of " + density.first + " must be positive", c2uLogLevel::WARN);
+            ok = false;
+        }
+    }
+    if (mesh_inertia_tolerance < 0.0 || mesh_inertia_com_tolerance < 0.0) {
+        printToMessageWindow("meshInertia: tolerance and comTolerance must not be negative", c2uLogLevel::WARN);
+        ok = false;
+    }
+    if (mesh_inertia_substitute != "never" && mesh_inertia_substitute != "missing" && mesh_inertia_substitute != "always") {
+        printToMessageWindow("meshInertia: substitute must be one of never, missing, always", c2uLogLevel::WARN);
+        ok = false;
+    }
+    if (mesh_inertia_substitute == "always" && mesh_inertia_density == 0.0) {
+        printToMessageWindow("meshInertia: the density is required when substitute is always", c2uLogLevel::WARN);
+        ok = false;
+    }
+    return ok;
+}
+
+bool Creo2Urdf::runMeshInertias() {
+    if (mesh_inertia_jobs.empty()) {
+        return true;
+    }
+
+    // The integrals are computed with unit density, the mass is known only once the density is chosen
+    parallelFor(mesh_inertia_jobs.size(), [&](size_t j) {
+        auto& job = mesh_inertia_jobs[j];
+        TriangleMesh mesh;
+        if (!readMeshInLinkFrame(job.link_name, job.mesh_path, mesh)) {
+            job.error = "unable to read " + job.mesh_path;
+            return;
+        }
+        if (!computeMassProperties(mesh, 1.0, job.unit_density_properties)) {
+            job.error = "the mesh " + job.mesh_path + " is not closed";
+        }
+    });
+
+    std::ofstream report(m_output_path + "\\" + mesh_inertia_report_file);
+    report << "link,creo_mass,mesh_mass,mass_error,com_error,inertia_error,substituted" << std::endl;
+
+    bool ok = true;
+    size_t n_flagged = 0;
+    for (const auto& job : mesh_inertia_jobs) {
+        auto link = idyn_model.getLink(idyn_model.getLinkIndex(job.link_name));
+        iDynTree::SpatialInertia creo_inertia = link->getInertia();
+        bool has_creo_inertia = mesh_inertia_substitute != "always" && creo_inertia.getMass() > 0.0 && creo_inertia.isPhysicallyConsistent();
+        bool substitute = mesh_inertia_substitute == "always" || (mesh_inertia_substitute == "missing" && !has_creo_inertia);
+
+        std::string error = job.error;
+        const auto& properties = job.unit_density_properties;
+        // Without a density the one of the whole part is derived from the mass from Creo
+        double density = job.density;
+        if (error.empty() && density == 0.0) {
+            if (has_creo_inertia) {
+                density = creo_inertia.getMass() / properties.volume;
+            }
+            else {
+                error = "the mass from Creo is missing, assign a density";
+            }
+        }
+        if (!error.empty()) {
+            printToMessageWindow("Inertia from the mesh of " + job.link_name + " failed: " + error, c2uLogLevel::WARN);
+            report << job.link_name << "," << creo_inertia.getMass() << ",,,,," << std::endl;
+            // A link whose inertia had to be replaced is left without a valid one
+            if (substitute || warningsAreFatal) {
+                ok = false;
+            }
+            continue;
+        }
+
+        iDynTree::Position com(properties.centerOfMass.x(), properties.centerOfMass.y(), properties.centerOfMass.z());
+        iDynTree::RotationalInertiaRaw inertia_wrt_com = iDynTree::RotationalInertiaRaw::Zero();
+        iDynTree::toEigen(inertia_wrt_com) = density * properties.inertia;
+        iDynTree::SpatialInertia mesh_spatial_inertia;
+        mesh_spatial_inertia.fromRotationalInertiaWrtCenterOfMass(density * properties.volume, com, inertia_wrt_com);
+
+        report << job.link_name << "," << creo_inertia.getMass() << "," << mesh_spatial_inertia.getMass() << ",";
+        if (has_creo_inertia) {
+            double mass_error = std::abs(mesh_spatial_inertia.getMass() - creo_inertia.getMass()) / creo_inertia.getMass();
+            double com_error = (iDynTree::toEigen(mesh_spatial_inertia.getCenterOfMass()) - iDynTree::toEigen(creo_inertia.getCenterOfMass())).norm();
+            Eigen::Matrix3d creo_inertia_wrt_com = iDynTree::toEigen(creo_inertia.getRotationalInertiaWrtCenterOfMass());
+            double inertia_error = (density * properties.inertia - creo_inertia_wrt_com).norm() / creo_inertia_wrt_com.norm();
+            report << mass_error << "," << com_error << "," << inertia_error << ",";
+
+            if (mass_error > mesh_inertia_tolerance || com_error > mesh_inertia_com_tolerance || inertia_error > mesh_inertia_tolerance) {
+                printToMessageWindow("The inertia from Creo of " + job.link_name + " differs from the one of its mesh: mass error " + to_string(mass_error) +
+                                     ", center of mass error " + to_string(com_error) + " m, inertia error " + to_string(inertia_error), c2uLogLevel::WARN);
+                n_flagged++;
+            }
+        }
+        else {
+            report << ",,,";
+        }
+        report << (substitute ? "true" : "false") << std::endl;
+
+        if (substitute) {
+            if (!mesh_spatial_inertia.isPhysicallyConsistent()) {
+                printToMessageWindow("The inertia from the mesh of " + job.link_name + " is NOT physically consistent!", c2uLogLevel::WARN);
+                if (warningsAreFatal) {
+                    ok = false;
+                }
+            }
+            link->setInertia(mesh_spatial_inertia);
+        }
+    }
+
+    printToMessageWindow("Inertias from the meshes computed for " + to_string(mesh_inertia_jobs.size()) + " links, " + to_string(n_flagged) +
+                         " differ from Creo beyond the tolerances, see " + mesh_inertia_report_file);
+    mesh_inertia_jobs.clear();
+    if (!report) {
+        printToMessageWindow("Unable to write " + mesh_inertia_report_file, c2uLogLevel::WARN);
+        return false;
+    }
+    output_side_files.insert(m_output_path + "\\" + mesh_inertia_report_file);
+    return ok;
+}
+
+bool Creo2Urdf::readPrimitiveFittingFromConfig() {
+    primitiveFitting = config["primitiveFitting"].IsDefined();
+    if (!primitiveFitting) {
+        return true;
+    }
+
+    bool ok = true;
+    const auto& pf = config["primitiveFitting"];
+    std::vector<std::string> shapes{ "box", "cylinder", "sphere", "capsule" };
+    if (pf["shapes"].IsDefined()) {
+        shapes = pf["shapes"].as<std::vector<std::string>>();
+    }
+    for (const auto& shape : shapes) {
+        switch (stringToEnum<ShapeType>(shape_type_map, shape)) {
+        case ShapeType::Box:
+            primitive_fitting_shapes.push_back(PrimitiveShape::Box);
+            break;
+        case ShapeType::Cylinder:
+            primitive_fitting_shapes.push_back(PrimitiveShape::Cylinder);
+            break;
+        case ShapeType::Sphere:
+            primitive_fitting_shapes.push_back(PrimitiveShape::Sphere);
+            break;
+        case ShapeType::Capsule:
+            primitive_fitting_shapes.push_back(PrimitiveShape::Capsule);
+            break;
+        default:
+            printToMessageWindow("primitiveFitting: shape " + shape + " is not supported, the allowed shapes are box, cylinder, sphere and capsule", c2uLogLevel::WARN);
+            ok = false;
+            break;
+        }
+    }
+    if (primitive_fitting_shapes.empty()) {
+        printToMessageWindow("primitiveFitting: at least one shape must be allowed", c2uLogLevel::WARN);
+        primitiveFitting = false;
+        ok = false;
+    }
+    if (pf["links"].IsDefined()) {
+        auto links = pf["links"].as<std::vector<std::string>>();
+        primitive_fitting_links.insert(links.begin(), links.end());
+    }
+    if (pf["outputFile"].IsDefined()) {
+        primitive_fitting_output_file = pf["outputFile"].Scalar();
+    }
+    return ok;
+}
+
+bool Creo2Urdf::runPrimitiveFittings() {
+    if (primitive_fitting_jobs.empty()) {
+        return true;
+    }
+
+    // Creo is not thread safe, so the workers only touch files and their own job
+    parallelFor(primitive_fitting_jobs.size(), [&](size_t j) {
+        auto& job = primitive_fitting_jobs[j];
+        TriangleMesh mesh;
+        if (!readMeshInLinkFrame(job.link_name, job.mesh_path, mesh)) {
+            job.error = "unable to read " + job.mesh_path;
+            return;
+        }
+
+        FittedPrimitive primitive;
+        if (!fitBestPrimitive(mesh, primitive_fitting_shapes, primitive)) {
+            job.error = "the mesh is degenerate";
+            return;
+        }
+
+        const auto& R = primitive.rotation;
+        job.geometry.link_H_geometry = iDynTree::Transform(iDynTree::Rotation(R(0, 0), R(0, 1), R(0, 2),
+                                                                              R(1, 0), R(1, 1), R(1, 2),
+                                                                              R(2, 0), R(2, 1), R(2, 2)),
+                                                           iDynTree::Position(primitive.position.x(), primitive.position.y(), primitive.position.z()));
+        job.geometry.size = { primitive.size.x(), primitive.size.y(), primitive.size.z() };
+        job.geometry.radius = primitive.radius;
+        job.geometry.length = primitive.length;
+        job.volume_error = primitive.volumeError;
+        switch (primitive.shape) {
+        case PrimitiveShape::Box:
+            job.geometry.shape = ShapeType::Box;
+            break;
+        case PrimitiveShape::Cylinder:
+            job.geometry.shape = ShapeType::Cylinder;
+            break;
+        case PrimitiveShape::Sphere:
+            job.geometry.shape = ShapeType::Sphere;
+            break;
+        case PrimitiveShape::Capsule:
+            job.geometry.shape = ShapeType::Capsule;
+            break;
+        }
+    });
+
+    // The fitted geometries use the same layout of assignedCollisionGeometry, so that they can be copied in the configuration
+    YAML::Emitter fitted_yaml;
+    fitted_yaml.SetDoublePrecision(6);
+    fitted_yaml << YAML::BeginMap << YAML::Key << "assignedCollisionGeometry" << YAML::Value << YAML::BeginSeq;
+    for (auto& job : primitive_fitting_jobs) {
+        if (!job.error.empty()) {
+            printToMessageWindow("Primitive fitting of " + job.link_name + " failed: " + job.error + ", the collision mesh is kept", c2uLogLevel::WARN);
+            idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(job.link_name)].push_back(job.collision_mesh.clone());
+            if (warningsAreFatal) {
+                return false;
+            }
+            continue;
+        }
+        addCollisionGeometry(job.link_name, job.geometry);
+
+        const auto& position = job.geometry.link_H_geometry.getPosition();
+        auto rpy = job.geometry.link_H_geometry.getRotation().asRPY();
+        fitted_yaml << YAML::BeginMap << YAML::Key << "linkName" << YAML::Value << job.link_name;
+        fitted_yaml << YAML::Key << "geometricShape" << YAML::Value << YAML::BeginMap;
+        fitted_yaml << YAML::Key << "shape" << YAML::Value << shape_type_map.at(job.geometry.shape);
+        if (job.geometry.shape == ShapeType::Box) {
+            fitted_yaml << YAML::Key << "size" << YAML::Value << YAML::Flow << std::vector<double>(job.geometry.size.begin(), job.geometry.size.end());
+        }
+        else {
+            fitted_yaml << YAML::Key << "radius" << YAML::Value << job.geometry.radius;
+            if (job.geometry.shape != ShapeType::Sphere) {
+                fitted_yaml << YAML::Key << "length" << YAML::Value << job.geometry.length;
+            }
+        }
+        fitted_yaml << YAML::Key << "origin" << YAML::Value << YAML::Flow << std::vector<double>{ position[0], position[1], position[2], rpy[0], rpy[1], rpy[2] };
+        fitted_yaml << YAML::Comment("volume error " + to_string(job.volume_error));
+        fitted_yaml << YAML::EndMap << YAML::EndMap;
+    }
+    fitted_yaml << YAML::EndSeq << YAML::EndMap;
+    primitive_fitting_jobs.clear();
+
+    if (!primitive_fitting_output_file.empty()) {
+        std::string fitted_path = m_output_path + "\\" + primitive_fitting_output_file;
+        std::ofstream fitted_file(fitted_path);
+        fitted_file << fitted_yaml.c_str() << std::endl;
+        if (!fitted_file) {
+            printToMessageWindow("Unable to write " + fitted_path, c2uLogLevel::WARN);
+            return false;
+        }
+        output_side_files.insert(fitted_path);
+        printToMessageWindow("Fitted collision geometries saved in " + fitted_path);
+    }
+    return true;
+}
+
+bool Creo2Urdf::readSphereTreesFromConfig() {
+    sphereTrees = config["sphereTrees"].IsDefined();
+    if (!sphereTrees) {
+        return true;
+    }
+
+    bool ok = true;
+    const auto& st = config["sphereTrees"];
+    if (st["maxSpheres"].IsDefined()) {
+        sphere_tree_parameters.maxSpheres = st["maxSpheres"].as<size_t>();
+    }
+    if (st["maxOverApproximation"].IsDefined()) {
+        sphere_tree_parameters.maxOverApproximation = st["maxOverApproximation"].as<double>();
+    }
+    if (st["links"].IsDefined()) {
+        auto links = st["links"].as<std::vector<std::string>>();
+        sphere_tree_links.insert(links.begin(), links.end());
+    }
+    if (st["outputFile"].IsDefined()) {
+        sphere_tree_output_file = st["outputFile"].Scalar();
+    }
+    if (st["embedInURDF"].IsDefined()) {
+        sphereTreesInURDF = st["embedInURDF"].as<bool>();
+    }
+
+    if (sphere_tree_parameters.maxSpheres < 1) {
+        printToMessageWindow("sphereTrees: maxSpheres must be at least 1", c2uLogLevel::WARN);
+        ok = false;
+    }
+    if (sphere_tree_parameters.maxOverApproximation < 0.0) {
+        printToMessageWindow("sphereTrees: maxOverApproximation must not be negative", c2uLogLevel::WARN);
+        ok = false;
+    }
+    return ok;
+}
+
+bool Creo2Urdf::runSphereTrees() {
+    if (sphere_tree_jobs.empty()) {
+        return true;
+    }
+
+    // Each link is computed independently, so the result does not depend on the scheduling of the threads
+    parallelFor(sphere_tree_jobs.size(), [&](size_t j) {
+        auto& job = sphere_tree_jobs[j];
+        TriangleMesh mesh;
+        if (!readMeshInLinkFrame(job.link_name, job.mesh_path, mesh)) {
+            job.error = "unable to read " + job.mesh_path;
+            return;
+        }
+        job.tree = computeSphereTree(mesh, sphere_tree_parameters);
+    });
+
+    YAML::Emitter trees_yaml;
+    trees_yaml.SetDoublePrecision(6);
+    trees_yaml << YAML::Comment("Sphere trees in the link frames, in meters. Each node is [x, y, z, radius, parent], the root has parent -1");
+    trees_yaml << YAML::BeginMap;
+    for (auto& job : sphere_tree_jobs) {
+        if (!job.error.empty()) {
+            printToMessageWindow("Sphere tree of " + job.link_name + " failed: " + job.error, c2uLogLevel::WARN);
+            if (job.embed_in_urdf) {
+                idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(job.link_name)].push_back(job.collision_mesh.clone());
+            }
+            if (warningsAreFatal) {
+                return false;
+            }
+            continue;
+        }
+
+        std::vector<size_t> leaves;
+        trees_yaml << YAML::Key << job.link_name << YAML::Value << YAML::BeginMap;
+        trees_yaml << YAML::Key << "nodes" << YAML::Value << YAML::BeginSeq;
+        for (size_t i = 0; i < job.tree.nodes.size(); i++) {
+            const auto& node = job.tree.nodes[i];
+            trees_yaml << YAML::Flow << std::vector<double>{ node.center.x(), node.center.y(), node.center.z(), node.radius, static_cast<double>(node.parent) };
+            if (node.nChildren == 0) {
+                leaves.push_back(i);
+            }
+        }
+        trees_yaml << YAML::EndSeq;
+        trees_yaml << YAML::Key << "leaves" << YAML::Value << YAML::Flow << leaves;
+        trees_yaml << YAML::EndMap;
+
+        if (job.embed_in_urdf) {
+            for (const auto& leaf : getSphereTreeLeaves(job.tree)) {
+                CollisionGeometryInfo sphere;
+                sphere.shape = ShapeType::Sphere;
+                sphere.radius = leaf.radius;
+                sphere.link_H_geometry.setPosition(iDynTree::Position(leaf.center.x(), leaf.center.y(), leaf.center.z()));
+                addCollisionGeometry(job.link_name, sphere);
+            }
+        }
+    }
+    trees_yaml << YAML::EndMap;
+    sphere_tree_jobs.clear();
+
+    std::string trees_path = m_output_path + "\\" + sphere_tree_output_file;
+    std::ofstream trees_file(trees_path);
+    trees_file << trees_yaml.c_str() << std::endl;
+    if (!trees_file) {
+        printToMessageWindow("Unable to write " + trees_path, c2uLogLevel::WARN);
+        return false;
+    }
+    output_side_files.insert(trees_path);
+    printToMessageWindow("Sphere trees saved in " + trees_path);
+    return true;
+}
+
+bool Creo2Urdf::readSignedDistanceFieldsFromConfig() {
+    signedDistanceFields = config["signedDistanceFields"].IsDefined();
+    if (!signedDistanceFields) {
+        return true;
+    }
+
+    bool ok = true;
+    const auto& sdf = config["signedDistanceFields"];
+    if (sdf["resolution"].IsDefined()) {
+        signed_distance_field_parameters.resolution = sdf["resolution"].as<double>();
+    }
+    if (sdf["narrowBand"].IsDefined()) {
+        signed_distance_field_parameters.narrowBand = sdf["narrowBand"].as<double>();
+    }
+    // By default the grid extends up to the narrow band around the mesh
+    signed_distance_field_parameters.padding = signed_distance_field_parameters.narrowBand;
+    if (sdf["padding"].IsDefined()) {
+        signed_distance_field_parameters.padding = sdf["padding"].as<double>();
+    }
+    if (sdf["links"].IsDefined()) {
+        auto links = sdf["links"].as<std::vector<std::string>>();
+        signed_distance_field_links.insert(links.begin(), links.end());
+    }
+
+    if (signed_distance_field_parameters.resolution <= 0.0) {
+        printToMessageWindow("signedDistanceFields: resolution must be positive", c2uLogLevel::WARN);
+        ok = false;
+    }
+    if (signed_distance_field_parameters.narrowBand <= 0.0 || signed_distance_field_parameters.padding < 0.0) {
+        printToMessageWindow("signedDistanceFields: narrowBand must be positive and padding must not be negative", c2uLogLevel::WARN);
+        ok = false;
+    }
+    return ok;
+}
+
+bool Creo2Urdf::runSignedDistanceFields() {
+    if (signed_distance_field_jobs.empty()) {
+        return true;
+    }
+
+    // The links are processed in parallel, and the threads left are used for the slices of each field
+    unsigned n_threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned n_link_threads = static_cast<unsigned>(std::min<size_t>(n_threads, signed_distance_field_jobs.size()));
+    unsigned n_slice_threads = std::max(1u, n_threads / n_link_threads);
+
+    parallelFor(signed_distance_field_jobs.size(), [&](size_t j) {
+        auto& job = signed_distance_field_jobs[j];
+        TriangleMesh mesh;
+        if (!readMeshInLinkFrame(job.link_name, job.mesh_path, mesh)) {
+            job.error = "unable to read " + job.mesh_path;
+            return;
+        }
+
+        SignedDistanceField field;
+        if (!computeSignedDistanceField(mesh, signed_distance_field_parameters, field, n_slice_threads)) {
+            job.error = "the grid is larger than " + to_string(signed_distance_field_parameters.maxSamples) + " samples, increase the resolution";
+            return;
+        }
+        if (!writeSignedDistanceField(job.sdf_path, field)) {
+            job.error = "unable to write " + job.sdf_path;
+        }
+    }, n_link_threads);
+
+    bool ok = true;
+    for (const auto& job : signed_distance_field_jobs) {
+        if (!job.error.empty()) {
+            printToMessageWindow("Signed distance field of " + job.link_name + " failed: " + job.error, c2uLogLevel::WARN);
+            ok = false;
+            continue;
+        }
+        output_side_files.insert(job.sdf_path);
+    }
+    printToMessageWindow("Signed distance fields computed for " + to_string(signed_distance_field_jobs.size()) + " links");
+    signed_distance_field_jobs.clear();
+    return ok;
+}
+
+bool Creo2Urdf::readAllowedCollisionMatrixFromConfig() {
+    allowedCollisionMatrix = config["allowedCollisionMatrix"].IsDefined();
+    if (!allowedCollisionMatrix) {
+        return true;
+    }
+
+    bool ok = true;
+    const auto& acm = config["allowedCollisionMatrix"];
+    if (acm["samples"].IsDefined()) {
+        allowed_collision_matrix_samples = acm["samples"].as<size_t>();
+    }
+    if (acm["alwaysInCollisionRatio"].IsDefined()) {
+        allowed_collision_matrix_always_ratio = acm["alwaysInCollisionRatio"].as<double>();
+    }
+    if (acm["seed"].IsDefined()) {
+        allowed_collision_matrix_seed = acm["seed"].as<unsigned>();
+    }
+    if (acm["links"].IsDefined()) {
+        auto links = acm["links"].as<std::vector<std::string>>();
+        allowed_collision_matrix_links.insert(links.begin(), links.end());
+    }
+    allowed_collision_matrix_output_file = (config["robotName"].IsDefined() ? config["robotName"].Scalar() : std::string("model")) + ".srdf";
+    if (acm["outputFile"].IsDefined()) {
+        allowed_collision_matrix_output_file = acm["outputFile"].Scalar();
+    }
+
+    if (allowed_collision_matrix_samples < 1) {
+        printToMessageWindow("allowedCollisionMatrix: samples must be at least 1", c2uLogLevel::WARN);
+        ok = false;
+    }
+    if (allowed_collision_matrix_always_ratio <= 0.0 || allowed_collision_matrix_always_ratio > 1.0) {
+        printToMessageWindow("allowedCollisionMatrix: alwaysInCollisionRatio must be in (0, 1]", c2uLogLevel::WARN);
+        ok = false;
+    }
+    return ok;
+}
+
+bool Creo2Urdf::computeAllowedCollisionMatrix() {
+    if (!allowedCollisionMatrix) {
+        return true;
+    }
+
+    // Links connected by a joint always touch, they are disabled even if they have no mesh
+    std::set<std::pair<std::string, std::string>> adjacent_pairs;
+    for (const auto& joint : kinematic_graph.joints()) {
+        const auto& urdf_parent_link_name = kinematic_graph.name(kinematic_graph.links()[joint.parent_link].urdf_name);
+        const auto& urdf_child_link_name = kinematic_graph.name(kinematic_graph.links()[joint.child_link].urdf_name);
+        adjacent_pairs.insert(std::minmax(urdf_parent_link_name, urdf_child_link_name));
+    }
+
+    std::vector<std::string> link_names;
+    std::vector<std::string> mesh_paths;
+    for (const auto& link_mesh : allowed_collision_matrix_meshes) {
+        link_names.push_back(link_mesh.first);
+        mesh_paths.push_back(link_mesh.second);
+    }
+    std::vector<MeshBVH> meshes(mesh_paths.size());
+    std::vector<std::string> errors(mesh_paths.size());
+    parallelFor(mesh_paths.size(), [&](size_t m) {
+        TriangleMesh mesh;
+        if (!readMeshInLinkFrame(link_names[m], mesh_paths[m], mesh)) {
+            errors[m] = "unable to read " + mesh_paths[m];
+            return;
+        }
+        meshes[m] = buildMeshBVH(mesh);
+    });
+    for (size_t m = 0; m < errors.size(); m++) {
+        if (!errors[m].empty()) {
+            printToMessageWindow("Collision checking of " + link_names[m] + " failed: " + errors[m], c2uLogLevel::WARN);
+            if (warningsAreFatal) {
+                return false;
+            }
+        }
+    }
+
+    std::vector<std::pair<size_t, size_t>> pairs;
+    for (size_t a = 0; a < link_names.size(); a++) {
+        for (size_t b = a + 1; b < link_names.size(); b++) {
+            if (adjacent_pairs.count(std::minmax(link_names[a], link_names[b])) == 0) {
+                pairs.emplace_back(a, b);
+            }
+        }
+    }
+
+    iDynTree::KinDynComputations kin_dyn;
+    if (!kin_dyn.loadRobotModel(idyn_model)) {
+        printToMessageWindow("Unable to load the model for the collision checking", c2uLogLevel::WARN);
+        return false;
+    }
+
+    // The first sample is the home configuration, the others are drawn uniformly within the joint limits.
+    // The generator is seeded, so that the same model always gives the same matrix
+    std::mt19937 generator(allowed_collision_matrix_seed);
+    std::normal_distribution<double> normal;
+    iDynTree::VectorDynSize joint_pos(idyn_model.getNrOfPosCoords());
+    std::vector<MeshPoses> samples(allowed_collision_matrix_samples);
+    for (size_t s = 0; s < samples.size(); s++) {
+        for (size_t j = 0; j < idyn_model.getNrOfJoints(); j++) {
+            auto joint = idyn_model.getJoint(j);
+            auto offset = joint->getPosCoordsOffset();
+            if (joint->getNrOfPosCoords() == 4) {
+                // Spherical joints are sampled uniformly over the unit quaternions
+                Eigen::Vector4d quaternion(1.0, 0.0, 0.0, 0.0);
+                if (s > 0) {
+                    quaternion = Eigen::Vector4d(normal(generator), normal(generator), normal(generator), normal(generator)).normalized();
+                }
+                for (unsigned k = 0; k < 4; k++) {
+                    joint_pos(offset + k) = quaternion[k];
+                }
+                continue;
+            }
+            for (unsigned k = 0; k < joint->getNrOfPosCoords(); k++) {
+                double min = -M_PI;
+                double max = M_PI;
+                if (joint->hasPosLimits()) {
+                    joint->getPosLimits(k, min, max);
+                }
+                else if (dynamic_cast<iDynTree::PrismaticJoint*>(joint) != nullptr) {
+                    // Unlimited prismatic joints have no meaningful range, they are kept at the rest position
+                    min = max = 0.0;
+                }
+                joint_pos(offset + k) = s == 0 ? std::min(std::max(0.0, min), max) : std::uniform_real_distribution<double>(min, max)(generator);
+            }
+        }
+        kin_dyn.setJointPos(joint_pos);
+
+        samples[s].resize(link_names.size());
+        for (size_t m = 0; m < link_names.size(); m++) {
+            auto world_H_link = kin_dyn.getWorldTransform(idyn_model.getLinkIndex(link_names[m]));
+            samples[s][m].linear() = iDynTree::toEigen(world_H_link.getRotation());
+            samples[s][m].translation() = iDynTree::toEigen(world_H_link.getPosition());
+        }
+    }
+
+    auto counts = countCollisions(meshes, samples, pairs);
+
+    xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
+    xmlNodePtr root_node = xmlNewNode(NULL, BAD_CAST "robot");
+    xmlDocSetRootElement(doc, root_node);
+    xmlNewProp(root_node, BAD_CAST "name", BAD_CAST config["robotName"].Scalar().c_str());
+
+    auto add_disabled_pair = [&](const std::string& first, const std::string& second, const std::string& reason) {
+        xmlNodePtr node = xmlNewChild(root_node, NULL, BAD_CAST "disable_collisions", NULL);
+        xmlNewProp(node, BAD_CAST "link1", BAD_CAST first.c_str());
+        xmlNewProp(node, BAD_CAST "link2", BAD_CAST second.c_str());
+        xmlNewProp(node, BAD_CAST "reason", BAD_CAST reason.c_str());
+    };
+
+    for (const auto& adjacent : adjacent_pairs) {
+        add_disabled_pair(adjacent.first, adjacent.second, "Adjacent");
+    }
+    size_t n_always = 0;
+    size_t n_never = 0;
+    for (size_t p = 0; p < pairs.size(); p++) {
+        const auto& first = link_names[pairs[p].first];
+        const auto& second = link_names[pairs[p].second];
+        if (meshes[pairs[p].first].nodes.empty() || meshes[pairs[p].second].nodes.empty()) {
+            continue;
+        }
+        if (counts[p] == 0) {
+            add_disabled_pair(first, second, "Never");
+            n_never++;
+        }
+        else if (counts[p] >= allowed_collision_matrix_always_ratio * samples.size()) {
+            add_disabled_pair(first, second, "Always");
+            n_always++;
+        }
+    }
+
+    std::string srdf_path = m_output_path + "\\" + allowed_collision_matrix_output_file;
+    bool ok = xmlSaveFormatFileEnc(srdf_path.c_str(), doc, "UTF-8", 1) >= 0;
+    xmlFreeDoc(doc);
+    allowed_collision_matrix_meshes.clear();
+    if (!ok) {
+        printToMessageWindow("Unable to write " + srdf_path, c2uLogLevel::WARN);
+        return false;
+    }
+    output_side_files.insert(srdf_path);
+    printToMessageWindow("Allowed collision matrix saved in " + srdf_path + ": " + to_string(adjacent_pairs.size()) + " adjacent, " +
+                         to_string(n_never) + " never and " + to_string(n_always) + " always colliding pairs over " + to_string(samples.size()) + " samples");
+    return true;
+}
+
+bool Creo2Urdf::readConvexDecompositionFromConfig() {
+    convexDecomposition = config["convexDecomposition"].IsDefined();
+    if (!convexDecomposition) {
+        return true;
+    }
+
+    bool ok = true;
+    const auto& cd = config["convexDecomposition"];
+    if (cd["maxHulls"].IsDefined()) {
+        convex_decomposition_parameters.maxHulls = cd["maxHulls"].as<size_t>();
+    }
+    if (cd["maxVerticesPerHull"].IsDefined()) {
+        convex_decomposition_parameters.maxVerticesPerHull = cd["maxVerticesPerHull"].as<size_t>();
+    }
+    if (cd["maxConcavity"].IsDefined()) {
+        convex_decomposition_parameters.maxConcavity = cd["maxConcavity"].as<double>();
+    }
+    if (cd["links"].IsDefined()) {
+        auto links = cd["links"].as<std::vector<std::string>>();
+        convex_decomposition_links.insert(links.begin(), links.end());
+    }
+    convex_decomposition_cache_path = m_output_path + "\\convexDecompositionCache";
+    if (cd["cachePath"].IsDefined()) {
+        convex_decomposition_cache_path = cd["cachePath"].Scalar();
+    }
+
+    if (convex_decomposition_parameters.maxHulls < 1) {
+        printToMessageWindow("convexDecomposition: maxHulls must be at least 1", c2uLogLevel::WARN);
+        ok = false;
+    }
+    if (convex_decomposition_parameters.maxVerticesPerHull != 0 && convex_decomposition_parameters.maxVerticesPerHull < 4) {
+        printToMessageWindow("convexDecomposition: maxVerticesPerHull must be at least 4, or 0 for no limit", c2uLogLevel::WARN);
+        ok = false;
+    }
+    if (convex_decomposition_parameters.maxConcavity < 0.0) {
+        printToMessageWindow("convexDecomposition: maxConcavity must not be negative", c2uLogLevel::WARN);
+        ok = false;
+    }
+    return ok;
+}
+
+bool Creo2Urdf::runConvexDecompositions() {
+    if (convex_decomposition_jobs.empty()) {
+        return true;
+    }
+    if (!createDirectory(convex_decomposition_cache_path)) {
+        printToMessageWindow("Unable to create the folder " + convex_decomposition_cache_path, c2uLogLevel::WARN);
+        return false;
+    }
+
+    // The parameters are part of the cache key, so that changing them invalidates the cached hulls
+    const auto& p = convex_decomposition_parameters;
+    std::uint64_t parameters_hash = hashBytes(&p.maxHulls, sizeof(p.maxHulls));
+    parameters_hash = hashBytes(&p.maxVerticesPerHull, sizeof(p.maxVerticesPerHull), parameters_hash);
+    parameters_hash = hashBytes(&p.maxConcavity, sizeof(p.maxConcavity), parameters_hash);
+
+    // Creo is not thread safe, so the workers only touch files and their own job
+    std::vector<TriangleMesh> meshes(convex_decomposition_jobs.size());
+    std::vector<std::string> cache_prefixes(convex_decomposition_jobs.size());
+    parallelFor(convex_decomposition_jobs.size(), [&](size_t j) {
+        auto& job = convex_decomposition_jobs[j];
+        if (!readMesh(job.mesh_path, meshes[j]) || meshes[j].triangles.empty()) {
+            job.error = "unable to read " + job.mesh_path;
+            return;
+        }
+        cache_prefixes[j] = convex_decomposition_cache_path + "\\" + hashToString(hashMesh(meshes[j]) ^ parameters_hash);
+    });
+
+    // The links sharing a mesh are decomposed once, by the first of them, so that no two workers write the same cache entry
+    std::vector<size_t> owner(convex_decomposition_jobs.size());
+    std::vector<size_t> owner_jobs;
+    std::unordered_map<std::string, size_t> owner_by_cache_prefix;
+    for (size_t j = 0; j < convex_decomposition_jobs.size(); j++) {
+        if (!convex_decomposition_jobs[j].error.empty()) {
+            continue;
+        }
+        auto inserted = owner_by_cache_prefix.emplace(cache_prefixes[j], j);
+        owner[j] = inserted.first->second;
+        if (inserted.second) {
+            owner_jobs.push_back(j);
+        }
+    }
+
+    parallelFor(owner_jobs.size(), [&](size_t o) {
+        size_t j = owner_jobs[o];
+        auto& job = convex_decomposition_jobs[j];
+        const std::string& cache_prefix = cache_prefixes[j];
+        std::ifstream cache_index(cache_prefix + ".txt");
+        if (cache_index >> job.n_hulls) {
+            job.cache_hit = true;
+            for (size_t i = 0; i < job.n_hulls && job.cache_hit; i++) {
+                job.cache_hit = copyFile(cache_prefix + "_" + to_string(i) + ".stl", job.hull_path_prefix + to_string(i) + ".stl");
+            }
+            if (job.cache_hit) {
+                return;
+            }
+        }
+
+        auto hulls = computeConvexDecomposition(meshes[j], convex_decomposition_parameters);
+        meshes[j] = TriangleMesh();
+        if (hulls.empty()) {
+            job.error = "the mesh is degenerate";
+            return;
+        }
+        bool cached = true;
+        for (size_t i = 0; i < hulls.size(); i++) {
+            std::string hull_path = job.hull_path_prefix + to_string(i) + ".stl";
+            if (!writeBinarySTL(hull_path, hulls[i])) {
+                job.error = "unable to write " + hull_path;
+                return;
+            }
+            cached = cached && copyFile(hull_path, cache_prefix + "_" + to_string(i) + ".stl");
+        }
+        job.n_hulls = hulls.size();
+        // The index is written last, and only if all the hulls are in the cache, so that it never points to missing or partial files
+        if (cached) {
+            std::ofstream(cache_prefix + ".txt") << job.n_hulls;
+        }
+    });
+
+    // The other links sharing a mesh copy the hulls of the first one
+    parallelFor(convex_decomposition_jobs.size(), [&](size_t j) {
+        auto& job = convex_decomposition_jobs[j];
+        if (!job.error.empty() || owner[j] == j) {
+            return;
+        }
+        const auto& owner_job = convex_decomposition_jobs[owner[j]];
+        if (!owner_job.error.empty()) {
+            job.error = owner_job.error;
+            return;
+        }
+        job.n_hulls = owner_job.n_hulls;
+        job.cache_hit = true;
+        for (size_t i = 0; i < job.n_hulls; i++) {
+            if (!copyFile(owner_job.hull_path_prefix + to_string(i) + ".stl", job.hull_path_prefix + to_string(i) + ".stl")) {
+                job.error = "unable to write " + job.hull_path_prefix + to_string(i) + ".stl";
+                return;
+            }
+        }
+    });
+
+    size_t n_cache_hits = 0;
+    for (auto& job : convex_decomposition_jobs) {
+        auto& collision_shapes = idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(job.link_name)];
+        if (!job.error.empty()) {
+            printToMessageWindow("Convex decomposition of " + job.link_name + " failed: " + job.error + ", the collision mesh is kept", c2uLogLevel::WARN);
+            collision_shapes.push_back(job.collision_mesh.clone());
+            if (warningsAreFatal) {
+                return false;
+            }
+            continue;
+        }
+        for (size_t i = 0; i < job.n_hulls; i++) {
+            iDynTree::ExternalMesh hull = job.collision_mesh;
+            hull.setFilename(job.hull_uri_prefix + to_string(i) + ".stl");
+            mesh_uri_path_map[hull.getFilename()] = job.hull_path_prefix + to_string(i) + ".stl";
+            collision_shapes.push_back(hull.clone());
+        }
+        n_cache_hits += job.cache_hit ? 1 : 0;
+    }
+    printToMessageWindow("Convex decomposition: " + to_string(convex_decomposition_jobs.size()) + " links, " + to_string(owner_jobs.size()) + " distinct meshes, " + to_string(n_cache_hits) + " links from the cache or from a shared mesh");
+    convex_decomposition_jobs.clear();
+    return true;
+}
+
+bool Creo2Urdf::addMeshAndExport(pfcModel_ptr component_handle, const std::string& mesh_transform)
+{
+    bool export_mesh = true;
+    std::string file_extension = ".stl";
+    std::string meshFormat = "stl_binary";
+    std::string link_name = component_handle->GetFullName();
+    std::string renamed_link_name;
+    std::tie(std::ignore, renamed_link_name) = export_config.rename(link_name);
+
+    if (config["exportMeshes"].IsDefined())
+    {
+        export_mesh = config["exportMeshes"].as<bool>();
+    }
+
+
+    if (config["stringToRemoveFromMeshFileName"].IsDefined())
+    {
+        link_name.erase(link_name.find(config["stringToRemoveFromMeshFileName"].Scalar()), 
+            config["stringToRemoveFromMeshFileName"].Scalar().length());
+    }
+
+    // Make all alphabetic characters lowercase
+    if (config["forcelowercase"].IsDefined() && config["forcelowercase"].as<bool>())
+    {
+        std::transform(link_name.begin(), link_name.end(), link_name.begin(),
+            [](unsigned char c) { return std::tolower(c); });
+    }
+
+    if (config["meshFormat"].IsDefined()) {
+        meshFormat = config["meshFormat"].Scalar();
+        if (mesh_types_supported_extension_map.find(meshFormat) != mesh_types_supported_extension_map.end()) {
+            file_extension = mesh_types_supported_extension_map.at(meshFormat);
+        }
+        else {
+            printToMessageWindow("Mesh format " + meshFormat + " is not supported", c2uLogLevel::WARN);
+            if (warningsAreFatal) {
+                return false;
+            }
+        }
+    }
+    // Assign name
+    string file_format = "%s";
+    int mesh_quality = 3;
+    if (config["filenameformat"].IsDefined()) {
+        file_format = config["filenameformat"].Scalar();
+    }
+    else if (meshFormat != "step") {
+        // We use ExportIntf3D for step format, applies the extension to the file name.
+        file_format += file_extension;
+    }
+
+    if (config["meshQuality"].IsDefined()) {
+        mesh_quality = config["meshQuality"].as<int>();
+        if (mesh_quality < 1 || mesh_quality > 10) {
+            printToMessageWindow("Mesh quality is too low, or too hight, the range is between 1 and 10", c2uLogLevel::WARN);
+            if (warningsAreFatal) {
+                printToMessageWindow("Aborting the mesh exportation", c2uLogLevel::WARN);
+                return false;
+            }
+        }
+    }
+
+    if (assigned_mesh_quality_map.find(renamed_link_name) != assigned_mesh_quality_map.end()) {
+        mesh_quality = assigned_mesh_quality_map.at(renamed_link_name);
+    }
+    else if (adaptiveMeshQuality) {
+        bool ok = false;
+        double part_size = 0.0;
+        std::tie(ok, part_size) = getBoundingBoxDiagonal(component_handle, scale);
+        if (ok) {
+            mesh_quality = computeAdaptiveMeshQuality(part_size, chordTolerance);
+        }
+        else {
+            printToMessageWindow("Unable to compute the size of " + link_name + ", meshQuality " + to_string(mesh_quality) + " will be used instead", c2uLogLevel::WARN);
+        }
+    }
+
+    // We assume there is only one of occurrence to replace
+    std::string mesh_name_format = file_format;
+    // URI in the URDF of the mesh with a given stem. The subfolder of a level, if any, is inserted before the last
+    // component of the formatted name, that is the name of the file on disk, so that the URI and the path agree
+    auto mesh_uri = [&mesh_name_format](const std::string& level_name, const std::string& stem) {
+        std::string uri = mesh_name_format;
+        uri.replace(uri.find("%s"), 2, stem); // 2 is sizeof %s, in this way we keep the formatting extension
+        if (!level_name.empty()) {
+            size_t file_name_begin = uri.find_last_of("/") == std::string::npos ? 0 : uri.find_last_of("/") + 1;
+            uri.insert(file_name_begin, level_name + "/");
+        }
+        return uri;
+    };
+    auto mesh_file_name_of = [&mesh_uri](const std::string& stem) {
+        std::string uri = mesh_uri("", stem);
+        return uri.find("/") != std::string::npos ? uri.substr(uri.find_last_of("/") + 1) : uri;
+    };
+    std::string mesh_file_name = mesh_file_name_of(link_name);
+
+    // The levels named "visual" and "collision" are placed in their subfolder and referenced by the
+    // respective elements, otherwise the mesh exported with meshQuality is used for both
+    bool has_visual_level = false;
+    bool has_collision_level = false;
+    for (const auto& level : mesh_quality_levels) {
+        has_visual_level = has_visual_level || level.name == "visual";
+        has_collision_level = has_collision_level || level.name == "collision";
+    }
+
+    // Shared meshes are exported in the frame of the first csys of the part, so that the copies of a part give
+    // identical files, and each link places them with its own link_H_geometry
+    std::string export_csys = mesh_transform;
+    iDynTree::Transform link_H_geometry = iDynTree::Transform::Identity();
+    bool deduplicate = deduplicateMeshes && export_mesh && meshFormat != "step";
+    if (deduplicate) {
+        bool ok = false;
+        iDynTree::Transform csysPart_H_geometry = iDynTree::Transform::Identity();
+        std::tie(ok, export_csys) = getFirstCoordinateSystemName(component_handle);
+        if (ok) {
+            std::tie(ok, csysPart_H_geometry) = getTransformFromPart(component_handle, export_csys, scale);
+        }
+        if (ok) {
+            // The transform of the link frame was inverted once by processAsmItems
+            link_H_geometry = link_info_map.at(string(component_handle->GetFullName())).linkFrame_H_csysPart * csysPart_H_geometry;
+            link_H_geometry_map[renamed_link_name] = link_H_geometry;
+        }
+        else {
+            printToMessageWindow("Unable to get the frame of the shared mesh of " + renamed_link_name + ", its mesh is exported in the link frame", c2uLogLevel::WARN);
+            export_csys = mesh_transform;
+            deduplicate = false;
+        }
+    }
+
+    // Exports the mesh of a level, and gives the stem of the mesh to reference. The copies of a part exported before are
+    // found by name before exporting, the other identical meshes by content before the tessellations kept in memory are written
+    auto export_level_mesh = [&](const std::string& level_name, const std::string& mesh_path, int quality, std::string& stem) {
+        stem = link_name;
+        std::string part_key = level_name + ":" + string(component_handle->GetFullName()) + "|" + export_csys + "|" + to_string(quality);
+        if (deduplicate && deduplicated_part_map.find(part_key) != deduplicated_part_map.end()) {
+            stem = deduplicated_part_map.at(part_key);
+            printToMessageWindow(link_name + " shares the mesh of " + stem + (level_name.empty() ? "" : " in " + level_name));
+            return true;
+        }
+        if (!exportMesh(component_handle, export_csys, mesh_path, meshFormat, quality)) {
+            return false;
+        }
+        if (deduplicate) {
+            stem = deduplicateMesh(level_name, mesh_path, link_name);
+            deduplicated_part_map.emplace(part_key, stem);
+        }
+        return true;
+    };
+
+    // Stems of the meshes referenced by the visual and collision elements, that are the ones of another link if the mesh is shared
+    std::string visual_stem = link_name;
+    std::string collision_stem = link_name;
+    if (export_mesh)
+    {
+        if (!has_visual_level || !has_collision_level) {
+            std::string mesh_path = m_output_path + "\\" + mesh_file_name;
+            std::string stem;
+            if (!export_level_mesh("", mesh_path, mesh_quality, stem)) {
+                return false;
+            }
+            visual_stem = has_visual_level ? visual_stem : stem;
+            collision_stem = has_collision_level ? collision_stem : stem;
+        }
+
+        for (const auto& level : mesh_quality_levels) {
+            int level_quality = level.quality;
+            if (level.linkOverrides.find(renamed_link_name) != level.linkOverrides.end()) {
+                level_quality = level.linkOverrides.at(renamed_link_name);
+            }
+
+            std::string level_path = m_output_path + "\\" + level.name;
+            if (!createDirectory(level_path)) {
+                printToMessageWindow("Unable to create the folder " + level_path, c2uLogLevel::WARN);
+                return false;
+            }
+
+            std::string mesh_path = level_path + "\\" + mesh_file_name;
+            std::string stem;
+            if (!export_level_mesh(level.name, mesh_path, level_quality, stem)) {
+                return false;
+            }
+            if (level.name == "visual") {
+                visual_stem = stem;
+            }
+            else if (level.name == "collision") {
+                collision_stem = stem;
+            }
+            else if (stem == link_name) {
+                // The meshes of the other levels are not referenced by the URDF, the file is kept unless it is shared
+                output_side_files.insert(mesh_path);
+            }
+        }
+    }
+    std::string visual_file_format = mesh_uri(has_visual_level ? "visual" : "", visual_stem);
+    std::string collision_file_format = mesh_uri(has_collision_level ? "collision" : "", collision_stem);
+    std::string visual_mesh_file_name = mesh_file_name_of(visual_stem);
+    std::string collision_mesh_file_name = mesh_file_name_of(collision_stem);
+
+    bool mirror = mirroredMeshes && export_mesh && (mirrored_meshes_links.empty() || mirrored_meshes_links.count(renamed_link_name) > 0);
+    if (mirror && meshFormat == "step") {
+        printToMessageWindow("The mirrored meshes require STL meshes, the ones of " + renamed_link_name + " are not shared", c2uLogLevel::WARN);
+    }
+    else if (mirror) {
+        // Each file is compared once, even if it is shared by several links or used by both the visual and the collision elements
+        std::vector<MirroredMeshJob> jobs(2);
+        jobs[0].level_name = has_visual_level ? "visual" : "";
+        jobs[0].uri = visual_file_format;
+        jobs[0].mesh_path = (has_visual_level ? m_output_path + "\\visual" : m_output_path) + "\\" + visual_mesh_file_name;
+        jobs[1].level_name = has_collision_level ? "collision" : "";
+        jobs[1].uri = collision_file_format;
+        jobs[1].mesh_path = (has_collision_level ? m_output_path + "\\collision" : m_output_path) + "\\" + collision_mesh_file_name;
+        for (const auto& job : jobs) {
+            if (std::none_of(mirrored_mesh_jobs.begin(), mirrored_mesh_jobs.end(), [&job](const MirroredMeshJob& other) { return other.uri == job.uri; })) {
+                mirrored_mesh_jobs.push_back(job);
+            }
+        }
+    }
+
+    // Lets add the mesh to the link
+    iDynTree::ExternalMesh visualMesh;
+    // Meshes are in millimeters, while iDynTree models are in meters
+    visualMesh.setScale({scale});
+
+    iDynTree::Vector4 color;
+    iDynTree::Material material;
+
+    bool color_assigned{ false };
+    std::array<double, 4> assigned_color;
+    std::tie(color_assigned, assigned_color) = export_config.assignedColor(renamed_link_name);
+    if (color_assigned)
+    {
+        for (size_t i = 0; i < assigned_color.size(); i++)
+            color(i) = assigned_color[i];
+    } 
+    else
+    {
+        color(0) = color(1) = color(2) = 0.5;
+        color(3) = 1;
+    }
+
+    material.setColor(color);
+    visualMesh.setMaterial(material);
+    // Identity unless the mesh is shared, in which case it is expressed in the frame of the first csys of the part
+    visualMesh.setLink_H_geometry(link_H_geometry);
+
+    iDynTree::ExternalMesh collisionMesh = visualMesh;
+    visualMesh.setFilename(visual_file_format);
+    collisionMesh.setFilename(collision_file_format);
+    mesh_uri_path_map[visual_file_format] = (has_visual_level ? m_output_path + "\\visual" : m_output_path) + "\\" + visual_mesh_file_name;
+    mesh_uri_path_map[collision_file_format] = (has_collision_level ? m_output_path + "\\collision" : m_output_path) + "\\" + collision_mesh_file_name;
+
+    bool mesh_inertia = meshInertia && (mesh_inertia_links.empty() || mesh_inertia_links.count(renamed_link_name) > 0);
+    if (mesh_inertia && meshFormat == "step") {
+        printToMessageWindow("The inertia from the mesh requires STL meshes, the one of " + renamed_link_name + " is not computed", c2uLogLevel::WARN);
+        if (warningsAreFatal || mesh_inertia_substitute == "always") {
+            return false;
+        }
+    }
+    else if (mesh_inertia) {
+        // The visual mesh is the finest one, so it gives the most accurate integrals
+        MeshInertiaJob job;
+        job.link_name = renamed_link_name;
+        job.mesh_path = (has_visual_level ? m_output_path + "\\visual" : m_output_path) + "\\" + visual_mesh_file_name;
+        job.density = mesh_inertia_density;
+        if (mesh_inertia_densities_map.find(renamed_link_name) != mesh_inertia_densities_map.end()) {
+            job.density = mesh_inertia_densities_map.at(renamed_link_name);
+        }
+        mesh_inertia_jobs.push_back(job);
+    }
+
+    bool fit_primitive = primitiveFitting && (primitive_fitting_links.empty() || primitive_fitting_links.count(renamed_link_name) > 0);
+    bool decompose = convexDecomposition && (convex_decomposition_links.empty() || convex_decomposition_links.count(renamed_link_name) > 0);
+    bool sphere_tree = sphereTrees && (sphere_tree_links.empty() || sphere_tree_links.count(renamed_link_name) > 0);
+    bool has_assigned_geometry = assigned_collision_geometry_map.find(renamed_link_name) != assigned_collision_geometry_map.end();
+    bool embed_spheres = sphere_tree && sphereTreesInURDF && !has_assigned_geometry && !fit_primitive && !decompose;
+    // The fitting, the decomposition and the sphere tree are computed once all the meshes are exported, reading the collision mesh
+    std::string collision_folder = has_collision_level ? m_output_path + "\\collision" : m_output_path;
+
+    if (sphere_tree && meshFormat == "step") {
+        printToMessageWindow("The sphere trees require STL meshes, the one of " + renamed_link_name + " is not computed", c2uLogLevel::WARN);
+        embed_spheres = false;
+    }
+    else if (sphere_tree) {
+        SphereTreeJob job;
+        job.link_name = renamed_link_name;
+        job.mesh_path = collision_folder + "\\" + collision_mesh_file_name;
+        job.embed_in_urdf = embed_spheres;
+        job.collision_mesh = collisionMesh;
+        sphere_tree_jobs.push_back(job);
+    }
+
+    bool signed_distance_field = signedDistanceFields && (signed_distance_field_links.empty() || signed_distance_field_links.count(renamed_link_name) > 0);
+    if (signed_distance_field && meshFormat == "step") {
+        printToMessageWindow("The signed distance fields require STL meshes, the one of " + renamed_link_name + " is not computed", c2uLogLevel::WARN);
+    }
+    else if (signed_distance_field) {
+        SignedDistanceFieldJob job;
+        job.link_name = renamed_link_name;
+        job.mesh_path = collision_folder + "\\" + collision_mesh_file_name;
+        job.sdf_path = collision_folder + "\\" + mesh_file_name.substr(0, mesh_file_name.find_last_of('.')) + ".sdfgrid";
+        signed_distance_field_jobs.push_back(job);
+    }
+
+    bool collision_check = allowedCollisionMatrix && (allowed_collision_matrix_links.empty() || allowed_collision_matrix_links.count(renamed_link_name) > 0);
+    if (collision_check && meshFormat == "step") {
+        printToMessageWindow("The allowed collision matrix requires STL meshes, the collisions of " + renamed_link_name + " are not checked", c2uLogLevel::WARN);
+    }
+    else if (collision_check) {
+        allowed_collision_matrix_meshes[renamed_link_name] = collision_folder + "\\" + collision_mesh_file_name;
+    }
+
+    if (has_assigned_geometry) {
+        addCollisionGeometry(renamed_link_name, assigned_collision_geometry_map.at(renamed_link_name));
+    }
+    else if ((fit_primitive || decompose) && meshFormat == "step") {
+        printToMessageWindow("The primitive fitting and the convex decomposition require STL meshes, the collision mesh of " + renamed_link_name + " is kept", c2uLogLevel::WARN);
+        idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(renamed_link_name)].push_back(collisionMesh.clone());
+    }
+    else if (fit_primitive) {
+        PrimitiveFittingJob job;
+        job.link_name = renamed_link_name;
+        job.mesh_path = collision_folder + "\\" + collision_mesh_file_name;
+        job.collision_mesh = collisionMesh;
+        primitive_fitting_jobs.push_back(job);
+    }
+    else if (decompose) {
+        // The hulls are placed next to the collision mesh
+        std::string hull_name = mesh_file_name.substr(0, mesh_file_name.find_last_of('.')) + "_hull_";
+        ConvexDecompositionJob job;
+        job.link_name = renamed_link_name;
+        job.mesh_path = collision_folder + "\\" + collision_mesh_file_name;
+        job.hull_path_prefix = collision_folder + "\\" + hull_name;
+        job.hull_uri_prefix = collision_file_format.substr(0, collision_file_format.size() - collision_mesh_file_name.size()) + hull_name;
+        job.collision_mesh = collisionMesh;
+        convex_decomposition_jobs.push_back(job);
+    }
+    else if (embed_spheres) {
+        // The leaf spheres are added by runSphereTrees
+    }
+    else {
+        idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(renamed_link_name)].push_back(collisionMesh.clone());
+    }
+    idyn_model.visualSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(renamed_link_name)].push_back(visualMesh.clone());
+
+
+    return true;
+}
+
+std::string Creo2Urdf::deduplicateMesh(const std::string& level_name, const std::string& mesh_path, const std::string& stem)
+{
+    TriangleMesh mesh;
+    if (!readMesh(mesh_path, mesh)) {
+        printToMessageWindow("Unable to read " + mesh_path + ", it is not shared", c2uLogLevel::WARN);
+        return stem;
+    }
+
+    // The content is hashed instead of the file, whose header may contain the name of the part
+    std::string key = level_name + ":" + hashToString(hashMesh(mesh));
+    auto it = deduplicated_mesh_map.find(key);
+    if (it == deduplicated_mesh_map.end()) {
+        deduplicated_mesh_map.emplace(key, stem);
+        return stem;
+    }
+    mesh_buffer_map.erase(mesh_path);
+    if (unwritten_mesh_map.erase(mesh_path) == 0 && std::remove(mesh_path.c_str()) != 0) {
+        printToMessageWindow("Unable to remove " + mesh_path, c2uLogLevel::WARN);
+    }
+    printToMessageWindow(stem + " shares the mesh of " + it->second + (level_name.empty() ? "" : " in " + level_name));
+    return it->second;
+}
+
+bool Creo2Urdf::readMeshBudgetFromConfig() {
+    meshBudget = config["meshBudget"].IsDefined();
+    if (!meshBudget) {
+        return true;
+    }
+
+    const auto& mb = config["meshBudget"];
+    auto read_budget = [](const YAML::Node& node, const std::string& suffix, MeshBudget& budget) {
+        if (node["maxTriangles" + suffix].IsDefined()) {
+            budget.maxTriangles = node["maxTriangles" + suffix].as<size_t>();
+        }
+        if (node["maxVertices" + suffix].IsDefined()) {
+            budget.maxVertices = node["maxVertices" + suffix].as<size_t>();
+        }
+        if (node["maxFileSize" + suffix].IsDefined()) {
+            budget.maxFileSize = node["maxFileSize" + suffix].as<size_t>();
+        }
+    };
+    mesh_budget_per_link = MeshBudget();
+    mesh_budget_total = MeshBudget();
+    read_budget(mb, "PerLink", mesh_budget_per_link);
+    if (mb["maxTotalTriangles"].IsDefined()) {
+        mesh_budget_total.maxTriangles = mb["maxTotalTriangles"].as<size_t>();
+    }
+    if (mb["maxTotalVertices"].IsDefined()) {
+        mesh_budget_total.maxVertices = mb["maxTotalVertices"].as<size_t>();
+    }
+    if (mb["maxTotalFileSize"].IsDefined()) {
+        mesh_budget_total.maxFileSize = mb["maxTotalFileSize"].as<size_t>();
+    }
+    if (mb["assignedBudgets"].IsDefined()) {
+        for (const auto& assigned : mb["assignedBudgets"]) {
+            MeshBudget budget = mesh_budget_per_link;
+            read_budget(assigned.second, "", budget);
+            assigned_mesh_budget_map[assigned.first.Scalar()] = budget;
+        }
+    }
+    if (mb["reportFile"].IsDefined()) {
+        mesh_budget_report_file = mb["reportFile"].Scalar();
+    }
+    return true;
+}
+
+bool Creo2Urdf::runMeshBudget() {
+    if (!meshBudget) {
+        return true;
+    }
+
+    // Each file is read once, even if it is referenced by several links or by both the visual and collision elements
+    std::map<std::string, size_t> job_index_map;
+    std::vector<MeshStatisticsJob> jobs;
+    for (const auto& uri_path : mesh_uri_path_map) {
+        job_index_map[uri_path.first] = jobs.size();
+        MeshStatisticsJob job;
+        job.mesh_path = uri_path.second;
+        jobs.push_back(job);
+    }
+    parallelFor(jobs.size(), [&](size_t j) {
+        auto& job = jobs[j];
+        std::ifstream file(job.mesh_path, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            job.error = "unable to open " + job.mesh_path;
+            return;
+        }
+        job.file_size = static_cast<size_t>(file.tellg());
+        if (!readMesh(job.mesh_path, job.mesh)) {
+            job.error = "unable to read " + job.mesh_path;
+        }
+    });
+
+    std::ofstream report(m_output_path + "\\" + mesh_budget_report_file);
+    report << "link,visual_triangles,visual_vertices,collision_triangles,collision_vertices,file_size,min_x,min_y,min_z,max_x,max_y,max_z" << std::endl;
+
+    bool ok = true;
+    auto check_budget = [&ok](const std::string& owner, const std::string& quantity, size_t value, size_t limit) {
+        if (limit > 0 && value > limit) {
+            printToMessageWindow(owner + " has " + to_string(value) + " " + quantity + ", more than its budget of " + to_string(limit), c2uLogLevel::WARN);
+            ok = false;
+        }
+    };
+
+    size_t total_triangles = 0;
+    size_t total_vertices = 0;
+    std::set<size_t> total_files;
+    for (size_t l = 0; l < idyn_model.getNrOfLinks(); l++) {
+        std::string link_name = idyn_model.getLinkName(l);
+        std::array<size_t, 2> triangles{ 0, 0 };
+        std::array<size_t, 2> vertices{ 0, 0 };
+        std::set<size_t> link_files;
+        BoundingBox box;
+        bool has_box = false;
+
+        std::array<const std::vector<iDynTree::SolidShape*>*, 2> link_shapes{ &idyn_model.visualSolidShapes().getLinkSolidShapes()[l],
+                                                                              &idyn_model.collisionSolidShapes().getLinkSolidShapes()[l] };
+        for (size_t k = 0; k < link_shapes.size(); k++) {
+            for (const auto& shape : *link_shapes[k]) {
+                if (!shape->isExternalMesh()) {
+                    continue;
+                }
+                auto mesh = shape->asExternalMesh();
+                auto it = job_index_map.find(mesh->getFilename());
+                if (it == job_index_map.end() || !jobs[it->second].error.empty()) {
+                    printToMessageWindow("The mesh " + mesh->getFilename() + " of " + link_name + " is not counted in the budget" +
+                                         (it == job_index_map.end() ? "" : ": " + jobs[it->second].error), c2uLogLevel::WARN);
+                    continue;
+                }
+                const auto& job = jobs[it->second];
+                triangles[k] += job.mesh.triangles.size();
+                vertices[k] += job.mesh.vertices.size();
+                link_files.insert(it->second);
+
+                // The bounding box is expressed in the link frame, in meters
+                Eigen::Vector3d mesh_scale = iDynTree::toEigen(mesh->getScale());
+                Eigen::Matrix3d link_R_geometry = iDynTree::toEigen(mesh->getLink_H_geometry().getRotation());
+                Eigen::Vector3d link_p_geometry = iDynTree::toEigen(mesh->getLink_H_geometry().getPosition());
+                for (const auto& v : job.mesh.vertices) {
+                    Eigen::Vector3d p = link_R_geometry * mesh_scale.cwiseProduct(v) + link_p_geometry;
+                    box.min = has_box ? box.min.cwiseMin(p) : p;
+                    box.max = has_box ? box.max.cwiseMax(p) : p;
+                    has_box = true;
+                }
+            }
+        }
+        if (link_files.empty()) {
+            continue;
+        }
+
+        size_t file_size = 0;
+        for (auto j : link_files) {
+            file_size += jobs[j].file_size;
+        }
+        report << link_name << "," << triangles[0] << "," << vertices[0] << "," << triangles[1] << "," << vertices[1] << "," << file_size << ","
+               << box.min.x() << "," << box.min.y() << "," << box.min.z() << "," << box.max.x() << "," << box.max.y() << "," << box.max.z() << std::endl;
+
+        const MeshBudget& budget = assigned_mesh_budget_map.find(link_name) != assigned_mesh_budget_map.end() ?
+                                   assigned_mesh_budget_map.at(link_name) : mesh_budget_per_link;
+        check_budget(link_name, "triangles", triangles[0] + triangles[1], budget.maxTriangles);
+        check_budget(link_name, "vertices", vertices[0] + vertices[1], budget.maxVertices);
+        check_budget(link_name, "bytes of meshes", file_size, budget.maxFileSize);
+
+        total_triangles += triangles[0] + triangles[1];
+        total_vertices += vertices[0] + vertices[1];
+        total_files.insert(link_files.begin(), link_files.end());
+    }
+
+    // Shared files are loaded once, so they are counted once in the total size
+    size_t total_file_size = 0;
+    for (auto j : total_files) {
+        total_file_size += jobs[j].file_size;
+    }
+    report << "total,,," << total_triangles << "," << total_vertices << "," << total_file_size << ",,,,,," << std::endl;
+    printToMessageWindow("Mesh budget: " + to_string(total_triangles) + " triangles, " + to_string(total_vertices) + " vertices, " +
+                         to_string(total_file_size) + " bytes in " + to_string(total_files.size()) + " files, see " + mesh_budget_report_file);
+    check_budget("The robot", "triangles", total_triangles, mesh_budget_total.maxTriangles);
+    check_budget("The robot", "vertices", total_vertices, mesh_budget_total.maxVertices);
+    check_budget("The robot", "bytes of meshes", total_file_size, mesh_budget_total.maxFileSize);
+
+    if (!report) {
+        printToMessageWindow("Unable to write " + mesh_budget_report_file, c2uLogLevel::WARN);
+        return false;
+    }
+    output_side_files.insert(m_output_path + "\\" + mesh_budget_report_file);
+    return ok;
+}
+
+bool Creo2Urdf::readBundleFromConfig() {
+    bundle = config["bundle"].IsDefined();
+    if (!bundle) {
+        return true;
+    }
+
+    bool ok = true;
+    const auto& b = config["bundle"];
+    bundle_options = BundleOptions();
+    if (b["compress"].IsDefined()) {
+        bundle_options.compress = b["compress"].as<bool>();
+    }
+    if (b["compressionLevel"].IsDefined()) {
+        bundle_options.compressionLevel = b["compressionLevel"].as<int>();
+    }
+    if (b["alignment"].IsDefined()) {
+        bundle_options.alignment = b["alignment"].as<std::uint32_t>();
+    }
+    bundle_output_file = (config["robotName"].IsDefined() ? config["robotName"].Scalar() : std::string("model")) + ".c2ub";
+    if (b["outputFile"].IsDefined()) {
+        bundle_output_file = b["outputFile"].Scalar();
+    }
+
+    if (bundle_options.compressionLevel < 1 || bundle_options.compressionLevel > 9) {
+        printToMessageWindow("bundle: compressionLevel must be between 1 and 9", c2uLogLevel::WARN);
+        ok = false;
+    }
+    if (bundle_options.alignment == 0 || (bundle_options.alignment & (bundle_options.alignment - 1)) != 0) {
+        printToMessageWindow("bundle: alignment must be a power of 2", c2uLogLevel::WARN);
+        ok = false;
+    }
+    return ok;
+}
+
+bool Creo2Urdf::exportBundle() {
+    if (!bundle) {
+        return true;
+    }
+
+    // Only the files written by this run are packed, not the ones left in the output folder by the previous exports,
+    // nor the caches that are reused by the next exports
+    std::set<std::string> paths(output_side_files);
+    paths.insert(m_output_path + "\\" + "model.urdf");
+    for (const auto& link_shapes : { &idyn_model.visualSolidShapes().getLinkSolidShapes(), &idyn_model.collisionSolidShapes().getLinkSolidShapes() }) {
+        for (const auto& shapes : *link_shapes) {
+            for (const auto& shape : shapes) {
+                if (!shape->isExternalMesh()) {
+                    continue;
+                }
+                auto mesh_path = mesh_uri_path_map.find(shape->asExternalMesh()->getFilename());
+                if (mesh_path != mesh_uri_path_map.end()) {
+                    paths.insert(mesh_path->second);
+                }
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> files;
+    for (const auto& path : paths) {
+        if (path.compare(0, m_output_path.size() + 1, m_output_path + "\\") != 0) {
+            printToMessageWindow(path + " is not in the output folder, it is not added to the bundle", c2uLogLevel::WARN);
+            continue;
+        }
+        std::string name = path.substr(m_output_path.size() + 1);
+        std::replace(name.begin(), name.end(), '\\', '/');
+        files.emplace_back(name, path);
+    }
+
+    std::string error;
+    if (!writeBundle(m_output_path + "\\" + bundle_output_file, files, bundle_options, error)) {
+        printToMessageWindow("Unable to write the bundle: " + error, c2uLogLevel::WARN);
+        return false;
+    }
+    printToMessageWindow("Bundle " + bundle_output_file + " written with " + to_string(files.size()) + " entries");
+    return true;
+}
+
+bool Creo2Urdf::readMirroredMeshesFromConfig() {
+    mirroredMeshes = config["mirroredMeshes"].IsDefined();
+    if (!mirroredMeshes) {
+        return true;
+    }
+
+    bool ok = true;
+    const auto& mm = config["mirroredMeshes"];
+    if (mm["tolerance"].IsDefined()) {
+        mirrored_meshes_tolerance = mm["tolerance"].as<double>();
+    }
+    if (mm["links"].IsDefined()) {
+        auto links = mm["links"].as<std::vector<std::string>>();
+        mirrored_meshes_links.insert(links.begin(), links.end());
+    }
+
+    if (mirrored_meshes_tolerance <= 0.0) {
+        printToMessageWindow("mirroredMeshes: tolerance must be positive", c2uLogLevel::WARN);
+        ok = false;
+    }
+    return ok;
+}
+
+bool Creo2Urdf::runMirroredMeshes() {
+    if (mirrored_mesh_jobs.empty()) {
+        return true;
+    }
+    // The reflection is moved into the scale, that is applied before link_H_geometry only if it is uniform
+    if (scale[0] <= 0.0 || scale[0] != scale[1] || scale[0] != scale[2]) {
+        printToMessageWindow("The mirrored meshes require a uniform positive scale, the meshes are not shared", c2uLogLevel::WARN);
+        mirrored_mesh_jobs.clear();
+        return true;
+    }
+
+    parallelFor(mirrored_mesh_jobs.size(), [&](size_t j) {
+        auto& job = mirrored_mesh_jobs[j];
+        if (!readMesh(job.mesh_path, job.mesh) || job.mesh.triangles.empty()) {
+            job.error = "unable to read " + job.mesh_path;
+            return;
+        }
+        job.frame = computeCanonicalFrame(job.mesh);
+    });
+
+    // Only the meshes of the same level with the same shape hash can be reflections of each other
+    std::map<std::pair<std::string, std::uint64_t>, std::vector<size_t>> candidates;
+    bool ok = true;
+    for (size_t j = 0; j < mirrored_mesh_jobs.size(); j++) {
+        const auto& job = mirrored_mesh_jobs[j];
+        if (!job.error.empty()) {
+            printToMessageWindow("Mirroring of " + job.uri + " failed: " + job.error, c2uLogLevel::WARN);
+            ok = false;
+            continue;
+        }
+        candidates[std::make_pair(job.level_name, job.frame.shapeHash)].push_back(j);
+    }
+
+    size_t n_mirrored = 0;
+    for (const auto& group : candidates) {
+        std::vector<size_t> kept;
+        for (auto j : group.second) {
+            auto& job = mirrored_mesh_jobs[j];
+            auto box = computeBoundingBox(job.mesh.vertices);
+            double tolerance = mirrored_meshes_tolerance * (box.max - box.min).norm();
+
+            Eigen::Matrix3d linear;
+            Eigen::Vector3d translation;
+            auto original = std::find_if(kept.begin(), kept.end(), [&](size_t k) {
+                return findCongruence(mirrored_mesh_jobs[k].mesh, mirrored_mesh_jobs[k].frame, job.mesh, job.frame, true, tolerance, linear, translation);
+            });
+            if (original == kept.end()) {
+                kept.push_back(j);
+                continue;
+            }
+
+            // The vertices of this mesh are linear * v + translation, with v the vertices of the original one and linear = R * diag(-1, 1, 1)
+            const auto& original_job = mirrored_mesh_jobs[*original];
+            Eigen::Matrix3d rotation = linear * Eigen::Vector3d(-1.0, 1.0, 1.0).asDiagonal();
+            for (auto& link_shapes : { &idyn_model.visualSolidShapes().getLinkSolidShapes(), &idyn_model.collisionSolidShapes().getLinkSolidShapes() }) {
+                for (auto& shapes : *link_shapes) {
+                    for (auto& shape : shapes) {
+                        if (!shape->isExternalMesh() || shape->asExternalMesh()->getFilename() != job.uri) {
+                            continue;
+                        }
+                        auto mesh = shape->asExternalMesh();
+                        iDynTree::Transform link_H_geometry = mesh->getLink_H_geometry();
+                        Eigen::Matrix3d link_R_geometry = iDynTree::toEigen(link_H_geometry.getRotation());
+                        Eigen::Matrix3d link_R_mirrored = link_R_geometry * rotation;
+                        Eigen::Vector3d link_p_mirrored = link_R_geometry * (scale[0] * translation) + iDynTree::toEigen(link_H_geometry.getPosition());
+                        mesh->setLink_H_geometry(iDynTree::Transform(iDynTree::Rotation(link_R_mirrored(0, 0), link_R_mirrored(0, 1), link_R_mirrored(0, 2),
+                                                                                        link_R_mirrored(1, 0), link_R_mirrored(1, 1), link_R_mirrored(1, 2),
+                                                                                        link_R_mirrored(2, 0), link_R_mirrored(2, 1), link_R_mirrored(2, 2)),
+                                                                     iDynTree::Position(link_p_mirrored.x(), link_p_mirrored.y(), link_p_mirrored.z())));
+                        mesh->setScale({ { -scale[0], scale[1], scale[2] } });
+                        mesh->setFilename(original_job.uri);
+                    }
+                }
+            }
+
+            mesh_buffer_map.erase(job.mesh_path);
+            mesh_uri_path_map.erase(job.uri);
+            if (unwritten_mesh_map.erase(job.mesh_path) == 0 && std::remove(job.mesh_path.c_str()) != 0) {
+                printToMessageWindow("Unable to remove " + job.mesh_path, c2uLogLevel::WARN);
+            }
+            printToMessageWindow(job.uri + " is a reflection of " + original_job.uri + " and references it");
+            n_mirrored++;
+        }
+    }
+
+    printToMessageWindow(to_string(n_mirrored) + " of " + to_string(mirrored_mesh_jobs.size()) + " meshes are reflections of other meshes");
+    mirrored_mesh_jobs.clear();
+    return ok;
+}
+
+bool Creo2Urdf::readMesh(const std::string& mesh_path, TriangleMesh& mesh) const
+{
+    auto it = mesh_buffer_map.find(mesh_path);
+    if (it != mesh_buffer_map.end()) {
+        mesh = it->second;
+        return true;
+    }
+    return readSTL(mesh_path, mesh);
+}
+
+bool Creo2Urdf::writeMeshBuffers()
+{
+    std::vector<std::pair<std::string, std::string>> meshes(unwritten_mesh_map.begin(), unwritten_mesh_map.end());
+    unwritten_mesh_map.clear();
+    std::vector<char> written(meshes.size(), 0);
+    parallelFor(meshes.size(), [&](size_t j) {
+        written[j] = writeBinarySTL(meshes[j].first, mesh_buffer_map.at(meshes[j].first));
+    });
+
+    // The cache is updated sequentially, since the copies of a part exported for different links share the same entry
+    bool ok = true;
+    for (size_t j = 0; j < meshes.size(); j++) {
+        if (!written[j]) {
+            printToMessageWindow("Unable to write " + meshes[j].first, c2uLogLevel::WARN);
+            ok = false;
+        }
+        else if (!meshes[j].second.empty()) {
+            storeCachedMesh(meshes[j].second, meshes[j].first);
+        }
+    }
+    return ok;
+}
+
+bool Creo2Urdf::readMeshInLinkFrame(const std::string& link_name, const std::string& mesh_path, TriangleMesh& mesh) const
+{
+    if (!readMesh(mesh_path, mesh) || mesh.triangles.empty()) {
+        return false;
+    }
+
+    // The vertices are scaled to meters, and moved to the link frame if the mesh is shared
+    Eigen::Isometry3d link_H_geometry = Eigen::Isometry3d::Identity();
+    auto it = link_H_geometry_map.find(link_name);
+    if (it != link_H_geometry_map.end()) {
+        link_H_geometry.linear() = iDynTree::toEigen(it->second.getRotation());
+        link_H_geometry.translation() = iDynTree::toEigen(it->second.getPosition());
+    }
+    for (auto& v : mesh.vertices) {
+        v = link_H_geometry * v.cwiseProduct(Eigen::Vector3d(scale[0], scale[1], scale[2]));
+    }
+    return true;
+}
+
+void Creo2Urdf::addCollisionGeometry(const std::string& link_name, const CollisionGeometryInfo& geometry_info)
+{
+    auto& collision_shapes = idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(link_name)];
+    switch (geometry_info.shape)
+    {
+    case ShapeType::Box: {
+        iDynTree::Box idyn_box;
+        idyn_box.setX(geometry_info.size[0]); idyn_box.setY(geometry_info.size[1]); idyn_box.setZ(geometry_info.size[2]);
+        idyn_box.setLink_H_geometry(geometry_info.link_H_geometry);
+        collision_shapes.push_back(idyn_box.clone());
+    }
+        break;
+    case ShapeType::Cylinder: {
+        iDynTree::Cylinder idyn_cylinder;
+        idyn_cylinder.setLength(geometry_info.length);
+        idyn_cylinder.setRadius(geometry_info.radius);
+        idyn_cylinder.setLink_H_geometry(geometry_info.link_H_geometry);
+        collision_shapes.push_back(idyn_cylinder.clone());
+    }
+        break;
+    case ShapeType::Sphere: {
+        iDynTree::Sphere idyn_sphere;
+        idyn_sphere.setRadius(geometry_info.radius);
+        idyn_sphere.setLink_H_geometry(geometry_info.link_H_geometry);
+        collision_shapes.push_back(idyn_sphere.clone());
+    }
+        break;
+    case ShapeType::Capsule: {
+        // URDF has no capsule, so it is made of a cylinder and a sphere at each end of its axis
+        iDynTree::Cylinder idyn_cylinder;
+        idyn_cylinder.setLength(geometry_info.length);
+        idyn_cylinder.setRadius(geometry_info.radius);
+        idyn_cylinder.setLink_H_geometry(geometry_info.link_H_geometry);
+        collision_shapes.push_back(idyn_cylinder.clone());
+        for (double side : { -0.5, 0.5 }) {
+            iDynTree::Transform geometry_H_cap(iDynTree::Rotation::Identity(), iDynTree::Position(0.0, 0.0, side * geometry_info.length));
+            iDynTree::Sphere idyn_sphere;
+            idyn_sphere.setRadius(geometry_info.radius);
+            idyn_sphere.setLink_H_geometry(geometry_info.link_H_geometry * geometry_H_cap);
+            collision_shapes.push_back(idyn_sphere.clone());
+        }
+    }
+        break;
+    case ShapeType::None:
+        collision_shapes.clear();
+        break;
+    default:
+        break;
+    }
+}
+
+bool Creo2Urdf::readMeshCacheFromConfig() {
+    meshCache = config["meshCache"].IsDefined();
+    if (!meshCache) {
+        return true;
+    }
+
+    mesh_cache_path = m_output_path + "\\meshCache";
+    if (config["meshCache"]["cachePath"].IsDefined()) {
+        mesh_cache_path = config["meshCache"]["cachePath"].Scalar();
+    }
+    if (!createDirectory(mesh_cache_path)) {
+        printToMessageWindow("Unable to create the folder " + mesh_cache_path + ", the meshes are not cached", c2uLogLevel::WARN);
+        meshCache = false;
+        return false;
+    }
+    return true;
+}
+
+std::pair<bool, std::string> Creo2Urdf::findCachedMesh(const std::string& cache_key) {
+    std::string cache_prefix = mesh_cache_path + "\\" + hashToString(hashBytes(cache_key.data(), cache_key.size()));
+    std::ifstream cache_index(cache_prefix + ".txt");
+    std::string stored_key;
+    std::string stored_hash;
+    if (!std::getline(cache_index, stored_key) || !std::getline(cache_index, stored_hash) || stored_key != cache_key) {
+        return std::make_pair(false, "");
+    }
+
+    // An entry whose file was modified or truncated after it was stored is discarded and exported again
+    bool ok = false;
+    std::uint64_t content_hash = 0;
+    std::tie(ok, content_hash) = hashFile(cache_prefix + ".mesh");
+    if (!ok || hashToString(content_hash) != stored_hash) {
+        std::remove((cache_prefix + ".txt").c_str());
+        mesh_cache_invalid++;
+        return std::make_pair(false, "");
+    }
+    return std::make_pair(true, cache_prefix + ".mesh");
+}
+
+void Creo2Urdf::storeCachedMesh(const std::string& cache_key, const std::string& mesh_file_name) {
+    bool ok = false;
+    std::uint64_t content_hash = 0;
+    std::tie(ok, content_hash) = hashFile(mesh_file_name);
+    std::string cache_prefix = mesh_cache_path + "\\" + hashToString(hashBytes(cache_key.data(), cache_key.size()));
+    if (!ok || !copyFile(mesh_file_name, cache_prefix + ".mesh")) {
+        printToMessageWindow("Unable to cache " + mesh_file_name, c2uLogLevel::WARN);
+        return;
+    }
+    // The index is written last, so that an interrupted run does not leave a valid entry
+    std::ofstream(cache_prefix + ".txt") << cache_key << "\n" << hashToString(content_hash) << "\n";
+}
+
+bool Creo2Urdf::exportMesh(pfcModel_ptr component_handle, const std::string& mesh_transform, const std::string& mesh_file_name,
+                           const std::string& mesh_format, int mesh_quality)
+{
+    bool is_stl = mesh_format == "stl_binary" || mesh_format == "stl_ascii";
+    bool tessellate = tessellateMeshes && mesh_format == "stl_binary";
+
+    // The key identifies the part by name and version stamp, that Creo changes at every modification of the part,
+    // together with everything else that changes the exported file. The frame of the mesh is the csys of the part named
+    // mesh_transform, that is also the first csys of the part when deduplicateMeshes is set, so the csys name covers it.
+    // STEP files get their extension from Creo, so they are not cached
+    std::string cache_key;
+    if (meshCache && is_stl) {
+        xbool is_modified = xtrue;
+        xstring version_stamp;
+        try {
+            is_modified = component_handle->GetIsModified();
+            version_stamp = component_handle->GetVersionStamp();
+        }
+        xcatchbegin
+        xcatchcip(defaultEx)
+        {
+            is_modified = xtrue;
+        }
+        xcatchend
+
+        // Parts modified in session but not saved yet may keep the stamp of the saved version
+        if (!is_modified) {
+            cache_key = string(component_handle->GetFullName()) + "|" + string(version_stamp) + "|" + mesh_transform + "|" +
+                        mesh_format + "|" + (tessellate ? "tessellation" : "export") + "|" + to_string(mesh_quality) + "|" +
+                        to_string(maxTrianglesPerPart);
+            bool cached = false;
+            std::string cached_file;
+            std::tie(cached, cached_file) = findCachedMesh(cache_key);
+            if (cached && tessellate) {
+                // The cached mesh is kept in memory like a tessellation, so that it is written only if it is not shared
+                TriangleMesh mesh;
+                cached = readSTL(cached_file, mesh);
+                if (cached) {
+                    mesh_buffer_map[mesh_file_name] = std::move(mesh);
+                    unwritten_mesh_map[mesh_file_name] = "";
+                }
+            }
+            else if (cached) {
+                cached = copyFile(cached_file, mesh_file_name);
+            }
+            if (cached) {
+                mesh_cache_hits++;
+                return true;
+            }
+        }
+        mesh_cache_misses++;
+    }
+
+    // The tessellation is fetched in memory and kept for the later stages, that do not read it back.
+    // It is written by writeMeshBuffers, once it is known not to be a copy or a reflection of another mesh
+    if (tessellate) {
+        TriangleMesh mesh;
+        if (!tessellatePart(component_handle, mesh_transform, mesh_quality, mesh)) {
+            return false;
+        }
+        if (maxTrianglesPerPart > 0 && mesh.triangles.size() > maxTrianglesPerPart) {
+            // The last tessellation that fits is the one with the best quality
+            MeshQualitySearch search(mesh_quality, maxTrianglesPerPart);
+            TriangleMesh fitting_mesh;
+            size_t n_triangles = mesh.triangles.size();
+            while (search.next(n_triangles)) {
+                if (!tessellatePart(component_handle, mesh_transform, search.quality(), mesh)) {
+                    return false;
+                }
+                n_triangles = mesh.triangles.size();
+                if (mesh.triangles.size() <= maxTrianglesPerPart) {
+                    std::swap(fitting_mesh, mesh);
+                }
+            }
+            if (search.bestQuality() == 0) {
+                printToMessageWindow(mesh_file_name + " has " + to_string(mesh.triangles.size()) + " triangles even with quality 1, more than maxTrianglesPerPart", c2uLogLevel::WARN);
+            }
+            else {
+                mesh = std::move(fitting_mesh);
+            }
+        }
+        mesh_buffer_map[mesh_file_name] = std::move(mesh);
+        unwritten_mesh_map[mesh_file_name] = cache_key;
+        return true;
+    }
+
+    auto export_file = [&](int quality) {
+        try {
+            if (mesh_format == "stl_binary") {
                 auto stl_binary_export_instructions = pfcSTLBinaryExportInstructions().Create(mesh_transform.c_str());
-                stl_binary_export_instructions->SetQuality(mesh_quality);
+                stl_binary_export_instructions->SetQuality(quality);
                 component_handle->Export(mesh_file_name.c_str(), pfcExportInstructions::cast(stl_binary_export_instructions));
             }
-            else if(meshFormat =="stl_ascii") {
+            else if (mesh_format == "stl_ascii") {
                 auto stl_ascii_export_instructions = pfcSTLASCIIExportInstructions().Create(mesh_transform.c_str());
-                stl_ascii_export_instructions->SetQuality(mesh_quality);
+                stl_ascii_export_instructions->SetQuality(quality);
                 component_handle->Export(mesh_file_name.c_str(), pfcExportInstructions::cast(stl_ascii_export_instructions));
             }
-            else if (meshFormat == "step") {
+            else if (mesh_format == "step") {
                 component_handle->ExportIntf3D(mesh_file_name.c_str(), pfcExportType::pfcEXPORT_STEP);
             }
             else {
                 return false;
             }
-
         }
         xcatchbegin
         xcatchcip(defaultEx)
@@ -828,116 +3024,375 @@ bool Creo2Urdf::addMeshAndExport(pfcModel_ptr component_handle, const std::strin
         // Replace the first 5 bytes of the binary file with a string different than "solid"
         // to avoid issues with stl parsers.
         // For details see: https://github.com/mesh-iit/creo2urdf/issues/16
-        if (meshFormat == "stl_binary") {
+        if (mesh_format == "stl_binary") {
             sanitizeSTL(mesh_file_name);
         }
+        return true;
+    };
+
+    if (!export_file(mesh_quality)) {
+        return false;
     }
 
-    // Lets add the mesh to the link
-    iDynTree::ExternalMesh visualMesh;
-    // Meshes are in millimeters, while iDynTree models are in meters
-    visualMesh.setScale({scale});
+    bool ok = false;
+    size_t n_triangles = 0;
+    if (is_stl && maxTrianglesPerPart > 0) {
+        std::tie(ok, n_triangles) = countSTLTriangles(mesh_file_name, mesh_format == "stl_binary");
+    }
+    if (ok && n_triangles > maxTrianglesPerPart) {
+        // The last export that fits is kept aside, since the next ones overwrite the file
+        std::string fitting_file_name = mesh_file_name + ".fitting";
+        bool has_fitting_file = false;
+        MeshQualitySearch search(mesh_quality, maxTrianglesPerPart);
+        while (search.next(n_triangles)) {
+            if (!export_file(search.quality())) {
+                return false;
+            }
+            std::tie(ok, n_triangles) = countSTLTriangles(mesh_file_name, mesh_format == "stl_binary");
+            if (!ok) {
+                break;
+            }
+            if (n_triangles <= maxTrianglesPerPart) {
+                std::remove(fitting_file_name.c_str());
+                has_fitting_file = std::rename(mesh_file_name.c_str(), fitting_file_name.c_str()) == 0;
+                if (!has_fitting_file) {
+                    // The file just exported fits, so it is kept as it is
+                    break;
+                }
+            }
+        }
+        if (has_fitting_file) {
+            std::remove(mesh_file_name.c_str());
+            if (std::rename(fitting_file_name.c_str(), mesh_file_name.c_str()) != 0) {
+                printToMessageWindow("Unable to write " + mesh_file_name, c2uLogLevel::WARN);
+                return false;
+            }
+        }
+        else if (ok && search.bestQuality() == 0) {
+            printToMessageWindow(mesh_file_name + " has " + to_string(n_triangles) + " triangles even with quality 1, more than maxTrianglesPerPart", c2uLogLevel::WARN);
+        }
+    }
 
-    iDynTree::Vector4 color;
-    iDynTree::Material material;
+    if (!cache_key.empty()) {
+        storeCachedMesh(cache_key, mesh_file_name);
+    }
+    return true;
+}
 
-    if(config["assignedColors"][renamed_link_name].IsDefined())
-    {
-        for (size_t i = 0; i < config["assignedColors"][renamed_link_name].size(); i++)
-            color(i) = config["assignedColors"][renamed_link_name][i].as<double>();
-    } 
-    else
+void Creo2Urdf::collectPreflightItems(pfcModelItems_ptr asmListItems, std::map<std::string, PreflightPartInfo>& parts, std::map<std::string, JointInfo>& joints)
+{
+    for (int i = 0; i < asmListItems->getarraysize(); i++)
     {
-        color(0) = color(1) = color(2) = 0.5;
-        color(3) = 1;
+        auto asmItemAsFeat = pfcFeature::cast(asmListItems->get(i));
+        if (asmItemAsFeat->GetFeatType() != pfcFeatureType::pfcFEATTYPE_COMPONENT)
+        {
+            continue;
+        }
+        auto component_handle = m_session_ptr->RetrieveModel(pfcComponentFeat::cast(asmItemAsFeat)->GetModelDescr());
+        if (component_handle == nullptr || pfcSolid::cast(component_handle)->GetIsSkeleton()) {
+            continue;
+        }
+
+        ElementTreeManager element_tree_manager;
+        element_tree_manager.populateJointInfoFromElementTree(asmItemAsFeat, joints);
+
+        if (component_handle->GetType() == pfcMDL_ASSEMBLY) {
+            collectPreflightItems(component_handle->ListItems(pfcModelItemType::pfcITEM_FEATURE), parts, joints);
+            continue;
+        }
+
+        PreflightPartInfo part;
+        auto link_name = string(component_handle->GetFullName());
+        std::tie(std::ignore, part.urdf_name) = export_config.rename(link_name);
+        auto csys_list = component_handle->ListItems(pfcModelItemType::pfcITEM_COORD_SYS);
+        for (xint j = 0; j < csys_list->getarraysize(); j++) {
+            part.csys_names.insert(string(csys_list->get(j)->GetName()));
+        }
+        auto axis_list = component_handle->ListItems(pfcModelItemType::pfcITEM_AXIS);
+        for (xint j = 0; j < axis_list->getarraysize(); j++) {
+            part.axis_names.insert(string(axis_list->get(j)->GetName()));
+        }
+        parts[link_name] = part;
     }
+}
 
-    material.setColor(color);
-    visualMesh.setMaterial(material);
-    // Assign transform
-    // TODO Right now maybe it is not needed it ie exported respct the link csys
-    // visualMesh.setLink_H_geometry(H_parent_to_child);
+bool Creo2Urdf::runPreflight(pfcModelItems_ptr asmListItems, const Sensorizer& sensorizer)
+{
+    if (!preflight) {
+        return true;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    std::map<std::string, PreflightPartInfo> parts;
+    std::map<std::string, JointInfo> joints;
+    collectPreflightItems(asmListItems, parts, joints);
+
+    std::vector<std::string> problems;
+    std::map<std::string, std::string> urdf_link_map; // URDF name -> name in Creo
+    std::set<std::string> all_csys_names;
+    for (const auto& part : parts) {
+        auto inserted = urdf_link_map.emplace(part.second.urdf_name, part.first);
+        if (!inserted.second) {
+            problems.push_back("The parts " + inserted.first->second + " and " + part.first + " are both exported as the link " + part.second.urdf_name);
+        }
+        all_csys_names.insert(part.second.csys_names.begin(), part.second.csys_names.end());
+    }
+    auto find_part = [&](const std::string& urdf_link_name) -> const PreflightPartInfo* {
+        auto it = urdf_link_map.find(urdf_link_name);
+        return it == urdf_link_map.end() ? nullptr : &parts.at(it->second);
+    };
+    auto check_link = [&](const std::string& urdf_link_name, const std::string& where) {
+        if (find_part(urdf_link_name) == nullptr) {
+            problems.push_back(where + " references the link " + urdf_link_name + ", that is not in the assembly");
+        }
+    };
 
-    visualMesh.setFilename(file_format);
+    bool has_limit_columns = joint_parameter_table.hasColumn("lower_limit") && joint_parameter_table.hasColumn("upper_limit");
+    if (!has_limit_columns) {
+        problems.push_back("The CSV misses the lower_limit or upper_limit column");
+    }
+    std::map<std::string, std::string> urdf_joint_map; // URDF name -> name in Creo
+    for (const auto& joint : joints) {
+        const auto& joint_info = joint.second;
+        if (joint_info.child_link_name.empty() || parts.find(joint_info.parent_link_name) == parts.end() || parts.find(joint_info.child_link_name) == parts.end()) {
+            // Joints of cut assemblies are skipped while exporting
+            continue;
+        }
+        std::string joint_name;
+        std::tie(std::ignore, joint_name) = export_config.rename(joint.first);
+        auto inserted = urdf_joint_map.emplace(joint_name, joint.first);
+        if (!inserted.second) {
+            problems.push_back("The joints " + inserted.first->second + " and " + joint.first + " are both exported as " + joint_name);
+        }
+        if (joint_info.type != JointType::Revolute && joint_info.type != JointType::Linear) {
+            continue;
+        }
+        if (parts.at(joint_info.parent_link_name).axis_names.count(joint_info.datum_name) == 0) {
+            problems.push_back("The axis " + joint_info.datum_name + " of the joint " + joint_name + " is not in the part " + joint_info.parent_link_name);
+        }
+        if (has_limit_columns && joint_parameter_table.find(joint_name) == nullptr) {
+            problems.push_back("The joint " + joint_name + " misses its row in the CSV");
+        }
+    }
 
-    if (assigned_collision_geometry_map.find(renamed_link_name) != assigned_collision_geometry_map.end()) {
-        auto geometry_info = assigned_collision_geometry_map.at(renamed_link_name);
-        switch (geometry_info.shape)
-        {
-        case ShapeType::Box: {
-            iDynTree::Box idyn_box;
-            idyn_box.setX(geometry_info.size[0]); idyn_box.setY(geometry_info.size[1]); idyn_box.setZ(geometry_info.size[2]);
-            idyn_box.setLink_H_geometry(geometry_info.link_H_geometry);
-            idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(renamed_link_name)].push_back(idyn_box.clone());
+    if (config["root"].IsDefined()) {
+        check_link(config["root"].Scalar(), "root");
+    }
+    if (config["linkFrames"].IsDefined()) {
+        for (const auto& lf : config["linkFrames"]) {
+            auto link = find_part(lf["linkName"].Scalar());
+            if (link == nullptr) {
+                check_link(lf["linkName"].Scalar(), "linkFrames");
+            }
+            else if (link->csys_names.count(lf["frameName"].Scalar()) == 0) {
+                problems.push_back("linkFrames references the frame " + lf["frameName"].Scalar() + ", that is not in the link " + lf["linkName"].Scalar());
+            }
         }
-            break;
-        case ShapeType::Cylinder: {
-            iDynTree::Cylinder idyn_cylinder;
-            idyn_cylinder.setLength(geometry_info.length);
-            idyn_cylinder.setRadius(geometry_info.radius);
-            idyn_cylinder.setLink_H_geometry(geometry_info.link_H_geometry);
-            idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(renamed_link_name)].push_back(idyn_cylinder.clone());
+    }
+    for (const auto& ef : exported_frame_info_map) {
+        if (ef.second.frameReferenceLink.empty()) {
+            if (all_csys_names.count(ef.first) == 0) {
+                problems.push_back("exportedFrames references the frame " + ef.first + ", that is not in the assembly");
+            }
+            continue;
         }
-            break;
-        case ShapeType::Sphere: {
-            iDynTree::Sphere idyn_sphere;
-            idyn_sphere.setRadius(geometry_info.radius);
-            idyn_sphere.setLink_H_geometry(geometry_info.link_H_geometry);
-            idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(renamed_link_name)].push_back(idyn_sphere.clone());
+        auto link = find_part(ef.second.frameReferenceLink);
+        if (link == nullptr) {
+            check_link(ef.second.frameReferenceLink, "exportedFrames");
         }
-            break;
-        case ShapeType::None:
-            idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(renamed_link_name)].clear();
-            break;
-        default:
-            break;
+        else if (link->csys_names.count(ef.first) == 0) {
+            problems.push_back("exportedFrames references the frame " + ef.first + ", that is not in the link " + ef.second.frameReferenceLink);
+        }
+    }
+    for (const auto& ft : sensorizer.ft_sensors) {
+        if (urdf_joint_map.find(ft.first) == urdf_joint_map.end()) {
+            problems.push_back("The force torque sensor " + ft.second.sensorName + " references the joint " + ft.first + ", that is not in the assembly");
+        }
+        if (exported_frame_info_map.find(ft.second.frameName) == exported_frame_info_map.end() && all_csys_names.count(ft.second.frameName) == 0) {
+            problems.push_back("The force torque sensor " + ft.second.sensorName + " references the frame " + ft.second.frameName + ", that is not in the assembly");
+        }
+    }
+    for (const auto& sensor : sensorizer.sensors) {
+        auto link = find_part(sensor.linkName);
+        if (link == nullptr) {
+            check_link(sensor.linkName, "The sensor " + sensor.sensorName);
+        }
+        else if (exported_frame_info_map.find(sensor.frameName) == exported_frame_info_map.end() && link->csys_names.count(sensor.frameName) == 0) {
+            problems.push_back("The sensor " + sensor.sensorName + " references the frame " + sensor.frameName + ", that is not in the link " + sensor.linkName);
+        }
+    }
+    for (const auto& sensor_array : sensorizer.sensor_arrays) {
+        auto link = find_part(sensor_array.linkName);
+        if (link == nullptr) {
+            check_link(sensor_array.linkName, "The sensor array");
         }
+        else if (!sensor_array.frameNamePattern.empty()) {
+            std::regex pattern(sensor_array.frameNamePattern);
+            if (std::none_of(link->csys_names.begin(), link->csys_names.end(), [&pattern](const std::string& name) { return std::regex_match(name, pattern); })) {
+                problems.push_back("The sensor array of " + sensor_array.linkName + " matches no frame of the link with " + sensor_array.frameNamePattern);
+            }
+        }
+    }
 
+    for (const auto& ai : assigned_inertias_map) {
+        check_link(ai.first, "assignedInertias");
     }
-    else {
-        idyn_model.collisionSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(renamed_link_name)].push_back(visualMesh.clone());
+    for (const auto& cg : assigned_collision_geometry_map) {
+        check_link(cg.first, "assignedCollisionGeometry");
+    }
+    for (const auto& mq : assigned_mesh_quality_map) {
+        check_link(mq.first, "assignedMeshQuality");
+    }
+    for (const auto& mb : assigned_mesh_budget_map) {
+        check_link(mb.first, "meshBudget");
+    }
+    std::vector<std::pair<std::string, const std::set<std::string>*>> link_sets{
+        { "meshInertia", &mesh_inertia_links },
+        { "primitiveFitting", &primitive_fitting_links },
+        { "convexDecomposition", &convex_decomposition_links },
+        { "sphereTrees", &sphere_tree_links },
+        { "signedDistanceFields", &signed_distance_field_links },
+        { "allowedCollisionMatrix", &allowed_collision_matrix_links },
+        { "mirroredMeshes", &mirrored_meshes_links } };
+    for (const auto& link_set : link_sets) {
+        for (const auto& link : *link_set.second) {
+            check_link(link, link_set.first);
+        }
     }
-    idyn_model.visualSolidShapes().getLinkSolidShapes()[idyn_model.getLinkIndex(renamed_link_name)].push_back(visualMesh.clone());
 
+    // Tables shared by several robots list joints of the other robots, so the rows without joint are not problems
+    size_t n_unused_rows = std::count_if(joint_parameter_table.jointNames().begin(), joint_parameter_table.jointNames().end(),
+        [&urdf_joint_map](const std::string& name) { return urdf_joint_map.find(name) == urdf_joint_map.end(); });
+    if (n_unused_rows > 0) {
+        printToMessageWindow("Preflight: " + to_string(n_unused_rows) + " rows of the CSV do not match any joint of the assembly");
+    }
 
-    return true;
+    for (const auto& problem : problems) {
+        printToMessageWindow(problem, c2uLogLevel::WARN);
+    }
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    printToMessageWindow("Preflight: " + to_string(parts.size()) + " parts and " + to_string(urdf_joint_map.size()) + " joints checked in " +
+                         to_string(elapsed_ms) + " ms, " + to_string(problems.size()) + " problems found");
+    return problems.empty();
 }
 
-bool Creo2Urdf::loadYamlConfig(const std::string& filename)
+bool Creo2Urdf::parseYamlFiles(std::vector<YamlIncludeJob>& jobs)
 {
-    try 
-    {
-        config = YAML::LoadFile(filename);
-        if (config["includes"].IsDefined() && config["includes"].IsSequence()) {
-            auto folder_path = extractFolderPath(filename);
-            for (const auto& include : config["includes"]) {
-                auto include_filename = folder_path + include.as<std::string>();
-                auto include_config = YAML::LoadFile(include_filename);
-                mergeYAMLNodes(config, include_config);
-            }
+    parallelFor(jobs.size(), [&](size_t j) {
+        auto& job = jobs[j];
+        bool ok = false;
+        std::tie(ok, job.content) = readFileContent(job.path);
+        if (!ok) {
+            job.error = "Configuration file " + job.path + " does not exist!";
+            return;
+        }
+        job.hash = hashBytes(job.content.data(), job.content.size());
+    });
+
+    for (auto& job : jobs) {
+        auto cached = yaml_file_cache.find(job.hash);
+        if (job.error.empty() && cached != yaml_file_cache.end()) {
+            job.cached = true;
+            job.node = cached->second;
         }
     }
-    catch (YAML::BadFile file_does_not_exist) 
-    {
-        printToMessageWindow("Configuration file " + filename + " does not exist!", c2uLogLevel::WARN);
+
+    parallelFor(jobs.size(), [&](size_t j) {
+        auto& job = jobs[j];
+        if (!job.error.empty() || job.cached) {
+            return;
+        }
+        try {
+            job.node = YAML::Load(job.content);
+        }
+        catch (const YAML::ParserException& badly_formed) {
+            job.error = job.path + ": " + badly_formed.msg;
+        }
+    });
+
+    bool ok = true;
+    for (auto& job : jobs) {
+        if (!job.error.empty()) {
+            printToMessageWindow(job.error, c2uLogLevel::WARN);
+            ok = false;
+            continue;
+        }
+        if (!job.cached) {
+            yaml_file_cache[job.hash] = job.node;
+        }
+        // The merge shares the nodes of the included files with the configuration, so the cached ones are cloned
+        job.node = YAML::Clone(job.node);
+    }
+    return ok;
+}
+
+bool Creo2Urdf::loadYamlConfig(const std::string& filename)
+{
+    std::vector<YamlIncludeJob> main_job(1);
+    main_job[0].path = filename;
+    if (!parseYamlFiles(main_job)) {
         return false;
     }
-    catch (YAML::ParserException badly_formed) 
-    {
-        printToMessageWindow(badly_formed.msg, c2uLogLevel::WARN);
+    config = main_job[0].node;
+
+    if (config["includes"].IsDefined() && config["includes"].IsSequence()) {
+        auto folder_path = extractFolderPath(filename);
+        std::vector<YamlIncludeJob> include_jobs;
+        for (const auto& include : config["includes"]) {
+            YamlIncludeJob job;
+            job.path = folder_path + include.as<std::string>();
+            include_jobs.push_back(job);
+        }
+        if (!parseYamlFiles(include_jobs)) {
+            return false;
+        }
+        // The includes are merged in the order in which they are listed, whatever the order in which they were parsed
+        for (const auto& job : include_jobs) {
+            mergeYAMLNodes(config, job.node);
+        }
+        size_t n_cached = std::count_if(include_jobs.begin(), include_jobs.end(), [](const YamlIncludeJob& job) { return job.cached; });
+        printToMessageWindow("Configuration includes: " + to_string(include_jobs.size()) + " files, " + to_string(n_cached) + " already parsed");
+    }
+    config.remove("includes");
+
+    normalized_config = normalizeYAML(config);
+    config_hash = hashBytes(normalized_config.data(), normalized_config.size());
+
+    std::vector<std::string> config_warnings;
+    std::string config_error;
+    bool compiled = export_config.compile(config, config_warnings, config_error);
+    for (const auto& w : config_warnings) {
+        printToMessageWindow(w, c2uLogLevel::WARN);
+    }
+    if (!compiled) {
+        printToMessageWindow("Configuration file " + filename + " is malformed: " + config_error, c2uLogLevel::WARN);
         return false;
     }
 
-    printToMessageWindow("Configuration file " + filename + " was loaded successfully");
+    char hash_str[17];
+    std::snprintf(hash_str, sizeof(hash_str), "%016llx", static_cast<unsigned long long>(config_hash));
+    printToMessageWindow("Configuration file " + filename + " was loaded successfully, hash " + std::string(hash_str));
 
     return true;
 }
 
+bool Creo2Urdf::writeMergedConfig()
+{
+    std::ofstream merged_config_file(m_output_path + "\\" + merged_config_output_file, std::ios::out | std::ios::binary);
+    if (!merged_config_file.is_open()) {
+        return false;
+    }
+    merged_config_file << normalized_config;
+    return merged_config_file.good();
+}
+
 std::string Creo2Urdf::getRenameElementFromConfig(const std::string& elem_name)
 {
-    if (config["rename"][elem_name].IsDefined())
+    bool renamed{ false };
+    std::string new_name;
+    std::tie(renamed, new_name) = export_config.rename(elem_name);
+    if (renamed)
     {
-        std::string new_name = config["rename"][elem_name].Scalar();
         return new_name;
     }
     else
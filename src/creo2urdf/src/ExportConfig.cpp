@@ -0,0 +1,195 @@
+/**
+ * @file ExportConfig.cpp
+ * @brief Contains definitions for the ExportConfig class.
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/ExportConfig.h>
+
+#include <algorithm>
+#include <sstream>
+
+bool ExportConfig::compile(const YAML::Node& config, std::vector<std::string>& warnings, std::string& error)
+{
+    clear();
+    try {
+        if (config["rename"].IsDefined()) {
+            if (!config["rename"].IsMap()) {
+                error = "rename is not a map";
+                return false;
+            }
+            for (const auto& r : config["rename"]) {
+                rename_map[r.first.Scalar()] = r.second.Scalar();
+            }
+            for (const auto& r : config["rename"]) {
+                auto inserted = reverse_rename_map.emplace(r.second.Scalar(), r.first.Scalar());
+                if (!inserted.second && inserted.first->second != r.first.Scalar()) {
+                    warnings.push_back("Both " + inserted.first->second + " and " + r.first.Scalar() + " are renamed to " + r.second.Scalar());
+                }
+            }
+        }
+
+        if (config["renamePatterns"].IsDefined()) {
+            if (!config["renamePatterns"].IsSequence()) {
+                error = "renamePatterns is not a sequence";
+                return false;
+            }
+            for (const auto& rp : config["renamePatterns"]) {
+                if (!rp["pattern"].IsDefined() || !rp["replacement"].IsDefined()) {
+                    error = "renamePatterns elements need a pattern and a replacement";
+                    return false;
+                }
+                RenameRule rule;
+                rule.pattern = rp["pattern"].Scalar();
+                rule.replacement = rp["replacement"].Scalar();
+                try {
+                    rule.regex = std::regex(rule.pattern, std::regex::ECMAScript | std::regex::optimize);
+                }
+                catch (const std::regex_error& e) {
+                    error = "The rename pattern " + rule.pattern + " is not a valid regular expression: " + e.what();
+                    return false;
+                }
+                rename_rules.push_back(std::move(rule));
+            }
+        }
+
+        if (config["linkFrames"].IsDefined()) {
+            for (const auto& lf : config["linkFrames"]) {
+                // As when the sequence was walked for every part, the last element listing a link wins
+                auto link_name = lf["linkName"].Scalar();
+                auto inserted = link_frame_map.emplace(link_name, lf["frameName"].Scalar());
+                if (!inserted.second) {
+                    warnings.push_back("The link " + link_name + " is listed more than once in linkFrames, " + lf["frameName"].Scalar() + " will be used");
+                    inserted.first->second = lf["frameName"].Scalar();
+                }
+            }
+        }
+
+        const auto& rra = config["reverseRotationAxis"];
+        if (rra.IsDefined()) {
+            if (rra.IsSequence()) {
+                for (const auto& joint : rra) {
+                    reversed_rotation_axes.insert(joint.Scalar());
+                }
+            }
+            else {
+                // A single string listing the joints separated by spaces or commas
+                std::string joints = rra.Scalar();
+                std::replace(joints.begin(), joints.end(), ',', ' ');
+                std::istringstream joint_stream(joints);
+                std::string joint;
+                while (joint_stream >> joint) {
+                    reversed_rotation_axes.insert(joint);
+                }
+            }
+        }
+
+        if (config["assignedMasses"].IsDefined()) {
+            for (const auto& am : config["assignedMasses"]) {
+                assigned_mass_map[am.first.Scalar()] = am.second.as<double>();
+            }
+        }
+
+        if (config["assignedColors"].IsDefined()) {
+            for (const auto& ac : config["assignedColors"]) {
+                if (!ac.second.IsSequence() || ac.second.size() > 4) {
+                    error = "The color assigned to " + ac.first.Scalar() + " is not a sequence of at most 4 elements";
+                    return false;
+                }
+                std::array<double, 4> color{ 0.0, 0.0, 0.0, 0.0 };
+                for (size_t i = 0; i < ac.second.size(); i++) {
+                    color[i] = ac.second[i].as<double>();
+                }
+                assigned_color_map[ac.first.Scalar()] = color;
+            }
+        }
+    }
+    catch (const YAML::Exception& e) {
+        error = e.msg;
+        return false;
+    }
+    return true;
+}
+
+void ExportConfig::clear()
+{
+    rename_map.clear();
+    rename_rules.clear();
+    rename_cache.clear();
+    reverse_rename_map.clear();
+    link_frame_map.clear();
+    reversed_rotation_axes.clear();
+    assigned_mass_map.clear();
+    assigned_color_map.clear();
+}
+
+std::pair<bool, std::string> ExportConfig::rename(const std::string& cad_name) const
+{
+    auto it = rename_map.find(cad_name);
+    if (it != rename_map.end()) {
+        return std::make_pair(true, it->second);
+    }
+    if (rename_rules.empty()) {
+        return std::make_pair(false, cad_name);
+    }
+
+    auto cached = rename_cache.find(cad_name);
+    if (cached != rename_cache.end()) {
+        return cached->second;
+    }
+    std::pair<bool, std::string> renamed{ false, cad_name };
+    for (const auto& rule : rename_rules) {
+        std::smatch match;
+        if (std::regex_match(cad_name, match, rule.regex)) {
+            renamed = std::make_pair(true, match.format(rule.replacement));
+            reverse_rename_map.emplace(renamed.second, cad_name);
+            break;
+        }
+    }
+    rename_cache.emplace(cad_name, renamed);
+    return renamed;
+}
+
+std::pair<bool, std::string> ExportConfig::reverseRename(const std::string& urdf_name) const
+{
+    auto it = reverse_rename_map.find(urdf_name);
+    if (it == reverse_rename_map.end()) {
+        return std::make_pair(false, std::string(""));
+    }
+    return std::make_pair(true, it->second);
+}
+
+std::pair<bool, std::string> ExportConfig::linkFrame(const std::string& urdf_link_name) const
+{
+    auto it = link_frame_map.find(urdf_link_name);
+    if (it == link_frame_map.end()) {
+        return std::make_pair(false, std::string(""));
+    }
+    return std::make_pair(true, it->second);
+}
+
+bool ExportConfig::isRotationAxisReversed(const std::string& joint_name) const
+{
+    return reversed_rotation_axes.find(joint_name) != reversed_rotation_axes.end();
+}
+
+std::pair<bool, double> ExportConfig::assignedMass(const std::string& link_name) const
+{
+    auto it = assigned_mass_map.find(link_name);
+    if (it == assigned_mass_map.end()) {
+        return std::make_pair(false, 0.0);
+    }
+    return std::make_pair(true, it->second);
+}
+
+std::pair<bool, std::array<double, 4>> ExportConfig::assignedColor(const std::string& link_name) const
+{
+    auto it = assigned_color_map.find(link_name);
+    if (it == assigned_color_map.end()) {
+        return std::make_pair(false, std::array<double, 4>{ 0.0, 0.0, 0.0, 0.0 });
+    }
+    return std::make_pair(true, it->second);
+}
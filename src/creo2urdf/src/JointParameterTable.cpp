@@ -0,0 +1,124 @@
+/**
+ * @file JointParameterTable.cpp
+ * @brief Contains definitions for the JointParameterTable class.
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/JointParameterTable.h>
+
+#include <rapidcsv.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+namespace {
+
+/**
+ * @brief Member of JointParameters storing each column of the CSV.
+ */
+const std::vector<std::pair<std::string, double JointParameters::*>> joint_parameter_columns{
+    { "lower_limit", &JointParameters::lower_limit },
+    { "upper_limit", &JointParameters::upper_limit },
+    { "velocity_limit", &JointParameters::velocity_limit },
+    { "effort_limit", &JointParameters::effort_limit },
+    { "damping", &JointParameters::damping },
+    { "friction", &JointParameters::friction } };
+
+std::string trim(const std::string& text)
+{
+    auto first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        return "";
+    }
+    auto last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+}
+
+} // namespace
+
+bool JointParameterTable::load(const std::string& path, std::vector<std::string>& problems, std::vector<std::string>& warnings)
+{
+    clear();
+    size_t n_problems = problems.size();
+    try {
+        rapidcsv::Document csv(path, rapidcsv::LabelParams(0, 0));
+
+        // Member of JointParameters of each column of the file, nullptr for the unknown ones
+        std::vector<double JointParameters::*> column_members;
+        std::vector<std::string> file_column_names;
+        for (const auto& name : csv.GetColumnNames()) {
+            auto column_name = trim(name);
+            file_column_names.push_back(column_name);
+            auto it = std::find_if(joint_parameter_columns.begin(), joint_parameter_columns.end(),
+                [&column_name](const std::pair<std::string, double JointParameters::*>& c) { return c.first == column_name; });
+            if (it == joint_parameter_columns.end()) {
+                warnings.push_back("The CSV column " + column_name + " is not a known joint parameter, it is ignored");
+                column_members.push_back(nullptr);
+                continue;
+            }
+            column_names.push_back(column_name);
+            column_members.push_back(it->second);
+        }
+
+        auto row_names = csv.GetRowNames();
+        rows.reserve(row_names.size());
+        joint_names.reserve(row_names.size());
+        for (size_t r = 0; r < row_names.size(); r++) {
+            auto joint_name = trim(row_names[r]);
+            if (!row_index_map.emplace(joint_name, rows.size()).second) {
+                problems.push_back("The joint " + joint_name + " has more than one row in the CSV, the first one is used");
+                continue;
+            }
+            JointParameters parameters;
+            for (size_t c = 0; c < column_members.size(); c++) {
+                if (column_members[c] == nullptr) {
+                    continue;
+                }
+                auto cell = trim(csv.GetCell<std::string>(c, r));
+                if (cell.empty()) {
+                    continue;
+                }
+                char* end = nullptr;
+                double value = std::strtod(cell.c_str(), &end);
+                if (end != cell.c_str() + cell.size()) {
+                    problems.push_back("The " + file_column_names[c] + " of the joint " + joint_name + " in the CSV is not a number: " + cell);
+                    continue;
+                }
+                parameters.*column_members[c] = value;
+            }
+            rows.push_back(parameters);
+            joint_names.push_back(joint_name);
+        }
+    }
+    catch (const std::exception& e) {
+        problems.push_back("Unable to read the CSV " + path + ": " + e.what());
+        return false;
+    }
+    return problems.size() == n_problems;
+}
+
+void JointParameterTable::clear()
+{
+    rows.clear();
+    joint_names.clear();
+    row_index_map.clear();
+    column_names.clear();
+}
+
+const JointParameters* JointParameterTable::find(const std::string& joint_name) const
+{
+    auto it = row_index_map.find(joint_name);
+    if (it == row_index_map.end()) {
+        return nullptr;
+    }
+    return &rows[it->second];
+}
+
+bool JointParameterTable::hasColumn(const std::string& column_name) const
+{
+    return std::find(column_names.begin(), column_names.end(), column_name) != column_names.end();
+}
@@ -0,0 +1,215 @@
+/**
+ * @file KinematicGraph.cpp
+ * @brief Contains definitions for the NameInterner and KinematicGraph classes.
+ * @copyright (C) 2006-2024 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <creo2urdf/KinematicGraph.h>
+
+#include <algorithm>
+
+NameId NameInterner::intern(const std::string& name)
+{
+    auto it = id_map.find(&name);
+    if (it != id_map.end()) {
+        return it->second;
+    }
+    NameId id = static_cast<NameId>(names.size());
+    names.push_back(name);
+    id_map.emplace(&names.back(), id);
+    return id;
+}
+
+NameId NameInterner::find(const std::string& name) const
+{
+    auto it = id_map.find(&name);
+    return it == id_map.end() ? invalidNameId : it->second;
+}
+
+void NameInterner::clear()
+{
+    id_map.clear();
+    names.clear();
+}
+
+void KinematicGraph::build(const std::map<std::string, LinkInfo>& link_info_map,
+                           const std::map<std::string, JointInfo>& joint_info_map,
+                           const std::map<std::string, ExportedFrameInfo>& exported_frame_info_map,
+                           const ExportConfig& export_config)
+{
+    clear();
+    auto urdf_name = [&export_config](const std::string& cad_name) {
+        return export_config.rename(cad_name).second;
+    };
+
+    graph_links.reserve(link_info_map.size());
+    for (const auto& l : link_info_map) {
+        GraphLink link;
+        link.cad_name = interner.intern(l.first);
+        link.urdf_name = interner.intern(l.second.name.empty() ? urdf_name(l.first) : l.second.name);
+        link.info = &l.second;
+        GraphIndex index = static_cast<GraphIndex>(graph_links.size());
+        setIndex(link_by_cad_name, link.cad_name, index);
+        setIndex(link_by_urdf_name, link.urdf_name, index);
+        graph_links.push_back(link);
+    }
+
+    graph_joints.reserve(joint_info_map.size());
+    for (const auto& j : joint_info_map) {
+        // This handles the case of a "cut" assembly, where we have an axis but we miss the child link.
+        GraphIndex parent_link = findLink(j.second.parent_link_name);
+        GraphIndex child_link = j.second.child_link_name.empty() ? invalidGraphIndex : findLink(j.second.child_link_name);
+        if (parent_link == invalidGraphIndex || child_link == invalidGraphIndex) {
+            continue;
+        }
+        GraphJoint joint;
+        joint.cad_name = interner.intern(j.first);
+        joint.urdf_name = interner.intern(urdf_name(j.first));
+        joint.datum_name = interner.intern(j.second.datum_name);
+        joint.parent_link = parent_link;
+        joint.child_link = child_link;
+        joint.info = &j.second;
+        GraphIndex index = static_cast<GraphIndex>(graph_joints.size());
+        setIndex(joint_by_cad_name, joint.cad_name, index);
+        setIndex(joint_by_urdf_name, joint.urdf_name, index);
+        setIndex(joint_by_datum_name, joint.datum_name, index);
+        if (graph_links[child_link].parent_joint == invalidGraphIndex) {
+            graph_links[child_link].parent_joint = index;
+        }
+        graph_joints.push_back(joint);
+    }
+
+    // Child joints grouped by parent link, in the order of the joints
+    child_joint_offsets.assign(graph_links.size() + 1, 0);
+    for (const auto& joint : graph_joints) {
+        child_joint_offsets[joint.parent_link + 1]++;
+    }
+    for (size_t l = 0; l < graph_links.size(); l++) {
+        child_joint_offsets[l + 1] += child_joint_offsets[l];
+    }
+    child_joints.resize(graph_joints.size());
+    std::vector<GraphIndex> next(child_joint_offsets.begin(), child_joint_offsets.end() - 1);
+    for (GraphIndex j = 0; j < graph_joints.size(); j++) {
+        child_joints[next[graph_joints[j].parent_link]++] = j;
+    }
+
+    graph_frames.reserve(exported_frame_info_map.size());
+    for (const auto& f : exported_frame_info_map) {
+        GraphFrame frame;
+        frame.name = interner.intern(f.first);
+        frame.link = findLinkByUrdfName(f.second.frameReferenceLink);
+        frame.info = &f.second;
+        setIndex(frame_by_name, frame.name, static_cast<GraphIndex>(graph_frames.size()));
+        graph_frames.push_back(frame);
+    }
+}
+
+void KinematicGraph::clear()
+{
+    interner.clear();
+    graph_links.clear();
+    graph_joints.clear();
+    graph_frames.clear();
+    child_joint_offsets.clear();
+    child_joints.clear();
+    link_by_cad_name.clear();
+    link_by_urdf_name.clear();
+    joint_by_cad_name.clear();
+    joint_by_urdf_name.clear();
+    joint_by_datum_name.clear();
+    frame_by_name.clear();
+}
+
+GraphIndexRange KinematicGraph::childJoints(GraphIndex link) const
+{
+    GraphIndexRange range;
+    if (link >= graph_links.size()) {
+        return range;
+    }
+    range.first = child_joints.data() + child_joint_offsets[link];
+    range.last = child_joints.data() + child_joint_offsets[link + 1];
+    return range;
+}
+
+void KinematicGraph::topologicalOrder(const std::string& root_urdf_name, std::vector<GraphIndex>& link_order, std::vector<GraphIndex>& joint_order) const
+{
+    link_order.clear();
+    joint_order.clear();
+    link_order.reserve(graph_links.size());
+    joint_order.reserve(graph_joints.size());
+
+    // Child joints of each link sorted by URDF name, so that the order does not depend on the names in Creo
+    std::vector<GraphIndex> sorted_child_joints(child_joints);
+    for (GraphIndex l = 0; l < graph_links.size(); l++) {
+        std::stable_sort(sorted_child_joints.begin() + child_joint_offsets[l], sorted_child_joints.begin() + child_joint_offsets[l + 1],
+            [this](GraphIndex a, GraphIndex b) { return name(graph_joints[a].urdf_name) < name(graph_joints[b].urdf_name); });
+    }
+
+    // Candidate roots: the configured one, then the links without a parent joint, then all the others
+    std::vector<GraphIndex> roots(graph_links.size());
+    for (GraphIndex l = 0; l < graph_links.size(); l++) {
+        roots[l] = l;
+    }
+    std::stable_sort(roots.begin(), roots.end(), [this](GraphIndex a, GraphIndex b) {
+        bool a_is_root = graph_links[a].parent_joint == invalidGraphIndex;
+        bool b_is_root = graph_links[b].parent_joint == invalidGraphIndex;
+        if (a_is_root != b_is_root) {
+            return a_is_root;
+        }
+        return name(graph_links[a].urdf_name) < name(graph_links[b].urdf_name);
+    });
+    GraphIndex root = findLinkByUrdfName(root_urdf_name);
+    if (root != invalidGraphIndex) {
+        roots.erase(std::find(roots.begin(), roots.end(), root));
+        roots.insert(roots.begin(), root);
+    }
+
+    std::vector<bool> visited(graph_links.size(), false);
+    std::vector<std::pair<GraphIndex, GraphIndex>> stack; // Link and position of the next child joint to visit
+    for (GraphIndex r : roots) {
+        if (visited[r]) {
+            continue;
+        }
+        visited[r] = true;
+        link_order.push_back(r);
+        stack.emplace_back(r, child_joint_offsets[r]);
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            if (top.second == child_joint_offsets[top.first + 1]) {
+                stack.pop_back();
+                continue;
+            }
+            GraphIndex j = sorted_child_joints[top.second++];
+            joint_order.push_back(j);
+            GraphIndex child = graph_joints[j].child_link;
+            if (!visited[child]) {
+                visited[child] = true;
+                link_order.push_back(child);
+                stack.emplace_back(child, child_joint_offsets[child]);
+            }
+        }
+    }
+}
+
+GraphIndex KinematicGraph::lookup(const std::vector<GraphIndex>& index, const std::string& name) const
+{
+    NameId id = interner.find(name);
+    if (id == invalidNameId || id >= index.size()) {
+        return invalidGraphIndex;
+    }
+    return index[id];
+}
+
+void KinematicGraph::setIndex(std::vector<GraphIndex>& index, NameId id, GraphIndex value)
+{
+    if (index.size() <= id) {
+        index.resize(id + 1, invalidGraphIndex);
+    }
+    // As when the maps were searched in order, the first element with a name wins
+    if (index[id] == invalidGraphIndex) {
+        index[id] = value;
+    }
+}
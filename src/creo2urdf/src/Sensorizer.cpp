@@ -9,9 +9,110 @@
 
 #include <creo2urdf/Sensorizer.h>
 
+#include <creo2urdf/mesh/Parallel.h>
+
+#include <rapidcsv.h>
+
+#include <algorithm>
+#include <exception>
+#include <regex>
+
+namespace {
+
+/**
+ * @brief Replaces {link}, {frame} and {index} in a template of a sensor array, the other text is copied as is.
+ */
+std::string expandSensorTemplate(const std::string& text, const std::string& link, const std::string& frame, size_t index)
+{
+    std::string expanded;
+    expanded.reserve(text.size() + 16);
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t open = text.find('{', pos);
+        if (open == std::string::npos) {
+            break;
+        }
+        size_t close = text.find('}', open);
+        if (close == std::string::npos) {
+            break;
+        }
+        expanded.append(text, pos, open - pos);
+        auto key = text.substr(open + 1, close - open - 1);
+        if (key == "link") {
+            expanded += link;
+        }
+        else if (key == "frame") {
+            expanded += frame;
+        }
+        else if (key == "index") {
+            expanded += std::to_string(index);
+        }
+        else {
+            expanded.append(text, open, close - open + 1);
+        }
+        pos = close + 1;
+    }
+    expanded.append(text, pos, std::string::npos);
+    return expanded;
+}
+
+/**
+ * @brief Number of sensors whose blobs are written by the same writer, in parallel with the other blocks.
+ */
+constexpr size_t xml_blob_block_size = 64;
+
+/**
+ * @brief Streaming writer of the XML blobs of the sensors. The blobs are written one after the other in the same growing buffer,
+ * which is emptied when each blob is taken, without indentation since the exporter formats the URDF.
+ * Each thread uses its own writer.
+ */
+class XMLBlobWriter {
+public:
+    XMLBlobWriter()
+    {
+        buffer = xmlBufferCreate();
+        writer = xmlNewTextWriterMemory(buffer, 0);
+    }
+
+    ~XMLBlobWriter()
+    {
+        xmlFreeTextWriter(writer);
+        xmlBufferFree(buffer);
+    }
+
+    XMLBlobWriter(const XMLBlobWriter&) = delete;
+    XMLBlobWriter& operator=(const XMLBlobWriter&) = delete;
+
+    void startElement(const char* name) { xmlTextWriterStartElement(writer, BAD_CAST name); }
+    void endElement() { xmlTextWriterEndElement(writer); }
+    void attribute(const char* name, const std::string& value) { xmlTextWriterWriteAttribute(writer, BAD_CAST name, BAD_CAST value.c_str()); }
+    void element(const char* name, const std::string& text) { xmlTextWriterWriteElement(writer, BAD_CAST name, BAD_CAST text.c_str()); }
+
+    /**
+     * @brief Writes XML already serialized, e.g. a parsed blob of the user, as child of the open element.
+     */
+    void raw(const std::string& xml) { xmlTextWriterWriteRawLen(writer, BAD_CAST xml.c_str(), static_cast<int>(xml.size())); }
+
+    /**
+     * @brief Ends the blob being written and returns it.
+     */
+    std::string take()
+    {
+        xmlTextWriterFlush(writer);
+        std::string blob(reinterpret_cast<const char*>(xmlBufferContent(buffer)), static_cast<size_t>(xmlBufferLength(buffer)));
+        xmlBufferEmpty(buffer);
+        return blob;
+    }
+
+private:
+    xmlBufferPtr buffer{ nullptr };
+    xmlTextWriterPtr writer{ nullptr };
+};
+
+} // namespace
+
 void Sensorizer::readSensorsFromConfig(const YAML::Node & config)
 {
-    m_config = config;
     if (!config["sensors"].IsDefined())
         return;
 
@@ -66,6 +167,75 @@ void Sensorizer::readSensorsFromConfig(const YAML::Node & config)
     }
 }
 
+bool Sensorizer::readSensorArraysFromConfig(const YAML::Node& config, const std::string& config_folder)
+{
+    if (!config["sensorArrays"].IsDefined())
+        return true;
+
+    bool ok = true;
+    for (const auto& sa : config["sensorArrays"]) {
+        try
+        {
+            SensorArrayInfo sensor_array;
+            sensor_array.linkName = sa["linkName"].Scalar();
+            sensor_array.type = stringToEnum<SensorType>(sensor_type_map, sa["sensorType"].Scalar());
+            if (sa["frameNamePattern"].IsDefined() == sa["posesFile"].IsDefined()) {
+                printToMessageWindow("Sensorizer: the sensor array of " + sensor_array.linkName + " needs either a frameNamePattern or a posesFile", c2uLogLevel::WARN);
+                ok = false;
+                continue;
+            }
+            if (sa["frameNamePattern"].IsDefined()) {
+                sensor_array.frameNamePattern = sa["frameNamePattern"].Scalar();
+                std::regex check(sensor_array.frameNamePattern);
+            }
+            if (sa["sensorName"].IsDefined()) {
+                sensor_array.sensorName = sa["sensorName"].Scalar();
+            }
+            if (sa["exportedFrameName"].IsDefined()) {
+                sensor_array.exportedFrameName = sa["exportedFrameName"].Scalar();
+            }
+            if (sa["exportFrameInURDF"].IsDefined()) {
+                sensor_array.exportFrameInURDF = sa["exportFrameInURDF"].as<bool>();
+            }
+            if (sa["updateRate"].IsDefined()) {
+                sensor_array.updateRate = sa["updateRate"].as<double>();
+            }
+            if (sa["sensorBlobs"].IsDefined()) {
+                sensor_array.xmlBlobs = sa["sensorBlobs"].as<std::vector<std::string>>();
+            }
+
+            if (sa["posesFile"].IsDefined()) {
+                // One row per sensor, labelled with its name, with the pose in m and rad with respect to the link frame
+                sensor_array.posesFile = config_folder + sa["posesFile"].Scalar();
+                rapidcsv::Document csv(sensor_array.posesFile, rapidcsv::LabelParams(0, 0));
+                std::array<std::vector<double>, 6> pose_columns;
+                const std::array<std::string, 6> pose_column_names{ "x", "y", "z", "roll", "pitch", "yaw" };
+                for (size_t c = 0; c < pose_columns.size(); c++) {
+                    pose_columns[c] = csv.GetColumn<double>(pose_column_names[c]);
+                }
+                sensor_array.poseNames = csv.GetRowNames();
+                sensor_array.poses.reserve(sensor_array.poseNames.size());
+                for (size_t r = 0; r < sensor_array.poseNames.size(); r++) {
+                    sensor_array.poses.emplace_back(iDynTree::Rotation::RPY(pose_columns[3][r], pose_columns[4][r], pose_columns[5][r]),
+                                                    iDynTree::Position(pose_columns[0][r], pose_columns[1][r], pose_columns[2][r]));
+                }
+            }
+            sensor_arrays.push_back(std::move(sensor_array));
+        }
+        catch (YAML::Exception& e)
+        {
+            printToMessageWindow("Sensorizer: invalid sensor array, " + e.msg, c2uLogLevel::WARN);
+            ok = false;
+        }
+        catch (const std::exception& e)
+        {
+            printToMessageWindow("Sensorizer: invalid sensor array of " + sa["linkName"].Scalar() + ", " + e.what(), c2uLogLevel::WARN);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
 void Sensorizer::readFTSensorsFromConfig(const YAML::Node& config)
 {
     if (config["forceTorqueSensors"].IsDefined())
@@ -115,256 +285,378 @@ void Sensorizer::readFTSensorsFromConfig(const YAML::Node& config)
 
 }
 
-void Sensorizer::assignTransformToFTSensor(const std::map<std::string, ExportedFrameInfo>& exported_frame_info_map,const std::map<std::string, LinkInfo>& link_info_map, const std::map<std::string, JointInfo>& joint_info_map, const std::array<double, 3> scale)
+void Sensorizer::assignTransformToFTSensor(const KinematicGraph& kinematic_graph, const std::array<double, 3> scale)
 {
     // Iterate over all sensors
     for (auto& f : ft_sensors)
     {   
-        if (exported_frame_info_map.find(f.second.frameName) != exported_frame_info_map.end())
+        GraphIndex frame_index = kinematic_graph.findFrame(f.second.frameName);
+        if (frame_index != invalidGraphIndex)
         {
             // If the frame used is in the exported frames map, use the transform from there
-            f.second.child_link_H_sensor = exported_frame_info_map.at(f.second.frameName).linkFrame_H_additionalFrame * exported_frame_info_map.at(f.second.frameName).additionalTransformation;
+            const auto& frame_info = *kinematic_graph.frames()[frame_index].info;
+            f.second.child_link_H_sensor = frame_info.linkFrame_H_additionalFrame * frame_info.additionalTransformation;
         }
         else {
 
-            auto joint_it = std::find_if(joint_info_map.begin(), joint_info_map.end(),
-                [f](const std::pair<std::string, JointInfo>& pair) {
-                    return pair.second.datum_name == f.second.frameName;
-                });
-
-            if (joint_it == joint_info_map.end())
+            GraphIndex joint_index = kinematic_graph.findJointByDatum(f.second.frameName);
+            if (joint_index == invalidGraphIndex)
             {
                 continue;
             }
 
-            JointInfo j_info = joint_it->second;
-
-            LinkInfo parent_l_info = link_info_map.at(j_info.parent_link_name);
-            LinkInfo child_l_info = link_info_map.at(j_info.child_link_name);
+            const auto& joint = kinematic_graph.joints()[joint_index];
+            const LinkInfo& parent_l_info = *kinematic_graph.links()[joint.parent_link].info;
+            const LinkInfo& child_l_info = *kinematic_graph.links()[joint.child_link].info;
 
             auto parent_csys_H_sensor = (getTransformFromPart(parent_l_info.modelhdl, f.second.frameName, scale)).second;
-            auto parent_csys_H_parent_link = (getTransformFromPart(parent_l_info.modelhdl, parent_l_info.link_frame_name, scale)).second;
             // This transform is used for exporting the ft frame
-            f.second.parent_link_H_sensor = parent_csys_H_parent_link.inverse() * parent_csys_H_sensor;
+            f.second.parent_link_H_sensor = parent_l_info.linkFrame_H_csysPart * parent_csys_H_sensor;
 
             auto child_csys_H_sensor = (getTransformFromPart(child_l_info.modelhdl, f.second.frameName, scale)).second;
-            auto child_csys_H_child_link = (getTransformFromPart(child_l_info.modelhdl, child_l_info.link_frame_name, scale)).second;
             // This transform is used for defining the pose of the ft sensor
-            f.second.child_link_H_sensor = child_csys_H_child_link.inverse() * child_csys_H_sensor;
+            f.second.child_link_H_sensor = child_l_info.linkFrame_H_csysPart * child_csys_H_sensor;
         }
     }
 }
 
-std::vector<std::string> Sensorizer::buildFTXMLBlobs()
+bool parseXMLFragment(const std::string& fragment, std::string& xml, std::string& error)
 {
-    std::vector<std::string> ft_xml_blobs;
-
-    for (const auto& ft : ft_sensors)
+    xml.clear();
+    error.clear();
+    if (fragment.find_first_not_of(" \t\r\n") == std::string::npos)
     {
-        xmlKeepBlanksDefault(0);
-        xmlDocPtr doc = NULL;
-        xmlNodePtr root_node = NULL, node = NULL;
-        doc = xmlNewDoc(NULL);
-        root_node = xmlNewNode(NULL, BAD_CAST "gazebo");
-
-        xmlDocSetRootElement(doc, root_node);
-
-        xmlNewProp(root_node, BAD_CAST "reference", BAD_CAST ft.first.c_str());
-
-        node = xmlNewChild(root_node, NULL, BAD_CAST "sensor", NULL);
-        xmlNewProp(node, BAD_CAST "name", BAD_CAST ft.second.sensorName.c_str());
-        xmlNewProp(node, BAD_CAST "type", BAD_CAST "force_torque");
-
-        auto node1 = xmlNewChild(node, NULL, BAD_CAST "always_on", BAD_CAST "1");
-        node1 = xmlNewChild(node, NULL, BAD_CAST "update_rate", BAD_CAST "100");
-        node1 = xmlNewChild(node, NULL, BAD_CAST "force_torque", NULL);
-
-        auto node2 = xmlNewChild(node1, NULL, BAD_CAST "frame", BAD_CAST ft.second.frame.c_str());
-
-        auto& trf = ft.second.child_link_H_sensor;
-
-        if (ft.second.directionChildToParent)
+        return true;
+    }
+    xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
+    xmlNodePtr context = xmlNewNode(NULL, BAD_CAST "fragment");
+    xmlDocSetRootElement(doc, context);
+
+    xmlResetLastError();
+    xmlNodePtr nodes = nullptr;
+    bool ok = xmlParseInNodeContext(context, fragment.c_str(), static_cast<int>(fragment.size()),
+                                    XML_PARSE_NOBLANKS | XML_PARSE_NOERROR | XML_PARSE_NOWARNING, &nodes) == XML_ERR_OK;
+    if (ok)
+    {
+        xmlBufferPtr buffer = xmlBufferCreate();
+        for (xmlNodePtr node = nodes; node != nullptr; node = node->next)
         {
-            node2 = xmlNewChild(node1, NULL, BAD_CAST "measure_direction", BAD_CAST "child_to_parent");
+            xmlNodeDump(buffer, doc, node, 0, 0);
         }
-        else
+        xml.assign(reinterpret_cast<const char*>(xmlBufferContent(buffer)), static_cast<size_t>(xmlBufferLength(buffer)));
+        xmlBufferFree(buffer);
+    }
+    else
+    {
+        auto last_error = xmlGetLastError();
+        error = last_error && last_error->message ? last_error->message : "not well formed";
+        while (!error.empty() && (error.back() == '\n' || error.back() == ' '))
         {
-            node2 = xmlNewChild(node1, NULL, BAD_CAST "measure_direction", BAD_CAST "parent_to_child");
+            error.pop_back();
         }
+    }
+    xmlFreeNodeList(nodes);
+    xmlFreeDoc(doc);
+    return ok;
+}
 
-        std::string pose_xyz_rpy = trf.getPosition().toString() + " " + trf.getRotation().asRPY().toString();
-        node1 = xmlNewChild(node, NULL, BAD_CAST "pose", BAD_CAST pose_xyz_rpy.c_str());
-
-        for (auto & blob : ft.second.xmlBlobs)
+bool Sensorizer::parseSensorXMLBlobs()
+{
+    parsed_xml_blobs.clear();
+    xmlInitParser();
+    std::vector<const std::string*> order; // Distinct blobs in the order in which they are first used, for the messages
+    auto add = [this, &order](const std::string& blob, const std::string& sensor_name) {
+        auto it = parsed_xml_blobs.find(blob);
+        if (it == parsed_xml_blobs.end())
         {
-            xmlNodePtr node_xmlblob = nullptr;
-
-            xmlParseInNodeContext(node, blob.c_str(), blob.size(), 0, &node_xmlblob);
-
-            if (node_xmlblob)
-                xmlAddChild(node, node_xmlblob);
+            it = parsed_xml_blobs.emplace(blob, ParsedXMLBlob()).first;
+            order.push_back(&it->first);
+            it->second.valid = parseXMLFragment(blob, it->second.xml, it->second.error);
         }
-
-        xmlOutputBufferPtr gazebo_doc_buffer = xmlAllocOutputBuffer(NULL);
-        xmlNodeDumpOutput(gazebo_doc_buffer, doc, root_node, 0, 1, NULL);
-        ft_xml_blobs.push_back(string((char*)xmlBufContent(gazebo_doc_buffer->buffer)));
-
-        xmlOutputBufferClose(gazebo_doc_buffer);
-
-        xmlFreeDoc(doc);
-
-        doc = xmlNewDoc(BAD_CAST "1.0");
-        root_node = xmlNewNode(NULL, BAD_CAST "sensor");
-
-        xmlDocSetRootElement(doc, root_node);
-
-        xmlNewProp(root_node, BAD_CAST "name", BAD_CAST ft.second.sensorName.c_str());
-        xmlNewProp(root_node, BAD_CAST "type", BAD_CAST "force_torque");
-        node = xmlNewChild(root_node, NULL, BAD_CAST "parent", NULL);
-        xmlNewProp(node, BAD_CAST "joint", BAD_CAST ft.first.c_str());
-
-        node = xmlNewChild(root_node, NULL, BAD_CAST "force_torque", NULL);
-        xmlNewChild(node, NULL, BAD_CAST "frame", BAD_CAST ft.second.frame.c_str());
-        if (ft.second.directionChildToParent)
+        auto& parsed = it->second;
+        if (!parsed.valid && (parsed.sensorNames.empty() || parsed.sensorNames.back() != sensor_name))
         {
-            xmlNewChild(node, NULL, BAD_CAST "measure_direction", BAD_CAST "child_to_parent");
+            parsed.sensorNames.push_back(sensor_name);
         }
-        else
+    };
+    for (const auto& ft : ft_sensors)
+    {
+        for (const auto& blob : ft.second.xmlBlobs)
         {
-            xmlNewChild(node, NULL, BAD_CAST "measure_direction", BAD_CAST "parent_to_child");
+            add(blob, ft.second.sensorName);
         }
-        node = xmlNewChild(root_node, NULL, BAD_CAST "origin", NULL);
-        xmlNewProp(node, BAD_CAST "rpy", BAD_CAST trf.getRotation().asRPY().toString().c_str());
-        xmlNewProp(node, BAD_CAST "xyz", BAD_CAST trf.getPosition().toString().c_str());
-
-        xmlOutputBufferPtr sensor_doc_buffer = xmlAllocOutputBuffer(NULL);
-        xmlNodeDumpOutput(sensor_doc_buffer, doc, root_node, 0, 1, NULL);
-        ft_xml_blobs.push_back(string((char*)xmlBufContent(sensor_doc_buffer->buffer)));
+    }
+    for (const auto& s : sensors)
+    {
+        for (const auto& blob : s.xmlBlobs)
+        {
+            add(blob, s.sensorName);
+        }
+    }
 
-        xmlOutputBufferClose(sensor_doc_buffer);
+    bool ok = true;
+    for (const auto* blob : order)
+    {
+        const auto& parsed = parsed_xml_blobs.at(*blob);
+        if (parsed.valid)
+        {
+            continue;
+        }
+        ok = false;
+        std::string sensor_names;
+        for (const auto& name : parsed.sensorNames)
+        {
+            sensor_names += (sensor_names.empty() ? "" : ", ") + name;
+        }
+        printToMessageWindow("Skipping sensor blob that is not well formed (" + parsed.error + "), used by " +
+                             to_string(parsed.sensorNames.size()) + " sensors: " + sensor_names + "\n" + *blob, c2uLogLevel::WARN);
+    }
+    return ok;
+}
 
-        xmlFreeDoc(doc);
+std::vector<std::string> Sensorizer::buildFTXMLBlobs()
+{
+    std::vector<const std::pair<const std::string, FTSensorInfo>*> ft_list;
+    ft_list.reserve(ft_sensors.size());
+    for (const auto& ft : ft_sensors)
+    {
+        ft_list.push_back(&ft);
     }
 
+    // Two blobs for each sensor, in the order of the sensors whatever the order in which they are written
+    std::vector<std::string> ft_xml_blobs(2 * ft_list.size());
+    xmlInitParser();
+    size_t n_blocks = (ft_list.size() + xml_blob_block_size - 1) / xml_blob_block_size;
+    parallelFor(n_blocks, [&](size_t block) {
+        XMLBlobWriter writer;
+        size_t last = std::min(ft_list.size(), (block + 1) * xml_blob_block_size);
+        for (size_t i = block * xml_blob_block_size; i < last; i++)
+        {
+            const auto& ft = *ft_list[i];
+            auto& trf = ft.second.child_link_H_sensor;
+            const char* measure_direction = ft.second.directionChildToParent ? "child_to_parent" : "parent_to_child";
+
+            writer.startElement("gazebo");
+            writer.attribute("reference", ft.first);
+            writer.startElement("sensor");
+            writer.attribute("name", ft.second.sensorName);
+            writer.attribute("type", "force_torque");
+            writer.element("always_on", "1");
+            writer.element("update_rate", "100");
+            writer.startElement("force_torque");
+            writer.element("frame", ft.second.frame);
+            writer.element("measure_direction", measure_direction);
+            writer.endElement();
+            writer.element("pose", trf.getPosition().toString() + " " + trf.getRotation().asRPY().toString());
+            for (const auto& blob : ft.second.xmlBlobs)
+            {
+                auto parsed = parsed_xml_blobs.find(blob);
+                if (parsed != parsed_xml_blobs.end() && parsed->second.valid)
+                {
+                    writer.raw(parsed->second.xml);
+                }
+            }
+            writer.endElement();
+            writer.endElement();
+            ft_xml_blobs[2 * i] = writer.take();
+
+            writer.startElement("sensor");
+            writer.attribute("name", ft.second.sensorName);
+            writer.attribute("type", "force_torque");
+            writer.startElement("parent");
+            writer.attribute("joint", ft.first);
+            writer.endElement();
+            writer.startElement("force_torque");
+            writer.element("frame", ft.second.frame);
+            writer.element("measure_direction", measure_direction);
+            writer.endElement();
+            writer.startElement("origin");
+            writer.attribute("rpy", trf.getRotation().asRPY().toString());
+            writer.attribute("xyz", trf.getPosition().toString());
+            writer.endElement();
+            writer.endElement();
+            ft_xml_blobs[2 * i + 1] = writer.take();
+        }
+    });
+
     return ft_xml_blobs;
 }
 
-void Sensorizer::assignTransformToSensors(const std::map<std::string, ExportedFrameInfo>& exported_frame_info_map, const std::map<std::string, LinkInfo>& link_info_map, const std::array<double, 3> scale)
+void Sensorizer::assignTransformToSensors(const KinematicGraph& kinematic_graph, const std::array<double, 3> scale)
 {
     for (auto& s : sensors)
     {
-        if (exported_frame_info_map.find(s.frameName) != exported_frame_info_map.end())
+        GraphIndex frame_index = kinematic_graph.findFrame(s.frameName);
+        if (frame_index != invalidGraphIndex)
         {
             // If the frame used is in the exported frames map, use the transform from there
-            s.transform = exported_frame_info_map.at(s.frameName).linkFrame_H_additionalFrame * exported_frame_info_map.at(s.frameName).additionalTransformation;
+            const auto& frame_info = *kinematic_graph.frames()[frame_index].info;
+            s.transform = frame_info.linkFrame_H_additionalFrame * frame_info.additionalTransformation;
         }
         else
         {
             // Otherwise let's try to compute the transform
-            bool ret = false;
-            iDynTree::Transform csys_H_additionalFrame{ iDynTree::Transform::Identity() };
-            iDynTree::Transform csys_H_linkFrame{ iDynTree::Transform::Identity() };
-            iDynTree::Transform linkFrame_H_additionalFrame{ iDynTree::Transform::Identity() };
-            std::string cad_link_name = "";
-            for (auto& rename : m_config["rename"])
-            {
-                if (rename.second.Scalar() == s.linkName)
-                {
-                    cad_link_name = rename.first.Scalar();
-                    break;
-                }
-            }
+            GraphIndex link_index = kinematic_graph.findLinkByUrdfName(s.linkName);
 
-            if (link_info_map.find(cad_link_name) == link_info_map.end())
+            if (link_index == invalidGraphIndex)
             {
-                printToMessageWindow("Sensorizer: link " + cad_link_name + " not found in the link info map, sensor "+ s.sensorName + " skipped.", c2uLogLevel::WARN);
+                printToMessageWindow("Sensorizer: link " + s.linkName + " not found in the link info map, sensor "+ s.sensorName + " skipped.", c2uLogLevel::WARN);
                 continue;
             }
 
-            auto link_info = link_info_map.at(cad_link_name);
-            std::tie(ret, csys_H_additionalFrame) = getTransformFromPart(link_info.modelhdl, s.frameName, scale);
-            if (!ret)
+            const LinkInfo& link_info = *kinematic_graph.links()[link_index].info;
+            const PartDatumTable* datum_table = getDatumTable(kinematic_graph, link_index, scale);
+            auto csys = datum_table ? datum_table->csys_index_map.find(s.frameName) : std::unordered_map<std::string, size_t>::const_iterator();
+            if (!datum_table || csys == datum_table->csys_index_map.end())
             {
                 printToMessageWindow("Unable to get the transform for " + s.frameName, c2uLogLevel::WARN);
                 continue;
             }
-            std::tie(ret, csys_H_linkFrame) = getTransformFromPart(link_info.modelhdl, link_info.link_frame_name, scale);
-            if (!ret)
-            {
-                printToMessageWindow("Unable to get the transform for " + link_info.link_frame_name, c2uLogLevel::WARN);
-                continue;
-            }
-            linkFrame_H_additionalFrame = csys_H_linkFrame.inverse() * csys_H_additionalFrame;
-            s.transform = linkFrame_H_additionalFrame;
+            s.transform = link_info.linkFrame_H_csysPart * getTransformFromBatch(datum_table->csysPart_H_csys, csys->second);
         }
     }
 }
 
-std::vector<std::string> Sensorizer::buildSensorsXMLBlobs()
+bool Sensorizer::expandSensorArrays(const KinematicGraph& kinematic_graph, const std::array<double, 3> scale)
 {
-    std::vector<std::string> xml_blobs;
-
-    for (const auto& s : sensors)
+    bool ok = true;
+    for (const auto& sa : sensor_arrays)
     {
-        xmlKeepBlanksDefault(0);
-        xmlDocPtr doc = NULL;
-        xmlNodePtr root_node = NULL, node = NULL;
-        doc = xmlNewDoc(BAD_CAST "1.0");
-        root_node = xmlNewNode(NULL, BAD_CAST "gazebo");
-
-        xmlDocSetRootElement(doc, root_node);
-
-        xmlNewProp(root_node, BAD_CAST "reference", BAD_CAST s.linkName.c_str());
-
-        node = xmlNewChild(root_node, NULL, BAD_CAST "sensor", NULL);
-        xmlNewProp(node, BAD_CAST "name", BAD_CAST s.sensorName.c_str());
-
-        xmlNewProp(node, BAD_CAST "type", BAD_CAST gazebo_sensor_type_map.at(s.type).c_str());
-
-        xmlNewChild(node, NULL, BAD_CAST "always_on", BAD_CAST "1");
-        xmlNewChild(node, NULL, BAD_CAST "update_rate", BAD_CAST to_string(s.updateRate).c_str());
-
-        iDynTree::Transform trf = s.transform;
-
-        string pose = trf.getPosition().toString() + " " + trf.getRotation().asRPY().toString();
-
-        xmlNewChild(node, NULL, BAD_CAST "pose", BAD_CAST pose.c_str());
-
-        for (auto & blob : s.xmlBlobs)
+        GraphIndex link_index = kinematic_graph.findLinkByUrdfName(sa.linkName);
+        if (link_index == invalidGraphIndex)
         {
-            xmlNodePtr node_xmlblob = nullptr;
-
-            xmlParseInNodeContext(node, blob.c_str(), blob.size(), 0, &node_xmlblob);
-
-            if (node_xmlblob)
-                xmlAddChild(node, node_xmlblob);
+            printToMessageWindow("Sensorizer: link " + sa.linkName + " not found in the link info map, sensor array skipped.", c2uLogLevel::WARN);
+            ok = false;
+            continue;
         }
 
-        xmlOutputBufferPtr doc_buffer = xmlAllocOutputBuffer(NULL);
-        xmlNodeDumpOutput(doc_buffer, doc, root_node, 0, 1, NULL);
-        xml_blobs.push_back(string((char*)xmlBufContent(doc_buffer->buffer)));
+        std::vector<std::string> frame_names;
+        std::vector<iDynTree::Transform> link_H_sensors;
+        if (!sa.frameNamePattern.empty())
+        {
+            const PartDatumTable* datum_table = getDatumTable(kinematic_graph, link_index, scale);
+            if (datum_table)
+            {
+                std::regex pattern(sa.frameNamePattern);
+                std::vector<std::uint32_t> csys_indexes;
+                for (size_t i = 0; i < datum_table->csys_names.size(); i++)
+                {
+                    if (std::regex_match(datum_table->csys_names[i], pattern))
+                    {
+                        csys_indexes.push_back(static_cast<std::uint32_t>(i));
+                        frame_names.push_back(datum_table->csys_names[i]);
+                    }
+                }
 
-        xmlOutputBufferClose(doc_buffer);
-        xmlFreeDoc(doc);
+                // All the frames of the array are expressed in the link frame in one pass
+                const auto& linkFrame_H_csysPart = kinematic_graph.links()[link_index].info->linkFrame_H_csysPart;
+                TransformBatch link_frame;
+                link_frame.append(iDynTree::toEigen(linkFrame_H_csysPart.getRotation()), iDynTree::toEigen(linkFrame_H_csysPart.getPosition()));
+                TransformBatch linkFrame_H_csys;
+                composeTransforms(link_frame, std::vector<std::uint32_t>(csys_indexes.size(), 0), datum_table->csysPart_H_csys, csys_indexes, linkFrame_H_csys);
+                link_H_sensors.reserve(csys_indexes.size());
+                for (size_t i = 0; i < csys_indexes.size(); i++)
+                {
+                    link_H_sensors.push_back(getTransformFromBatch(linkFrame_H_csys, i));
+                }
+            }
+        }
+        else
+        {
+            frame_names = sa.poseNames;
+            link_H_sensors = sa.poses;
+        }
 
-        doc = xmlNewDoc(BAD_CAST "1.0");
-        root_node = xmlNewNode(NULL, BAD_CAST "sensor");
-        xmlDocSetRootElement(doc, root_node);
+        if (frame_names.empty())
+        {
+            printToMessageWindow("Sensorizer: the sensor array of " + sa.linkName + " has no sensors", c2uLogLevel::WARN);
+            ok = false;
+            continue;
+        }
 
-        xmlNewProp(root_node, BAD_CAST "name", BAD_CAST s.sensorName.c_str());
-        xmlNewProp(root_node, BAD_CAST "type", BAD_CAST sensor_type_map.at(s.type).c_str());
-        node = xmlNewChild(root_node, NULL, BAD_CAST "parent", NULL);
-        xmlNewProp(node, BAD_CAST "link", BAD_CAST s.linkName.c_str());
-        node = xmlNewChild(root_node, NULL, BAD_CAST "origin", NULL);
-        xmlNewProp(node, BAD_CAST "rpy", BAD_CAST trf.getRotation().asRPY().toString().c_str());
-        xmlNewProp(node, BAD_CAST "xyz", BAD_CAST trf.getPosition().toString().c_str());
-        doc_buffer = xmlAllocOutputBuffer(NULL);
-        xmlNodeDumpOutput(doc_buffer, doc, root_node, 0, 1, NULL);
-        xml_blobs.push_back(string((char*)xmlBufContent(doc_buffer->buffer)));
+        sensors.reserve(sensors.size() + frame_names.size());
+        for (size_t i = 0; i < frame_names.size(); i++)
+        {
+            SensorInfo sensor;
+            sensor.sensorName = expandSensorTemplate(sa.sensorName, sa.linkName, frame_names[i], i);
+            sensor.frameName = frame_names[i];
+            sensor.linkName = sa.linkName;
+            sensor.exportedFrameName = sa.exportedFrameName.empty() ? sensor.sensorName : expandSensorTemplate(sa.exportedFrameName, sa.linkName, frame_names[i], i);
+            sensor.transform = link_H_sensors[i];
+            sensor.exportFrameInURDF = sa.exportFrameInURDF;
+            sensor.type = sa.type;
+            sensor.updateRate = sa.updateRate;
+            sensor.xmlBlobs.reserve(sa.xmlBlobs.size());
+            for (const auto& blob : sa.xmlBlobs)
+            {
+                sensor.xmlBlobs.push_back(expandSensorTemplate(blob, sa.linkName, frame_names[i], i));
+            }
+            sensors.push_back(std::move(sensor));
+        }
+        printToMessageWindow("Sensorizer: " + to_string(frame_names.size()) + " sensors generated on " + sa.linkName);
+    }
+    return ok;
+}
 
-        xmlOutputBufferClose(doc_buffer);
-        xmlFreeDoc(doc);
+const PartDatumTable* Sensorizer::getDatumTable(const KinematicGraph& kinematic_graph, GraphIndex link, const std::array<double, 3>& scale)
+{
+    auto it = part_datum_tables.find(link);
+    if (it == part_datum_tables.end())
+    {
+        it = part_datum_tables.emplace(link, PartDatumTable()).first;
+        getPartDatumTable(kinematic_graph.links()[link].info->modelhdl, scale, it->second);
     }
+    return it->second.csys_names.empty() ? nullptr : &it->second;
+}
+
+std::vector<std::string> Sensorizer::buildSensorsXMLBlobs()
+{
+    // Two blobs for each sensor, in the order of the sensors whatever the order in which they are written
+    std::vector<std::string> xml_blobs(2 * sensors.size());
+    xmlInitParser();
+    size_t n_blocks = (sensors.size() + xml_blob_block_size - 1) / xml_blob_block_size;
+    parallelFor(n_blocks, [&](size_t block) {
+        XMLBlobWriter writer;
+        size_t last = std::min(sensors.size(), (block + 1) * xml_blob_block_size);
+        for (size_t i = block * xml_blob_block_size; i < last; i++)
+        {
+            const auto& s = sensors[i];
+            const iDynTree::Transform& trf = s.transform;
+
+            writer.startElement("gazebo");
+            writer.attribute("reference", s.linkName);
+            writer.startElement("sensor");
+            writer.attribute("name", s.sensorName);
+            writer.attribute("type", gazebo_sensor_type_map.at(s.type));
+            writer.element("always_on", "1");
+            writer.element("update_rate", to_string(s.updateRate));
+            writer.element("pose", trf.getPosition().toString() + " " + trf.getRotation().asRPY().toString());
+            for (const auto& blob : s.xmlBlobs)
+            {
+                auto parsed = parsed_xml_blobs.find(blob);
+                if (parsed != parsed_xml_blobs.end() && parsed->second.valid)
+                {
+                    writer.raw(parsed->second.xml);
+                }
+            }
+            writer.endElement();
+            writer.endElement();
+            xml_blobs[2 * i] = writer.take();
+
+            writer.startElement("sensor");
+            writer.attribute("name", s.sensorName);
+            writer.attribute("type", sensor_type_map.at(s.type));
+            writer.startElement("parent");
+            writer.attribute("link", s.linkName);
+            writer.endElement();
+            writer.startElement("origin");
+            writer.attribute("rpy", trf.getRotation().asRPY().toString());
+            writer.attribute("xyz", trf.getPosition().toString());
+            writer.endElement();
+            writer.endElement();
+            xml_blobs[2 * i + 1] = writer.take();
+        }
+    });
 
     return xml_blobs;
-}
\ No newline at end of file
+}
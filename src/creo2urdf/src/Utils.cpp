@@ -10,6 +10,21 @@
 
 #include <creo2urdf/Utils.h>
 
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include <ProArray.h>
+#include <ProMdl.h>
+#include <ProSolid.h>
+#include <ProUtil.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <iterator>
+
 std::array<double, 3> computeUnitVectorFromAxis(pfcCurveDescriptor_ptr axis_data)
 {
     auto axis_line = pfcLineDescriptor::cast(axis_data); // cursed cast from hell
@@ -101,6 +116,157 @@ void sanitizeSTL(std::string stl)
     output.close();
 }
 
+std::pair<bool, size_t> countSTLTriangles(const std::string& stl, bool binary)
+{
+    std::ifstream input(stl, binary ? std::ios::in | std::ios::binary : std::ios::in);
+    if (!input.is_open()) {
+        return { false, 0 };
+    }
+
+    if (binary) {
+        // 80 bytes of header followed by the number of triangles as 32 bit unsigned integer
+        uint32_t n_triangles = 0;
+        input.seekg(80);
+        input.read(reinterpret_cast<char*>(&n_triangles), sizeof(n_triangles));
+        return { static_cast<bool>(input), n_triangles };
+    }
+
+    size_t n_triangles = 0;
+    std::string token;
+    while (input >> token) {
+        if (token == "facet") {
+            n_triangles++;
+        }
+    }
+    return { true, n_triangles };
+}
+
+std::pair<bool, double> getBoundingBoxDiagonal(pfcModel_ptr modelhdl, const array<double, 3>& scale)
+{
+    pfcOutline3D_ptr outline = nullptr;
+    try {
+        outline = pfcSolid::cast(modelhdl)->GetGeomOutline();
+    }
+    xcatchbegin
+    xcatchcip(defaultEx)
+    {
+        printToMessageWindow("Exception caught: Could not retrieve the outline of " + string(modelhdl->GetFullName()), c2uLogLevel::WARN);
+        return { false, 0.0 };
+    }
+    xcatchend
+
+    double diagonal = 0.0;
+    for (int i = 0; i < 3; i++) {
+        double side = (outline->get(1)->get(i) - outline->get(0)->get(i)) * scale[i];
+        diagonal += side * side;
+    }
+    return { true, std::sqrt(diagonal) };
+}
+
+int computeAdaptiveMeshQuality(double size, double chord_tolerance)
+{
+    if (size < epsilon || chord_tolerance < epsilon) {
+        return 1;
+    }
+    double relative_tolerance = chord_tolerance / size;
+    double quality = 1.0 + std::log10(coarsest_relative_chord_tolerance / relative_tolerance) * mesh_quality_steps_per_decade;
+    return static_cast<int>(std::min(10.0, std::max(1.0, std::ceil(quality))));
+}
+
+double computeChordHeight(double size, int quality)
+{
+    return size * coarsest_relative_chord_tolerance * std::pow(10.0, -(quality - 1) / mesh_quality_steps_per_decade);
+}
+
+MeshQualitySearch::MeshQualitySearch(int quality, size_t max_triangles) : max_triangles(max_triangles)
+{
+    current_quality = std::min(10, std::max(1, quality));
+    failing_quality = current_quality + 1;
+}
+
+bool MeshQualitySearch::next(size_t n_triangles)
+{
+    bool fits = n_triangles <= max_triangles;
+    if (fits) {
+        fitting_quality = current_quality;
+    }
+    else {
+        failing_quality = current_quality;
+    }
+
+    // The triangles are proportional to the inverse of the chord height, so each quality step multiplies them by 10^(1 / steps per decade).
+    // After two exports the actual growth of the part is used instead
+    double decades_per_step = 1.0 / mesh_quality_steps_per_decade;
+    if (last_triangles > 0 && n_triangles > 0 && n_triangles != last_triangles) {
+        double growth = std::log10(static_cast<double>(n_triangles) / static_cast<double>(last_triangles)) / (current_quality - last_quality);
+        if (growth > 0.0) {
+            decades_per_step = growth;
+        }
+    }
+    last_quality = current_quality;
+    last_triangles = n_triangles;
+    if (fitting_quality + 1 >= failing_quality) {
+        return false;
+    }
+
+    int estimated_quality = failing_quality - 1;
+    if (n_triangles > 0) {
+        double steps = std::log10(static_cast<double>(max_triangles) / static_cast<double>(n_triangles)) / decades_per_step;
+        estimated_quality = current_quality + static_cast<int>(std::floor(steps));
+    }
+    current_quality = std::min(failing_quality - 1, std::max(fitting_quality + 1, estimated_quality));
+    return true;
+}
+
+bool tessellatePart(pfcModel_ptr modelhdl, const std::string& csys_name, int quality, TriangleMesh& mesh)
+{
+    bool ok = false;
+    double size = 0.0;
+    iDynTree::Transform csysPart_H_csys;
+    std::tie(ok, size) = getBoundingBoxDiagonal(modelhdl, { 1.0, 1.0, 1.0 });
+    if (ok) {
+        std::tie(ok, csysPart_H_csys) = getTransformFromPart(modelhdl, csys_name, { 1.0, 1.0, 1.0 });
+    }
+    if (!ok) {
+        return false;
+    }
+
+    ProMdl mdl = nullptr;
+    ProMdlName mdl_name;
+    ProStringToWstring(mdl_name, const_cast<char*>(string(modelhdl->GetInstanceName()).c_str()));
+    if (ProMdlnameInit(mdl_name, PRO_MDLFILE_PART, &mdl) != PRO_TK_NO_ERROR) {
+        printToMessageWindow("Unable to get the handle of " + string(modelhdl->GetFullName()) + " for the tessellation", c2uLogLevel::WARN);
+        return false;
+    }
+
+    ProSurfaceTessellationData* tessellation = nullptr;
+    double angle_control = (quality - 1) / 9.0;
+    if (ProPartTessellate(static_cast<ProPart>(mdl), computeChordHeight(size, quality), angle_control, PRO_B_TRUE, &tessellation) != PRO_TK_NO_ERROR) {
+        printToMessageWindow("Unable to tessellate " + string(modelhdl->GetFullName()), c2uLogLevel::WARN);
+        return false;
+    }
+
+    // The vertices are given in the default csys of the part, while the mesh is expressed in csys_name
+    Eigen::Matrix3d csys_R_csysPart = iDynTree::toEigen(csysPart_H_csys.getRotation()).transpose();
+    Eigen::Vector3d csysPart_p_csys = iDynTree::toEigen(csysPart_H_csys.getPosition());
+    int n_surfaces = 0;
+    ProArraySizeGet(tessellation, &n_surfaces);
+    std::vector<Eigen::Vector3d> corners;
+    for (int i = 0; i < n_surfaces; i++) {
+        const auto& surface = tessellation[i];
+        for (int f = 0; f < surface.n_facets; f++) {
+            for (int k = 0; k < 3; k++) {
+                const auto& v = surface.vertices[surface.facets[f][k]];
+                corners.push_back(csys_R_csysPart * (Eigen::Vector3d(v[0], v[1], v[2]) - csysPart_p_csys));
+            }
+        }
+    }
+    ProPartTessellationFree(&tessellation);
+
+    mesh = weldTriangles(corners);
+    return !mesh.triangles.empty();
+}
+
 std::pair<bool, iDynTree::Transform> getTransformFromOwnerToLinkFrame(pfcComponentPath_ptr comp_path, pfcModel_ptr modelhdl, const std::string& link_frame_name, const array<double, 3>& scale) {
     
     iDynTree::Transform csysAsm_H_link = iDynTree::Transform::Identity();
@@ -195,7 +361,37 @@ std::pair<bool, iDynTree::Transform> getTransformFromPart(pfcModel_ptr modelhdl,
     return { false, H_child };
 }
 
-std::tuple<bool, iDynTree::Direction, iDynTree::Position> getAxisFromPart(pfcModel_ptr modelhdl, const std::string& axis_name, const string& link_frame_name, const array<double, 3>& scale) {
+bool getPartDatumTable(pfcModel_ptr modelhdl, const array<double, 3>& scale, PartDatumTable& table) {
+    table = PartDatumTable();
+    auto csys_list = modelhdl->ListItems(pfcModelItemType::pfcITEM_COORD_SYS);
+    if (csys_list->getarraysize() == 0) {
+        printToMessageWindow("There are no Coordinate Systems in the part " + string(modelhdl->GetFullName()), c2uLogLevel::WARN);
+        return false;
+    }
+
+    size_t n_csys = static_cast<size_t>(csys_list->getarraysize());
+    table.csys_names.reserve(n_csys);
+    table.csysPart_H_csys.resize(n_csys);
+    table.csys_index_map.reserve(n_csys);
+    for (size_t i = 0; i < n_csys; i++) {
+        auto csys = pfcCoordSystem::cast(csys_list->get(xint(i)));
+        auto H = fromCreo(csys->GetCoordSys(), scale);
+        table.csys_names.push_back(string(csys->GetName()));
+        table.csysPart_H_csys.set(i, iDynTree::toEigen(H.getRotation()), iDynTree::toEigen(H.getPosition()));
+        table.csys_index_map.emplace(table.csys_names.back(), i);
+    }
+    return true;
+}
+
+iDynTree::Transform getTransformFromBatch(const TransformBatch& batch, size_t i) {
+    iDynTree::Rotation rotation;
+    iDynTree::Position position;
+    iDynTree::toEigen(rotation) = batch.getRotation(i);
+    iDynTree::toEigen(position) = batch.getPosition(i);
+    return iDynTree::Transform(rotation, position);
+}
+
+std::tuple<bool, iDynTree::Direction, iDynTree::Position> getAxisFromPart(pfcModel_ptr modelhdl, const std::string& axis_name, const iDynTree::Transform& linkFrame_H_csysPart, const array<double, 3>& scale) {
 
     iDynTree::Direction axis_unit_vector;
     iDynTree::Position axis_mid_point_pos = iDynTree::Position::Zero();
@@ -233,9 +429,6 @@ std::tuple<bool, iDynTree::Direction, iDynTree::Position> getAxisFromPart(pfcMod
 
     auto axis_line = pfcLineDescriptor::cast(axis_data); // cursed cast from hell
 
-    auto& csys_H_linkFrame = getTransformFromPart(modelhdl, link_frame_name, scale).second;
-
-
     auto unit = computeUnitVectorFromAxis(axis_line);
 
     axis_unit_vector.setVal(0, unit[0]);
@@ -252,7 +445,7 @@ std::tuple<bool, iDynTree::Direction, iDynTree::Position> getAxisFromPart(pfcMod
     axis_mid_point_pos[1] = ((pend->get(1) + pstart->get(1)) / 2.0) * scale[1];
     axis_mid_point_pos[2] = ((pend->get(2) + pstart->get(2)) / 2.0) * scale[2];
 
-    axis_unit_vector = csys_H_linkFrame.inverse() * axis_unit_vector;  // We might benefit from performing this operation directly in Creo
+    axis_unit_vector = linkFrame_H_csysPart * axis_unit_vector;  // We might benefit from performing this operation directly in Creo
     axis_unit_vector.Normalize();
     return { true, axis_unit_vector, axis_mid_point_pos };
 }
@@ -269,23 +462,60 @@ std::string extractFolderPath(const std::string& filePath) {
     }
 }
 
+bool createDirectory(const std::string& path) {
+#ifdef _WIN32
+    int ret = _mkdir(path.c_str());
+#else
+    int ret = mkdir(path.c_str(), 0755);
+#endif
+    return ret == 0 || errno == EEXIST;
+}
+
+bool copyFile(const std::string& source, const std::string& destination) {
+    std::ifstream input(source, std::ios::in | std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    std::ofstream output(destination, std::ios::out | std::ios::binary);
+    if (!output.is_open()) {
+        return false;
+    }
+    output << input.rdbuf();
+    return static_cast<bool>(output);
+}
+
+std::pair<bool, std::string> readFileContent(const std::string& path) {
+    std::ifstream input(path, std::ios::in | std::ios::binary);
+    if (!input.is_open()) {
+        return { false, "" };
+    }
+    std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    return { true, content };
+}
+
+std::pair<bool, std::uint64_t> hashFile(const std::string& path) {
+    bool ok = false;
+    std::string content;
+    std::tie(ok, content) = readFileContent(path);
+    if (!ok) {
+        return { false, 0 };
+    }
+    return { true, hashBytes(content.data(), content.size()) };
+}
 
 void mergeYAMLNodes(YAML::Node& dest, const YAML::Node& src) {
     if (!src || src.IsNull()) return;
 
-    // If src is a map
-    if (src.IsMap()) {
+    // If both are maps, merge the values of each key with a single lookup in dest
+    if (src.IsMap() && dest.IsMap()) {
         for (const auto& item : src) {
-            const YAML::Node& keyNode = item.first;
-            const YAML::Node& srcValue = item.second;
-            const std::string key = keyNode.as<std::string>();
-
-            if (!dest[key]) {
-                dest[key] = srcValue;
+            const std::string& key = item.first.Scalar();
+            YAML::Node dest_value = dest[key];
+            if (!dest_value) {
+                dest[key] = item.second;
             }
             else {
-                YAML::Node& destValue = dest[key];
-                mergeYAMLNodes(destValue, srcValue);
+                mergeYAMLNodes(dest_value, item.second);
             }
         }
     }
@@ -302,3 +532,44 @@ void mergeYAMLNodes(YAML::Node& dest, const YAML::Node& src) {
         dest = src;
     }
 }
+
+namespace {
+
+void emitNormalizedYAML(YAML::Emitter& out, const YAML::Node& node) {
+    switch (node.Type()) {
+    case YAML::NodeType::Map: {
+        std::map<std::string, YAML::Node> sorted;
+        for (const auto& item : node) {
+            sorted.emplace(item.first.Scalar(), item.second);
+        }
+        out << YAML::BeginMap;
+        for (const auto& item : sorted) {
+            out << YAML::Key << item.first << YAML::Value;
+            emitNormalizedYAML(out, item.second);
+        }
+        out << YAML::EndMap;
+        break;
+    }
+    case YAML::NodeType::Sequence:
+        out << YAML::BeginSeq;
+        for (const auto& item : node) {
+            emitNormalizedYAML(out, item);
+        }
+        out << YAML::EndSeq;
+        break;
+    case YAML::NodeType::Scalar:
+        out << node.Scalar();
+        break;
+    default:
+        out << YAML::Null;
+        break;
+    }
+}
+
+} // namespace
+
+std::string normalizeYAML(const YAML::Node& node) {
+    YAML::Emitter out;
+    emitNormalizedYAML(out, node);
+    return std::string(out.c_str()) + "\n";
+}